@@ -1,8 +1,16 @@
 // Copyright 2024 oldnick85
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "./builder.h"
+#include "./export.h"
 #include "./graph_inclusive.h"
 #include "./primitives.h"
 #include "./properties/all.h"
@@ -11,6 +19,7 @@ using Node_t  = GG::Node<uint64_t>;
 using Edge_t  = GG::Edge<Node_t>;
 using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
                                    GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<true>>;
+using Builder_t = GG::ParallelBuilder<Graph_t>;
 
 void CheckNumber(uint64_t num, Graph_t& graph)
 {
@@ -61,17 +70,102 @@ void CheckNumbers(uint64_t max_num, Graph_t& graph)
     }
 }
 
-int main(__attribute__((unused)) int argc, __attribute__((unused)) char** argv)
+void CheckNumber(uint64_t num, Builder_t::Worker& worker)
 {
-    if (argc != 2)
+    if ((num < 1) or (num % 2 == 0))
+        return;
+
+    // the thread that makes a node walks on from it, the others stop at it
+    auto [node, made] = worker.FindOrMake(num);
+    while (made and (num != 1))
     {
-        printf("Program requires one argument: count of numbers. But %d is given.", argc);
-        return 1;
+        num = num * 3 + 1;
+        while (num % 2 == 0)
+            num = num / 2;
+        auto [next_node, next_made] = worker.FindOrMake(num);
+        worker.MakeEdge(node, next_node, true);
+        node = next_node;
+        made = next_made;
+    }
+}
+
+void CheckNumbers(uint64_t max_num, Graph_t& graph, unsigned threads)
+{
+    // numbers are taken in chunks, trajectories of close numbers have similar lengths
+    static constexpr uint64_t Chunk = 4096;
+    Builder_t builder(threads * 16);
+    std::atomic<uint64_t> next_chunk = 0;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&builder, &next_chunk, max_num]() {
+            auto worker = builder.MakeWorker();
+            for (uint64_t begin = next_chunk.fetch_add(Chunk); begin < max_num; begin = next_chunk.fetch_add(Chunk))
+            {
+                for (uint64_t i = begin + 1; (i < begin + Chunk) and (i < max_num); i += 2)
+                    CheckNumber(i, worker);
+            }
+        });
     }
+    for (auto& worker : workers)
+        worker.join();
+    builder.Finalize(graph);
+}
 
+int main(int argc, char** argv)
+{
+    std::string desc;
+    desc += "Usage: collatz_conjecture_graph COUNT [options]\n";
+    desc += "  -h,--help     print usage information and exit\n";
+    desc += "  -threads N    count of building threads (1 by default)\n";
+    if ((argc < 2) or (std::strcmp(argv[1], "--help") == 0) or (std::strcmp(argv[1], "-h") == 0))
+    {
+        printf("%s\n", desc.c_str());
+        return (argc < 2) ? 1 : 0;
+    }
     const uint64_t num = std::stoll(argv[1]);
+    unsigned threads   = 1;
+    int arg_i          = 2;
+    while (arg_i < argc)
+    {
+        const auto* arg = argv[arg_i];
+        if (std::strcmp(arg, "-threads") != 0)
+        {
+            printf("Unknown argument '%s'\n%s\n", arg, desc.c_str());
+            return 1;
+        }
+        ++arg_i;
+        if (arg_i >= argc)
+        {
+            printf("Incomplete argument '%s': exit\n", arg);
+            return 1;
+        }
+        threads = std::stoul(argv[arg_i]);
+        ++arg_i;
+    }
+    if (threads < 1)
+    {
+        printf("Incorrect count of threads: exit\n");
+        return 1;
+    }
+
     Graph_t graph{"COLLATZ"};
-    CheckNumbers(num, graph);
-    printf("%s\n", graph.ToDOT().c_str());
+    const auto time_start = std::chrono::steady_clock::now();
+    if (threads == 1)
+        CheckNumbers(num, graph);
+    else
+        CheckNumbers(num, graph, threads);
+    const auto time_end = std::chrono::steady_clock::now();
+    fprintf(stderr, "threads=%u; nodes=%zu; edges=%zu; time=%ld ms;\n", threads, graph.Nodes().size(),
+            graph.Edges().size(), std::chrono::duration_cast<std::chrono::milliseconds>(time_end - time_start).count());
+
+    GG::BufferedSink sink{GG::FileWriter(stdout)};
+    GG::WriteDOT(graph, sink);
+    sink << '\n';
+    if (not sink.Flush() or (fflush(stdout) != 0))
+    {
+        fprintf(stderr, "Can not write graph: exit\n");
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,122 @@
+// Copyright 2024 oldnick85
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <graph_inclusive.h>
+#include <primitives.h>
+#include <properties/all.h>
+
+using Node_t = GG::Node<int>;
+using Edge_t = GG::Edge<Node_t>;
+template <typename TConnectedComponentWatch>
+using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                                   TConnectedComponentWatch, GG::Named<false>>;
+
+/**
+ * @brief Build a square grid and apply a random mix of edge deletions and insertions
+ * 
+ * @param side grid side
+ * @param operations count of operations
+ * @param seed random seed
+ * @return time in milliseconds and final count of connected components
+ */
+template <typename TConnectedComponentWatch>
+std::pair<uint64_t, int> Run(int side, int operations, uint seed)
+{
+    Graph_t<TConnectedComponentWatch> graph;
+    std::vector<std::pair<int, int>> present;
+    std::vector<std::pair<int, int>> absent;
+    for (int i = 0; i < side * side; ++i)
+        graph.MakeNode(i);
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            const int id = y * side + x;
+            if (x + 1 < side)
+                present.emplace_back(id, id + 1);
+            if (y + 1 < side)
+                present.emplace_back(id, id + side);
+        }
+    }
+    for (const auto& [node1, node2] : present)
+        graph.MakeEdge(node1, node2);
+
+    std::mt19937 rnd(seed);
+    const auto time_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i)
+    {
+        const bool del = absent.empty() or (not present.empty() and (rnd() % 2 == 0));
+        auto& from     = del ? present : absent;
+        auto& to       = del ? absent : present;
+        const auto idx = rnd() % from.size();
+        const auto nodes = from[idx];
+        from[idx]        = from.back();
+        from.pop_back();
+        to.push_back(nodes);
+        if (del)
+            graph.DelEdgesBetween(nodes.first, nodes.second);
+        else
+            graph.MakeEdge(nodes.first, nodes.second);
+    }
+    const auto time_end = std::chrono::steady_clock::now();
+    const uint64_t time_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(time_end - time_start).count();
+    const int components = graph.ConnectedComponentsCount();
+    graph.Clear();
+    return {time_ms, components};
+}
+
+int main(int argc, char** argv)
+{
+    std::string desc;
+    desc += "  -h,--help     print usage information and exit\n";
+    desc += "  -side N       grid side (100 by default)\n";
+    desc += "  -ops N        count of random edge deletions and insertions (10000 by default)\n";
+    desc += "  -seed N       random seed (1 by default)\n";
+    int side       = 100;
+    int operations = 10000;
+    uint seed      = 1;
+    int arg_i      = 1;
+    while (arg_i < argc)
+    {
+        const auto* arg = argv[arg_i];
+        if ((std::strcmp(arg, "--help") == 0) or (std::strcmp(arg, "-h") == 0))
+        {
+            printf("%s\n", desc.c_str());
+            return 0;
+        }
+        ++arg_i;
+        if (arg_i >= argc)
+        {
+            printf("Incomplete argument '%s': exit\n", arg);
+            return 1;
+        }
+        if (std::strcmp(arg, "-side") == 0)
+            side = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-ops") == 0)
+            operations = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-seed") == 0)
+            seed = std::stoul(argv[arg_i]);
+        ++arg_i;
+    }
+
+    if (side <= 1)
+    {
+        printf("Incorrect grid side: exit\n");
+        return 1;
+    }
+
+    const auto [bfs_ms, bfs_components] =
+        Run<GG::ConnectedComponentWatch<Node_t, Edge_t, true>>(side, operations, seed);
+    printf("ConnectedComponentWatch:        time=%lu ms; components=%d;\n", bfs_ms, bfs_components);
+    const auto [forest_ms, forest_components] =
+        Run<GG::ConnectedComponentWatchDynamic<Node_t, Edge_t>>(side, operations, seed);
+    printf("ConnectedComponentWatchDynamic: time=%lu ms; components=%d;\n", forest_ms, forest_components);
+    return 0;
+}
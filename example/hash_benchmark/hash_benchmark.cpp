@@ -0,0 +1,103 @@
+// Copyright 2024 oldnick85
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <area.h>
+#include <hash.h>
+
+using Clock_t = std::chrono::steady_clock;
+
+/**
+ * @brief Hash that was used for Coord2D before: XOR of coordinate hashes
+ */
+struct Coord2DHashXor {
+    std::size_t operator()(const GG::Coord2D& coord) const
+    {
+        return std::hash<int>()(coord.X()) ^ std::hash<int>()(coord.Y());
+    }
+};
+
+uint64_t ElapsedMs(const Clock_t::time_point& time_start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock_t::now() - time_start).count();
+}
+
+/**
+ * @brief Fill a map with all cells of a square grid, look every cell up and print timings and statistics
+ *
+ * @param name map name
+ * @param side grid side
+ */
+template <typename TMap>
+void Run(const char* name, int side)
+{
+    TMap map;
+    auto time_start = Clock_t::now();
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+            map.emplace(GG::Coord2D(x, y), nullptr);
+    }
+    const auto insert_ms = ElapsedMs(time_start);
+
+    time_start   = Clock_t::now();
+    size_t found = 0;
+    for (int x = 0; x < side; ++x)
+    {
+        for (int y = 0; y < side; ++y)
+            found += (map.find(GG::Coord2D(x, y)) != map.end()) ? 1 : 0;
+    }
+    const auto find_ms = ElapsedMs(time_start);
+
+    const auto stats = GG::CollectHashStats(map);
+    printf("%-22s side=%d; insert=%lu ms; find=%lu ms; found=%lu; load=%.2f; avg probe=%.2f; worst bucket=%lu;\n",
+           name, side, insert_ms, find_ms, found, stats.load_factor, stats.average_probe, stats.worst_bucket);
+}
+
+int main(int argc, char** argv)
+{
+    std::string desc;
+    desc += "  -h,--help     print usage information and exit\n";
+    desc += "  -side N       grid side (4096 by default)\n";
+    desc += "  -xor-side N   grid side for the old XOR hash, it degrades quadratically (256 by default)\n";
+    int side     = 4096;
+    int xor_side = 256;
+    int arg_i    = 1;
+    while (arg_i < argc)
+    {
+        const auto* arg = argv[arg_i];
+        if ((std::strcmp(arg, "--help") == 0) or (std::strcmp(arg, "-h") == 0))
+        {
+            printf("%s\n", desc.c_str());
+            return 0;
+        }
+        ++arg_i;
+        if (arg_i >= argc)
+        {
+            printf("Incomplete argument '%s': exit\n", arg);
+            return 1;
+        }
+        if (std::strcmp(arg, "-side") == 0)
+            side = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-xor-side") == 0)
+            xor_side = std::stoi(argv[arg_i]);
+        ++arg_i;
+    }
+
+    if ((side <= 1) or (xor_side <= 1))
+    {
+        printf("Incorrect grid side: exit\n");
+        return 1;
+    }
+
+    Run<std::unordered_map<GG::Coord2D, void*, Coord2DHashXor>>("unordered_map XOR", xor_side);
+    Run<std::unordered_map<GG::Coord2D, void*>>("unordered_map", xor_side);
+    Run<std::unordered_map<GG::Coord2D, void*>>("unordered_map", side);
+    Run<std::unordered_map<GG::Coord2D, void*, GG::NodeIdHash<GG::Coord2D>>>("unordered_map NodeIdHash", side);
+    Run<GG::FlatHashMap<GG::Coord2D, void*>>("FlatHashMap", side);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 oldnick85
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <adjacency.h>
+#include <algorithms.h>
+#include <area.h>
+
+using Clock_t = std::chrono::steady_clock;
+
+uint64_t ElapsedMs(const Clock_t::time_point& time_start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock_t::now() - time_start).count();
+}
+
+/**
+ * @brief Build a Moore grid graph with random obstacles and run wave searches over it
+ *
+ * @param name node kind name
+ * @param side grid side
+ * @param obstacles percent of impassable cells
+ * @param waves count of wave searches
+ * @param seed random seed
+ */
+template <typename TNode>
+void Run(const char* name, int side, int obstacles, int waves, uint seed)
+{
+    using Area_t = GG::Area2D<TNode, GG::NeighborhoodMoore>;
+    const GG::Range2D range(GG::Coord2D(side - 1, side - 1));
+    GG::BitMap2D map(range);
+    map.SetRect(range, true);
+    std::mt19937 rnd(seed);
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            if (static_cast<int>(rnd() % 100) < obstacles)
+                map.Set({x, y}, false);
+        }
+    }
+    const GG::Coord2D start(side / 2, side / 2);
+    map.Set(start, true);
+
+    auto time_start = Clock_t::now();
+    Area_t area(range);
+    area.SetMap(map);
+    const auto build_ms = ElapsedMs(time_start);
+
+    const GG::GraphInclusiveAdjacency adjacency(&area.Graph());
+    size_t reached  = 0;
+    time_start      = Clock_t::now();
+    for (int i = 0; i < waves; ++i)
+    {
+        GG::WaveSearch wave(&adjacency, area.Graph().Find(start));
+        wave.SpreadWave();
+        reached = wave.ReachedNodes().size();
+    }
+    const auto wave_ms = ElapsedMs(time_start);
+    printf("%-7s node=%zu bytes; build=%lu ms; wave=%lu ms; reached=%zu; edges=%zu;\n", name, sizeof(TNode), build_ms,
+           wave_ms / waves, reached, area.Graph().Edges().size());
+}
+
+int main(int argc, char** argv)
+{
+    std::string desc;
+    desc += "  -h,--help     print usage information and exit\n";
+    desc += "  -side N       grid side (1024 by default)\n";
+    desc += "  -obst N       percent of impassable cells (20 by default)\n";
+    desc += "  -waves N      count of wave searches (5 by default)\n";
+    desc += "  -seed N       random seed (1 by default)\n";
+    desc += "  -node NAME    run only node kind NAME: heap or inline\n";
+    int side      = 1024;
+    int obstacles = 20;
+    int waves     = 5;
+    uint seed     = 1;
+    std::string node;
+    int arg_i = 1;
+    while (arg_i < argc)
+    {
+        const auto* arg = argv[arg_i];
+        if ((std::strcmp(arg, "--help") == 0) or (std::strcmp(arg, "-h") == 0))
+        {
+            printf("%s\n", desc.c_str());
+            return 0;
+        }
+        ++arg_i;
+        if (arg_i >= argc)
+        {
+            printf("Incomplete argument '%s': exit\n", arg);
+            return 1;
+        }
+        if (std::strcmp(arg, "-side") == 0)
+            side = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-obst") == 0)
+            obstacles = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-waves") == 0)
+            waves = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-seed") == 0)
+            seed = std::stoul(argv[arg_i]);
+        else if (std::strcmp(arg, "-node") == 0)
+            node = argv[arg_i];
+        ++arg_i;
+    }
+
+    if ((side <= 1) or (waves <= 0))
+    {
+        printf("Incorrect grid side or count of waves: exit\n");
+        return 1;
+    }
+
+    if (node.empty() or (node == "heap"))
+        Run<GG::Node<GG::Coord2D>>("heap", side, obstacles, waves, seed);
+    if (node.empty() or (node == "inline"))
+        Run<GG::AreaNode2D<GG::NeighborhoodMoore>>("inline", side, obstacles, waves, seed);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 oldnick85
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <algorithms.h>
+#include <area_implicit.h>
+
+using Clock_t = std::chrono::steady_clock;
+
+uint64_t ElapsedMs(const Clock_t::time_point& time_start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock_t::now() - time_start).count();
+}
+
+/**
+ * @brief Run wave searches and component labeling over a square grid with random obstacles
+ *
+ * @param name linearization name
+ * @param side grid side
+ * @param obstacles percent of impassable cells
+ * @param seed random seed
+ */
+template <typename TLinearization>
+void Run(const char* name, int side, int obstacles, uint seed)
+{
+    using Area_t = GG::AreaImplicit2D<GG::NeighborhoodVonNeumann, TLinearization>;
+    const GG::Range2D range(GG::Coord2D(side - 1, side - 1));
+    Area_t area(range);
+    area.SetPassableAll(true);
+    std::mt19937 rnd(seed);
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            if (static_cast<int>(rnd() % 100) < obstacles)
+                area.SetPassable({x, y}, false);
+        }
+    }
+    const GG::Coord2D start(side / 2, side / 2);
+    area.SetPassable(start, true);
+
+    auto time_start = Clock_t::now();
+    GG::WaveSearch wave(&area, start);
+    wave.SpreadWave();
+    const auto wave_ms = ElapsedMs(time_start);
+
+    time_start = Clock_t::now();
+    GG::AreaImplicitPathFindContext path_find_context(&area, start);
+    path_find_context.SpreadWave();
+    const auto path_find_ms = ElapsedMs(time_start);
+
+    time_start            = Clock_t::now();
+    const int components  = area.ConnectedComponentsCount();
+    const auto label_ms   = ElapsedMs(time_start);
+    const double reached  = wave.ReachedNodes().size();
+    const double wave_mcs = (wave_ms > 0) ? reached / 1000.0 / wave_ms : 0.0;
+    printf("%-8s wave=%lu ms (%.1f Mcells/s); parents wave=%lu ms; labeling=%lu ms; reached=%.0f; components=%d;\n",
+           name, wave_ms, wave_mcs, path_find_ms, label_ms, reached, components);
+}
+
+int main(int argc, char** argv)
+{
+    std::string desc;
+    desc += "  -h,--help     print usage information and exit\n";
+    desc += "  -side N       grid side (2048 by default)\n";
+    desc += "  -obst N       percent of impassable cells (20 by default)\n";
+    desc += "  -seed N       random seed (1 by default)\n";
+    desc += "  -lin NAME     run only linearization NAME: y, x or morton\n";
+    desc += "Run a single linearization under 'perf stat -e cache-misses' to compare cache misses\n";
+    int side      = 2048;
+    int obstacles = 20;
+    uint seed     = 1;
+    std::string lin;
+    int arg_i = 1;
+    while (arg_i < argc)
+    {
+        const auto* arg = argv[arg_i];
+        if ((std::strcmp(arg, "--help") == 0) or (std::strcmp(arg, "-h") == 0))
+        {
+            printf("%s\n", desc.c_str());
+            return 0;
+        }
+        ++arg_i;
+        if (arg_i >= argc)
+        {
+            printf("Incomplete argument '%s': exit\n", arg);
+            return 1;
+        }
+        if (std::strcmp(arg, "-side") == 0)
+            side = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-obst") == 0)
+            obstacles = std::stoi(argv[arg_i]);
+        else if (std::strcmp(arg, "-seed") == 0)
+            seed = std::stoul(argv[arg_i]);
+        else if (std::strcmp(arg, "-lin") == 0)
+            lin = argv[arg_i];
+        ++arg_i;
+    }
+
+    if (side <= 1)
+    {
+        printf("Incorrect grid side: exit\n");
+        return 1;
+    }
+
+    if (lin.empty() or (lin == "y"))
+        Run<GG::LinearizationByY>("by Y", side, obstacles, seed);
+    if (lin.empty() or (lin == "x"))
+        Run<GG::LinearizationByX>("by X", side, obstacles, seed);
+    if (lin.empty() or (lin == "morton"))
+        Run<GG::LinearizationMorton>("Morton", side, obstacles, seed);
+    return 0;
+}
@@ -17,23 +17,16 @@ template <typename TNeighborhood>
 using Area_t = GG::Area2D<Node_t, TNeighborhood, GG::ConnectedComponentWatch<Node_t, GG::Edge<Node_t>, false>>;
 
 template <typename TNeighborhood>
-uint CalcInTouch(const Area_t<TNeighborhood>& area, const Coord_t& max_coord, const Coord_t& start_coord)
+uint CalcInTouch(const Area_t<TNeighborhood>& area, const Coord_t& start_coord)
 {
     GG::PathFindContext path_find_context{&(area.Graph()), area.Graph().Find(start_coord)};
     path_find_context.SpreadWave();
-    auto nodes = path_find_context.WaveNodes();
-    std::unordered_set<Coord_t> in_touch;
-    for (auto* const node : nodes)
-    {
-        auto coord            = node->Id();
-        auto neighbour_coords = TNeighborhood::NeighbourCoordinates(coord, GG::Range2D(max_coord));
-        for (auto neighbour_coord : neighbour_coords)
-        {
-            if (not area.Passable(neighbour_coord))
-                in_touch.insert(neighbour_coord);
-        }
-    }
-    return in_touch.size();
+    GG::BitMap2D reached(area.Range());
+    for (auto* const node : path_find_context.WaveNodes())
+        reached.Set(node->Id(), true);
+    auto in_touch = reached.Dilated<TNeighborhood>();
+    in_touch.AndNot(area.Map());
+    return in_touch.Count();
 }
 
 Coord_t NextCoord(const Coord_t& coord, const Coord_t& max_coord)
@@ -99,7 +92,7 @@ void Search(const Coord_t& max_coord, const Coord_t& start_coord)
             continue;
         if (area.Graph().ConnectedComponentsCount() > 1)
             continue;
-        const auto in_touch = CalcInTouch<TNeighborhood>(area, max_coord, start_coord);
+        const auto in_touch = CalcInTouch<TNeighborhood>(area, start_coord);
         if (in_touch >= max_in_touch)
         {
             max_in_touch        = in_touch;
@@ -0,0 +1,149 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include "./common.h"
+#include "./concepts.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Adjacency provider over a GraphInclusive graph
+ *
+ * Directed edges of a directed graph are followed from their first node to the second one only. Nodes with separate
+ * out-edges and in-edges, such as Node<TNodeId, true>, are walked over the needed range only, other nodes are walked
+ * over all edges with a check of direction. Weighted traversal is available for weighted graphs only.
+ *
+ * @tparam TGraph graph type
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности над графом GraphInclusive
+ *
+ * Направленные рёбра направленного графа проходятся только от первой вершины ко второй. Вершины с раздельными
+ * исходящими и входящими рёбрами, такие как Node<TNodeId, true>, проходятся только по нужному диапазону, остальные
+ * вершины проходятся по всем рёбрам с проверкой направления. Взвешенный обход доступен только для взвешенных графов.
+ *
+ * @tparam TGraph тип графа
+ */
+template <typename TGraph>
+class GraphInclusiveAdjacency
+{
+  public:
+    using Graph_t      = TGraph;
+    using Node_t       = typename TGraph::Node_t;
+    using NodeHandle_t = Node_t*;
+    // nodes of a directed graph with separate out-edges and in-edges are walked without direction checks
+    static constexpr bool HasEdgeParts = TGraph::IsDirected and requires(const Node_t& node) { node.OutEdges(); };
+
+    explicit GraphInclusiveAdjacency(const TGraph* graph) : m_graph(graph)
+    {
+        GRAPH_DEBUG_ASSERT(m_graph != nullptr, "Null graph");
+    }
+
+    const TGraph* Graph() const { return m_graph; }
+
+    template <typename TFunc>
+    void ForEachNode(TFunc func) const
+    {
+        for (const auto& node_el : m_graph->Nodes())
+            func(node_el.second);
+    }
+
+    template <typename TFunc>
+    void ForEachNeighbour(Node_t* node, TFunc func) const
+    {
+        if constexpr (HasEdgeParts)
+        {
+            for (const auto edge : node->OutEdges())
+                func(edge->OtherNode(node));
+        }
+        else
+        {
+            for (const auto edge : node->Edges())
+            {
+                if constexpr (TGraph::IsDirected)
+                {
+                    if (edge->Directed() and (edge->Nodes().first != node))
+                        continue;
+                }
+                func(edge->OtherNode(node));
+            }
+        }
+    }
+
+    template <typename TFunc>
+        requires TGraph::IsWeighted
+    void ForEachNeighbourWeighted(Node_t* node, TFunc func) const
+    {
+        if constexpr (HasEdgeParts)
+        {
+            for (const auto edge : node->OutEdges())
+                func(edge->OtherNode(node), edge->Weight());
+        }
+        else
+        {
+            for (const auto edge : node->Edges())
+            {
+                if constexpr (TGraph::IsDirected)
+                {
+                    if (edge->Directed() and (edge->Nodes().first != node))
+                        continue;
+                }
+                func(edge->OtherNode(node), edge->Weight());
+            }
+        }
+    }
+
+    template <typename TFunc>
+    void ForEachPredecessor(Node_t* node, TFunc func) const
+    {
+        if constexpr (HasEdgeParts)
+        {
+            for (const auto edge : node->InEdges())
+                func(edge->OtherNode(node));
+        }
+        else
+        {
+            for (const auto edge : node->Edges())
+            {
+                if constexpr (TGraph::IsDirected)
+                {
+                    if (edge->Directed() and (edge->Nodes().second != node))
+                        continue;
+                }
+                func(edge->OtherNode(node));
+            }
+        }
+    }
+
+    template <typename TFunc>
+        requires TGraph::IsWeighted
+    void ForEachPredecessorWeighted(Node_t* node, TFunc func) const
+    {
+        if constexpr (HasEdgeParts)
+        {
+            for (const auto edge : node->InEdges())
+                func(edge->OtherNode(node), edge->Weight());
+        }
+        else
+        {
+            for (const auto edge : node->Edges())
+            {
+                if constexpr (TGraph::IsDirected)
+                {
+                    if (edge->Directed() and (edge->Nodes().second != node))
+                        continue;
+                }
+                func(edge->OtherNode(node), edge->Weight());
+            }
+        }
+    }
+
+  private:
+    const TGraph* m_graph = nullptr;
+};
+
+}  // namespace GG
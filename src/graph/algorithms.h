@@ -0,0 +1,507 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+#include "./concepts.h"
+#include "./generator.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Wave search from a start node over any adjacency provider
+ *
+ * Unweighted providers are traversed breadth-first, one wave level per step. Weighted providers are traversed by
+ * Dijkstra's algorithm, one settled node per step. Per-node state lives in a plain array for dense indexed providers
+ * and in a hash map otherwise. The choice is made at compile time, so unused code is not instantiated.
+ *
+ * Besides whole steps, the search can be advanced node by node with budgeted slices of Steps() and level by level with
+ * Layers(), both resumable at the exact node they stopped at.
+ *
+ * @tparam TAdjacency adjacency provider type
+ */
+/**
+ * \~russian
+ * @brief Волновой поиск из стартовой вершины по любому поставщику смежности
+ *
+ * Невзвешенные поставщики обходятся в ширину, по одному уровню волны за шаг. Взвешенные поставщики обходятся
+ * алгоритмом Дейкстры, по одной окончательной вершине за шаг. Состояние вершин хранится в обычном массиве для
+ * поставщиков с плотными индексами и в хеш-таблице в остальных случаях. Выбор делается на этапе компиляции, поэтому
+ * неиспользуемый код не инстанцируется.
+ *
+ * Кроме целых шагов, поиск можно продвигать по вершинам ограниченными порциями Steps() и по уровням через Layers(),
+ * оба возобновляются ровно с той вершины, на которой остановились.
+ *
+ * @tparam TAdjacency тип поставщика смежности
+ */
+template <AdjacencyProvider TAdjacency>
+class WaveSearch
+{
+  public:
+    using Node_t                     = typename TAdjacency::NodeHandle_t;
+    using Path_t                     = std::vector<Node_t>;
+    static constexpr bool IsWeighted = WeightedAdjacencyProvider<TAdjacency>;
+    static constexpr bool IsDense    = DenseIndexedProvider<TAdjacency>;
+
+    /**
+     * \~english
+     * @brief Limits of one slice of stepping, zero means no limit
+     */
+    /**
+     * \~russian
+     * @brief Ограничения одной порции шагов, ноль означает отсутствие ограничения
+     */
+    struct StepBudget {
+        size_t nodes = 0;
+        std::chrono::nanoseconds time{0};
+    };
+
+    WaveSearch(const TAdjacency* adjacency, const Node_t& start) : m_adjacency(adjacency), m_start(start)
+    {
+        GRAPH_DEBUG_ASSERT(m_adjacency != nullptr, "Null adjacency");
+        if constexpr (IsDense)
+            m_dense_marks.resize(m_adjacency->NodeIndexCount());
+        Seed();
+    }
+
+    const Node_t& Start() const { return m_start; }
+
+    /**
+     * \~english
+     * @brief Start a new search from another node, reusing memory of the previous one
+     *
+     * Only marks of nodes touched by the previous search are cleared, so a dense search does not pay for the whole
+     * node array again.
+     *
+     * @param start start node
+     */
+    /**
+     * \~russian
+     * @brief Начать новый поиск из другой вершины, повторно используя память предыдущего
+     *
+     * Очищаются только метки вершин, затронутых предыдущим поиском, поэтому плотный поиск не платит снова за весь
+     * массив вершин.
+     *
+     * @param start стартовая вершина
+     */
+    void Reset(const Node_t& start)
+    {
+        if constexpr (IsDense)
+        {
+            // every marked node is either reached or still queued
+            for (const auto& node : m_reached)
+                m_dense_marks[m_adjacency->NodeIndex(node)].reset();
+            for (; not m_queue.empty(); m_queue.pop())
+                m_dense_marks[m_adjacency->NodeIndex(m_queue.top().second)].reset();
+            m_dense_marks.resize(m_adjacency->NodeIndexCount());
+        }
+        else
+        {
+            m_sparse_marks.clear();
+            m_queue = {};
+        }
+        m_reached.clear();
+        m_forefront.clear();
+        m_next_forefront.clear();
+        m_forefront_pos = 0;
+        m_start         = start;
+        Seed();
+    }
+
+    /**
+     * \~english
+     * @brief Start a new search over another adjacency provider, e.g. a newer version of the same graph, reusing memory
+     *
+     * The previous provider is not accessed, so it may be destroyed already. All marks are cleared, their storage and
+     * the storage of fronts is kept.
+     *
+     * @param adjacency adjacency provider
+     * @param start start node
+     */
+    /**
+     * \~russian
+     * @brief Начать новый поиск по другому поставщику смежности, например более новой версии того же графа, повторно
+     * используя память
+     *
+     * К предыдущему поставщику обращений нет, поэтому он может быть уже уничтожен. Очищаются все метки, память под них
+     * и под фронты сохраняется.
+     *
+     * @param adjacency поставщик смежности
+     * @param start стартовая вершина
+     */
+    void Reset(const TAdjacency* adjacency, const Node_t& start)
+    {
+        GRAPH_DEBUG_ASSERT(adjacency != nullptr, "Null adjacency");
+        m_adjacency = adjacency;
+        if constexpr (IsDense)
+            m_dense_marks.assign(m_adjacency->NodeIndexCount(), std::nullopt);
+        else
+            m_sparse_marks.clear();
+        m_queue = {};
+        m_reached.clear();
+        m_forefront.clear();
+        m_next_forefront.clear();
+        m_forefront_pos = 0;
+        m_start         = start;
+        Seed();
+    }
+
+    bool Exhausted() const
+    {
+        if constexpr (IsWeighted)
+            return m_queue.empty();
+        else
+            return (m_forefront_pos >= m_forefront.size()) and m_next_forefront.empty();
+    }
+
+    void Step()
+    {
+        if (Exhausted())
+            return;
+        ExpandNode();
+        if constexpr (not IsWeighted)
+        {
+            while (m_forefront_pos < m_forefront.size())
+                ExpandNode();
+        }
+    }
+
+    /**
+     * \~english
+     * @brief Advance the search in slices limited by a budget
+     *
+     * Every slice expands at least one node, the clock is checked every few nodes. The search must outlive the
+     * generator and must not be stepped by other means while the generator is suspended.
+     *
+     * @param budget limits of every slice
+     * @return count of reached nodes after every slice
+     */
+    /**
+     * \~russian
+     * @brief Продвигать поиск порциями, ограниченными бюджетом
+     *
+     * Каждая порция раскрывает хотя бы одну вершину, время проверяется через каждые несколько вершин. Поиск должен
+     * пережить генератор и не должен продвигаться другими способами, пока генератор приостановлен.
+     *
+     * @param budget ограничения каждой порции
+     * @return количество достигнутых вершин после каждой порции
+     */
+    Generator<size_t> Steps(StepBudget budget)
+    {
+        static constexpr size_t ClockPeriod = 16;
+        while (not Exhausted())
+        {
+            const auto deadline = std::chrono::steady_clock::now() + budget.time;
+            size_t expanded     = 0;
+            do
+            {
+                ExpandNode();
+                ++expanded;
+                if ((budget.nodes > 0) and (expanded >= budget.nodes))
+                    break;
+                if ((budget.time.count() > 0) and (expanded % ClockPeriod == 0) and
+                    (std::chrono::steady_clock::now() >= deadline))
+                    break;
+            } while (not Exhausted());
+            co_yield m_reached.size();
+        }
+    }
+
+    /**
+     * \~english
+     * @brief Lazy range of wave levels, every level is expanded only when the range is advanced past it
+     *
+     * The search must outlive the generator and must not be stepped by other means while the generator is suspended.
+     *
+     * @return nodes of every level in order of reaching
+     */
+    /**
+     * \~russian
+     * @brief Ленивый диапазон уровней волны, каждый уровень раскрывается только при продвижении диапазона за него
+     *
+     * Поиск должен пережить генератор и не должен продвигаться другими способами, пока генератор приостановлен.
+     *
+     * @return вершины каждого уровня в порядке достижения
+     */
+    Generator<std::span<const Node_t>> Layers()
+        requires(not IsWeighted)
+    {
+        while (true)
+        {
+            if (m_forefront_pos >= m_forefront.size())
+            {
+                if (m_next_forefront.empty())
+                    co_return;
+                NextLevel();
+            }
+            co_yield std::span<const Node_t>(m_forefront);
+            while (m_forefront_pos < m_forefront.size())
+                ExpandNode();
+        }
+    }
+
+    void SpreadWave()
+    {
+        while (not Exhausted())
+        {
+            Step();
+        }
+    }
+
+    bool Reached(const Node_t& node) const
+    {
+        const auto* mark = FindMark(node);
+        return (mark != nullptr) and mark->settled;
+    }
+
+    float DistanceTo(const Node_t& node) const
+    {
+        const auto* mark = FindMark(node);
+        if ((mark == nullptr) or not mark->settled)
+            return 0.0;
+        return mark->distance;
+    }
+
+    /**
+     * \~english
+     * @brief Get path from the start to a reached node
+     *
+     * @param target target node
+     * @return nodes from the start to the target or empty path if the target is not reached
+     */
+    /**
+     * \~russian
+     * @brief Получить путь от старта до достигнутой вершины
+     *
+     * @param target целевая вершина
+     * @return вершины от старта до цели или пустой путь, если цель не достигнута
+     */
+    Path_t PathTo(const Node_t& target) const
+    {
+        Path_t path;
+        if (not Reached(target))
+            return path;
+        Node_t node = target;
+        path.push_back(node);
+        while (not(node == m_start))
+        {
+            node = FindMark(node)->parent;
+            path.push_back(node);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    /**
+     * \~english
+     * @brief Step until the target is reached or the wave is exhausted
+     *
+     * @param target target node
+     * @return path to the target or empty path
+     */
+    /**
+     * \~russian
+     * @brief Делать шаги, пока цель не достигнута или волна не исчерпана
+     *
+     * @param target целевая вершина
+     * @return путь до цели или пустой путь
+     */
+    Path_t FindPathTo(const Node_t& target)
+    {
+        while (not Reached(target) and not Exhausted())
+        {
+            Step();
+        }
+        return PathTo(target);
+    }
+
+    /**
+     * \~english
+     * @brief Get reached nodes in order of reaching
+     *
+     * @return reached nodes
+     */
+    /**
+     * \~russian
+     * @brief Получить достигнутые вершины в порядке достижения
+     *
+     * @return достигнутые вершины
+     */
+    const std::vector<Node_t>& ReachedNodes() const { return m_reached; }
+
+  private:
+    struct Mark {
+        Node_t parent;
+        float distance = 0.0;
+        bool settled   = false;
+    };
+
+    void Seed()
+    {
+        if constexpr (IsWeighted)
+        {
+            SetMark(m_start, Mark{m_start, 0.0, false});
+            m_queue.emplace(0.0, m_start);
+        }
+        else
+        {
+            SetMark(m_start, Mark{m_start, 0.0, true});
+            m_reached.push_back(m_start);
+            m_forefront.push_back(m_start);
+        }
+    }
+
+    const Mark* FindMark(const Node_t& node) const
+    {
+        if constexpr (IsDense)
+        {
+            const auto& mark = m_dense_marks[m_adjacency->NodeIndex(node)];
+            return mark.has_value() ? &mark.value() : nullptr;
+        }
+        else
+        {
+            const auto mark_it = m_sparse_marks.find(node);
+            return (mark_it == m_sparse_marks.end()) ? nullptr : &mark_it->second;
+        }
+    }
+
+    void SetMark(const Node_t& node, const Mark& mark)
+    {
+        if constexpr (IsDense)
+            m_dense_marks[m_adjacency->NodeIndex(node)] = mark;
+        else
+            m_sparse_marks.insert_or_assign(node, mark);
+    }
+
+    void NextLevel()
+    {
+        m_forefront.swap(m_next_forefront);
+        m_next_forefront.clear();
+        m_forefront_pos = 0;
+    }
+
+    void ExpandNode()
+    {
+        if constexpr (IsWeighted)
+            StepDijkstra();
+        else
+            ExpandWaveNode();
+    }
+
+    void ExpandWaveNode()
+    {
+        if (m_forefront_pos >= m_forefront.size())
+            NextLevel();
+        const Node_t node    = m_forefront[m_forefront_pos++];
+        const float distance = FindMark(node)->distance + 1.0F;
+        m_adjacency->ForEachNeighbour(node, [&](const Node_t& node_to) {
+            if (FindMark(node_to) != nullptr)
+                return;
+            SetMark(node_to, Mark{node, distance, true});
+            m_reached.push_back(node_to);
+            m_next_forefront.push_back(node_to);
+        });
+    }
+
+    void StepDijkstra()
+    {
+        while (not m_queue.empty())
+        {
+            const auto [distance, node] = m_queue.top();
+            m_queue.pop();
+            auto mark = *FindMark(node);
+            if (mark.settled or (mark.distance < distance))
+                continue;
+            mark.settled = true;
+            SetMark(node, mark);
+            m_reached.push_back(node);
+            m_adjacency->ForEachNeighbourWeighted(node, [&](const Node_t& node_to, float weight) {
+                const float distance_to = distance + weight;
+                const auto* mark_to     = FindMark(node_to);
+                if ((mark_to != nullptr) and (mark_to->settled or (mark_to->distance <= distance_to)))
+                    return;
+                SetMark(node_to, Mark{node, distance_to, false});
+                m_queue.emplace(distance_to, node_to);
+            });
+            return;
+        }
+    }
+
+    struct QueueOrder {
+        bool operator()(const std::pair<float, Node_t>& lhs, const std::pair<float, Node_t>& rhs) const
+        {
+            return lhs.first > rhs.first;
+        }
+    };
+
+    const TAdjacency* m_adjacency = nullptr;
+    Node_t m_start;
+    std::vector<Node_t> m_reached;
+    // current level, nodes before the position are already expanded into the next level
+    std::vector<Node_t> m_forefront;
+    size_t m_forefront_pos = 0;
+    std::vector<Node_t> m_next_forefront;
+    std::priority_queue<std::pair<float, Node_t>, std::vector<std::pair<float, Node_t>>, QueueOrder> m_queue;
+    std::vector<std::optional<Mark>> m_dense_marks;
+    std::unordered_map<Node_t, Mark> m_sparse_marks;
+};
+
+constexpr int LabelNone = -1;
+
+/**
+ * \~english
+ * @brief Label connected components of any node enumerable adjacency provider
+ *
+ * @param adjacency adjacency provider, must be symmetric
+ * @param label function returning a reference to the label of a node, all labels must be LabelNone beforehand
+ * @return count of components
+ */
+/**
+ * \~russian
+ * @brief Разметить компоненты связности любого поставщика смежности с перечислимыми вершинами
+ *
+ * @param adjacency поставщик смежности, должен быть симметричным
+ * @param label функция, возвращающая ссылку на метку вершины, все метки заранее должны быть равны LabelNone
+ * @return количество компонент
+ */
+template <NodeEnumerableProvider TAdjacency, typename TLabel>
+int LabelConnectedComponents(const TAdjacency& adjacency, TLabel label)
+{
+    using Node_t = typename TAdjacency::NodeHandle_t;
+    int count    = 0;
+    std::vector<Node_t> front;
+    adjacency.ForEachNode([&](const Node_t& start) {
+        if (label(start) != LabelNone)
+            return;
+        const int component_id = count++;
+        label(start)           = component_id;
+        front.push_back(start);
+        while (not front.empty())
+        {
+            const Node_t node = front.back();
+            front.pop_back();
+            adjacency.ForEachNeighbour(node, [&](const Node_t& node_to) {
+                auto& label_to = label(node_to);
+                if (label_to != LabelNone)
+                    return;
+                label_to = component_id;
+                front.push_back(node_to);
+            });
+        }
+    });
+    return count;
+}
+
+}  // namespace GG
@@ -2,7 +2,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "./path_find.h"
@@ -14,6 +21,7 @@ namespace GG
 class Coord2D
 {
   public:
+    Coord2D() = default;
     Coord2D(int x, int y) : m_x(x), m_y(y) {}
 
     bool operator==(const Coord2D& rhs) const { return ((X() == rhs.X()) and (Y() == rhs.Y())); }
@@ -91,6 +99,9 @@ class Range2D
         GRAPH_DEBUG_ASSERT(m_max.Y() >= m_min.Y(), "Wrong Y coordinate");
     }
 
+    bool operator==(const Range2D& rhs) const { return ((m_max == rhs.m_max) and (m_min == rhs.m_min)); }
+    bool operator!=(const Range2D& rhs) const { return !(*this == rhs); }
+
     /**
      * \~english
      * @brief Get the number of coordinates in a range
@@ -220,6 +231,49 @@ class Range2D
         return ((coord.Y() - m_min.Y()) * (m_max.X() - m_min.X() + 1) + coord.X() - m_min.X());
     }
 
+    /**
+     * \~english
+     * @brief Convert coordinate to linear view in Z-order. The range is covered by square Z-order tiles laid along its
+     * longer side, so cells close on the plane are mostly close in memory
+     * 
+     * @param coord coordinate
+     * @return linear coordinate, less than LineMortonCount()
+     */
+    /**
+     * \~russian
+     * @brief Преобразовать координату в линейный вид в Z-порядке. Диапазон покрывается квадратными плитками Z-порядка,
+     * уложенными вдоль его длинной стороны, так что близкие на плоскости клетки в основном близки в памяти
+     * 
+     * @param coord координата
+     * @return линейная координата, меньше LineMortonCount()
+     */
+    uint CoordToLineMorton(const Coord2D& coord) const
+    {
+        GRAPH_DEBUG_ASSERT(Contains(coord), "Wrong coordinates");
+        const auto x            = static_cast<uint32_t>(coord.X() - m_min.X());
+        const auto y            = static_cast<uint32_t>(coord.Y() - m_min.Y());
+        const bool wide         = (m_max.X() - m_min.X() >= m_max.Y() - m_min.Y());
+        const uint tile_bits    = MortonTileBits();
+        const uint32_t low_mask = (uint32_t{1} << tile_bits) - 1;
+        const uint32_t tile     = (wide ? x : y) >> tile_bits;
+        return static_cast<uint>((static_cast<uint64_t>(tile) << (2 * tile_bits)) | SpreadBits(x & low_mask) |
+                                 (SpreadBits(y & low_mask) << 1U));
+    }
+
+    /**
+     * \~english
+     * @brief Get the size of an array indexed by CoordToLineMorton
+     * 
+     * @return size of an array
+     */
+    /**
+     * \~russian
+     * @brief Получить размер массива, индексируемого CoordToLineMorton
+     * 
+     * @return размер массива
+     */
+    uint LineMortonCount() const { return CoordToLineMorton(m_max) + 1; }
+
     /**
      * \~english
      * @brief Get string description
@@ -240,42 +294,182 @@ class Range2D
     }
 
   private:
+    /**
+     * @brief Get binary logarithm of Z-order tile side, the tile covers the shorter side of the range
+     */
+    uint MortonTileBits() const
+    {
+        return std::bit_width(static_cast<uint32_t>(std::min(m_max.X() - m_min.X(), m_max.Y() - m_min.Y())));
+    }
+
+    /**
+     * @brief Insert a zero bit after every bit of a value
+     */
+    static uint64_t SpreadBits(uint32_t value)
+    {
+        uint64_t res = value;
+        res          = (res | (res << 16U)) & 0x0000FFFF0000FFFFULL;
+        res          = (res | (res << 8U)) & 0x00FF00FF00FF00FFULL;
+        res          = (res | (res << 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+        res          = (res | (res << 2U)) & 0x3333333333333333ULL;
+        res          = (res | (res << 1U)) & 0x5555555555555555ULL;
+        return res;
+    }
+
     Coord2D m_max;
     Coord2D m_min;
 };
 
+/**
+ * \~english
+ * @brief Linearization of a range first by Y then by X
+ */
+/**
+ * \~russian
+ * @brief Линеаризация диапазона сначала по Y потом по X
+ */
+class LinearizationByY
+{
+  public:
+    static uint Index(const Range2D& range, const Coord2D& coord) { return range.CoordToLineByY(coord); }
+    static uint Count(const Range2D& range) { return range.Count(); }
+};
+
+/**
+ * \~english
+ * @brief Linearization of a range first by X then by Y
+ */
+/**
+ * \~russian
+ * @brief Линеаризация диапазона сначала по X потом по Y
+ */
+class LinearizationByX
+{
+  public:
+    static uint Index(const Range2D& range, const Coord2D& coord) { return range.CoordToLineByX(coord); }
+    static uint Count(const Range2D& range) { return range.Count(); }
+};
+
+/**
+ * \~english
+ * @brief Linearization of a range in Z-order
+ */
+/**
+ * \~russian
+ * @brief Линеаризация диапазона в Z-порядке
+ */
+class LinearizationMorton
+{
+  public:
+    static uint Index(const Range2D& range, const Coord2D& coord) { return range.CoordToLineMorton(coord); }
+    static uint Count(const Range2D& range) { return range.LineMortonCount(); }
+};
+
 std::string Id2Str(const Coord2D& id)
 {
     return id.ToStr();
 }
 
+/**
+ * \~english
+ * @brief Parse coordinates written by Coord2D::ToStr, e.g. "(3;-4)"
+ *
+ * @return true if the whole token is correct coordinates
+ */
+/**
+ * \~russian
+ * @brief Разобрать координаты, записанные Coord2D::ToStr, например "(3;-4)"
+ *
+ * @return true, если весь токен является корректными координатами
+ */
+inline bool Str2Id(std::string_view token, Coord2D& id)
+{
+    const auto separator = token.find(';');
+    if ((token.size() < 5) or (token.front() != '(') or (token.back() != ')') or (separator == std::string_view::npos))
+        return false;
+    int x = 0;
+    int y = 0;
+    const auto* x_end = token.data() + separator;
+    const auto* y_end = token.data() + token.size() - 1;
+    const auto res_x  = std::from_chars(token.data() + 1, x_end, x);
+    const auto res_y  = std::from_chars(x_end + 1, y_end, y);
+    if ((res_x.ec != std::errc()) or (res_x.ptr != x_end) or (res_y.ec != std::errc()) or (res_y.ptr != y_end))
+        return false;
+    id = Coord2D(x, y);
+    return true;
+}
+
+/**
+ * \~english
+ * @brief Offset from a cell to its neighbour
+ */
+/**
+ * \~russian
+ * @brief Смещение от клетки к её соседу
+ */
+struct Offset2D {
+    int dx = 0;
+    int dy = 0;
+};
+
+/**
+ * \~english
+ * @brief Call a function for every cell at an offset from a coordinate that lies inside a range
+ *
+ * Bounds are checked only for cells on the border of the range.
+ *
+ * @param coord coordinate
+ * @param range range
+ * @param offsets table of offsets, every offset must be within one cell
+ * @param func function taking neighbour coordinate
+ */
+/**
+ * \~russian
+ * @brief Вызвать функцию для каждой клетки со смещением от координаты, лежащей внутри диапазона
+ *
+ * Границы проверяются только для клеток на краю диапазона.
+ *
+ * @param coord координата
+ * @param range диапазон
+ * @param offsets таблица смещений, каждое смещение должно быть в пределах одной клетки
+ * @param func функция, принимающая координату соседа
+ */
+template <size_t Count, typename TFunc>
+void ForEachOffset(const Coord2D& coord, const Range2D& range, const std::array<Offset2D, Count>& offsets, TFunc func)
+{
+    const bool interior = (coord.X() > range.MinX()) and (coord.X() < range.MaxX()) and (coord.Y() > range.MinY()) and
+                          (coord.Y() < range.MaxY());
+    for (const auto& offset : offsets)
+    {
+        const Coord2D neighbour(coord.X() + offset.dx, coord.Y() + offset.dy);
+        if (interior or range.Contains(neighbour))
+            func(neighbour);
+    }
+}
+
 class NeighborhoodMoore
 {
   public:
+    static constexpr size_t MaxNeighbours = 8;
+    static constexpr std::array<Offset2D, MaxNeighbours> Offsets{
+        {{-1, -1}, {-1, +1}, {+1, -1}, {+1, +1}, {-1, 0}, {0, -1}, {+1, 0}, {0, +1}}
+    };
+
+    template <typename TFunc>
+    static void ForEachNeighbour(const Coord2D& coord, const Range2D& range, TFunc func)
+    {
+        ForEachOffset(coord, range, Offsets, func);
+    }
+
     static std::vector<Coord2D> NeighbourCoordinates(const Coord2D& coord, const Range2D& range)
     {
         std::vector<Coord2D> neighbours;
-        neighbours.reserve(8);
-        if ((coord.X() > range.MinX()) and (coord.Y() > range.MinY()))
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y() - 1));
-        if ((coord.X() > range.MinX()) and (coord.Y() < range.MaxY()))
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y() + 1));
-        if ((coord.X() < range.MaxX()) and (coord.Y() > range.MinY()))
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y() - 1));
-        if ((coord.X() < range.MaxX()) and (coord.Y() < range.MaxY()))
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y() + 1));
-        if (coord.X() > range.MinX())
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y()));
-        if (coord.Y() > range.MinY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() - 1));
-        if (coord.X() < range.MaxX())
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y()));
-        if (coord.Y() < range.MaxY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() + 1));
+        neighbours.reserve(Offsets.size());
+        ForEachNeighbour(coord, range, [&](const Coord2D& neighbour) { neighbours.push_back(neighbour); });
         return neighbours;
     }
 
-    static bool IsHex() { return false; }
+    static constexpr bool IsHex() { return false; }
 
   private:
 };
@@ -283,22 +477,26 @@ class NeighborhoodMoore
 class NeighborhoodVonNeumann
 {
   public:
+    static constexpr size_t MaxNeighbours = 4;
+    static constexpr std::array<Offset2D, MaxNeighbours> Offsets{
+        {{-1, 0}, {0, -1}, {+1, 0}, {0, +1}}
+    };
+
+    template <typename TFunc>
+    static void ForEachNeighbour(const Coord2D& coord, const Range2D& range, TFunc func)
+    {
+        ForEachOffset(coord, range, Offsets, func);
+    }
+
     static std::vector<Coord2D> NeighbourCoordinates(const Coord2D& coord, const Range2D& range)
     {
         std::vector<Coord2D> neighbours;
-        neighbours.reserve(4);
-        if (coord.X() > range.MinX())
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y()));
-        if (coord.Y() > range.MinY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() - 1));
-        if (coord.X() < range.MaxX())
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y()));
-        if (coord.Y() < range.MaxY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() + 1));
+        neighbours.reserve(Offsets.size());
+        ForEachNeighbour(coord, range, [&](const Coord2D& neighbour) { neighbours.push_back(neighbour); });
         return neighbours;
     }
 
-    static bool IsHex() { return false; }
+    static constexpr bool IsHex() { return false; }
 
   private:
 };
@@ -306,93 +504,544 @@ class NeighborhoodVonNeumann
 class NeighborhoodHex
 {
   public:
+    static constexpr size_t MaxNeighbours = 6;
+    static constexpr std::array<Offset2D, MaxNeighbours> OffsetsEven{
+        {{-1, -1}, {-1, +1}, {-1, 0}, {0, -1}, {+1, 0}, {0, +1}}
+    };
+    static constexpr std::array<Offset2D, MaxNeighbours> OffsetsOdd{
+        {{+1, -1}, {+1, +1}, {-1, 0}, {0, -1}, {+1, 0}, {0, +1}}
+    };
+
+    template <typename TFunc>
+    static void ForEachNeighbour(const Coord2D& coord, const Range2D& range, TFunc func)
+    {
+        // rows are told apart by the remainder of Y, rows with remainder -1 have no diagonal neighbours
+        switch (coord.Y() % 2)
+        {
+            case 0:
+                ForEachOffset(coord, range, OffsetsEven, func);
+                break;
+            case 1:
+                ForEachOffset(coord, range, OffsetsOdd, func);
+                break;
+            default:
+                ForEachOffset(coord, range, NeighborhoodVonNeumann::Offsets, func);
+                break;
+        }
+    }
+
     static std::vector<Coord2D> NeighbourCoordinates(const Coord2D& coord, const Range2D& range)
     {
         std::vector<Coord2D> neighbours;
-        neighbours.reserve(8);
-        if (((coord.Y() % 2) == 0) and (coord.X() > range.MinX()) and (coord.Y() > range.MinY()))
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y() - 1));
-        if (((coord.Y() % 2) == 0) and (coord.X() > range.MinX()) and (coord.Y() < range.MaxY()))
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y() + 1));
-        if (((coord.Y() % 2) == 1) and (coord.X() < range.MaxX()) and (coord.Y() > range.MinY()))
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y() - 1));
-        if (((coord.Y() % 2) == 1) and (coord.X() < range.MaxX()) and (coord.Y() < range.MaxY()))
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y() + 1));
-        if (coord.X() > range.MinX())
-            neighbours.push_back(Coord2D(coord.X() - 1, coord.Y()));
-        if (coord.Y() > range.MinY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() - 1));
-        if (coord.X() < range.MaxX())
-            neighbours.push_back(Coord2D(coord.X() + 1, coord.Y()));
-        if (coord.Y() < range.MaxY())
-            neighbours.push_back(Coord2D(coord.X(), coord.Y() + 1));
+        neighbours.reserve(OffsetsEven.size());
+        ForEachNeighbour(coord, range, [&](const Coord2D& neighbour) { neighbours.push_back(neighbour); });
         return neighbours;
     }
 
-    static bool IsHex() { return true; }
+    static constexpr bool IsHex() { return true; }
 
   private:
 };
 
-template <typename TNode, typename TNeighborhood,
-          typename TConnectedComponentWatch = ConnectedComponentWatch<TNode, Edge<TNode>, false>>
-class Area2D
+/**
+ * \~english
+ * @brief Node of an area graph keeping all edges of its neighborhood inside itself, with no separate allocation
+ *
+ * @tparam TNeighborhood neighborhood type
+ */
+/**
+ * \~russian
+ * @brief Вершина графа области, хранящая все рёбра своей окрестности внутри себя, без отдельного выделения памяти
+ *
+ * @tparam TNeighborhood тип окрестности
+ */
+template <typename TNeighborhood>
+using AreaNode2D = Node<Coord2D, false, TNeighborhood::MaxNeighbours>;
+
+/**
+ * \~english
+ * @brief Bit map over a 2D range, every row is packed into 64-bit words
+ *
+ * Bulk operations work on whole words, so they process 64 cells per instruction and are easily vectorized.
+ */
+/**
+ * \~russian
+ * @brief Битовая карта над 2D диапазоном, каждая строка упакована в 64-битные слова
+ *
+ * Групповые операции работают с целыми словами, поэтому обрабатывают 64 клетки за инструкцию и легко векторизуются.
+ */
+class BitMap2D
 {
   public:
-    Area2D() = default;
+    using Word_t                   = uint64_t;
+    static constexpr int WordBits  = 64;
+    static constexpr Word_t AllSet = ~Word_t{0};
+
+    explicit BitMap2D(const Range2D& range)
+        : m_range(range),
+          m_width(range.MaxX() - range.MinX() + 1),
+          m_height(range.MaxY() - range.MinY() + 1),
+          m_row_words((m_width + WordBits - 1) / WordBits),
+          m_words(m_row_words * m_height, 0)
+    {}
+
+    const Range2D& Range() const { return m_range; }
+
+    bool Get(const Coord2D& coord) const
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        const int x = coord.X() - m_range.MinX();
+        return ((Row(coord.Y())[x / WordBits] >> (x % WordBits)) & 1U) != 0;
+    }
+
+    void Set(const Coord2D& coord, bool value)
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        const int x       = coord.X() - m_range.MinX();
+        Word_t& word      = Row(coord.Y())[x / WordBits];
+        const Word_t mask = Word_t{1} << (x % WordBits);
+        word              = value ? (word | mask) : (word & ~mask);
+    }
+
+    /**
+     * \~english
+     * @brief Set all cells
+     *
+     * @param value cell value
+     */
+    /**
+     * \~russian
+     * @brief Установить все клетки
+     *
+     * @param value значение клетки
+     */
+    void SetAll(bool value) { SetRect(m_range, value); }
+
+    /**
+     * \~english
+     * @brief Set all cells of a rectangle
+     *
+     * @param rect rectangle, must lie inside the map range
+     * @param value cell value
+     */
+    /**
+     * \~russian
+     * @brief Установить все клетки прямоугольника
+     *
+     * @param rect прямоугольник, должен лежать внутри диапазона карты
+     * @param value значение клетки
+     */
+    void SetRect(const Range2D& rect, bool value)
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(Coord2D(rect.MinX(), rect.MinY())), "Wrong rectangle");
+        GRAPH_DEBUG_ASSERT(m_range.Contains(Coord2D(rect.MaxX(), rect.MaxY())), "Wrong rectangle");
+        const int x_begin = rect.MinX() - m_range.MinX();
+        const int x_end   = rect.MaxX() - m_range.MinX() + 1;
+        for (int y = rect.MinY(); y <= rect.MaxY(); ++y)
+        {
+            Word_t* row = Row(y);
+            for (int w = x_begin / WordBits; w * WordBits < x_end; ++w)
+            {
+                const Word_t mask = RangeMask(x_begin - w * WordBits, x_end - w * WordBits);
+                row[w]            = value ? (row[w] | mask) : (row[w] & ~mask);
+            }
+        }
+    }
+
+    /**
+     * \~english
+     * @brief Get count of set cells
+     *
+     * @return count of set cells
+     */
+    /**
+     * \~russian
+     * @brief Получить количество установленных клеток
+     *
+     * @return количество установленных клеток
+     */
+    uint Count() const
+    {
+        uint count = 0;
+        for (const auto word : m_words)
+            count += std::popcount(word);
+        return count;
+    }
+
+    /**
+     * \~english
+     * @brief Get count of cells that differ from another map of the same range
+     *
+     * @param other other map
+     * @return count of different cells
+     */
+    /**
+     * \~russian
+     * @brief Получить количество клеток, отличающихся от другой карты того же диапазона
+     *
+     * @param other другая карта
+     * @return количество отличающихся клеток
+     */
+    uint CountDifferent(const BitMap2D& other) const
+    {
+        GRAPH_DEBUG_ASSERT(m_words.size() == other.m_words.size(), "Different ranges");
+        uint count = 0;
+        for (size_t w = 0; w < m_words.size(); ++w)
+            count += std::popcount(m_words[w] ^ other.m_words[w]);
+        return count;
+    }
+
+    bool operator==(const BitMap2D& rhs) const { return (m_words == rhs.m_words); }
+    bool operator!=(const BitMap2D& rhs) const { return !(*this == rhs); }
+
+    BitMap2D& operator&=(const BitMap2D& rhs)
+    {
+        GRAPH_DEBUG_ASSERT(m_words.size() == rhs.m_words.size(), "Different ranges");
+        for (size_t w = 0; w < m_words.size(); ++w)
+            m_words[w] &= rhs.m_words[w];
+        return *this;
+    }
 
-    explicit Area2D(const Range2D& range) : m_range(range)
+    BitMap2D& operator|=(const BitMap2D& rhs)
     {
-        m_map.resize(m_range.Count());
-        for (auto& pnt : m_map)
-            pnt = 0;
+        GRAPH_DEBUG_ASSERT(m_words.size() == rhs.m_words.size(), "Different ranges");
+        for (size_t w = 0; w < m_words.size(); ++w)
+            m_words[w] |= rhs.m_words[w];
+        return *this;
     }
 
-    explicit Area2D(Range2D&& range) : m_range(range)
+    /**
+     * \~english
+     * @brief Clear cells that are set in another map
+     *
+     * @param rhs other map
+     * @return this map
+     */
+    /**
+     * \~russian
+     * @brief Сбросить клетки, установленные в другой карте
+     *
+     * @param rhs другая карта
+     * @return эта карта
+     */
+    BitMap2D& AndNot(const BitMap2D& rhs)
+    {
+        GRAPH_DEBUG_ASSERT(m_words.size() == rhs.m_words.size(), "Different ranges");
+        for (size_t w = 0; w < m_words.size(); ++w)
+            m_words[w] &= ~rhs.m_words[w];
+        return *this;
+    }
+
+    BitMap2D Inverted() const
     {
-        m_map.resize(m_range.Count());
-        for (auto& pnt : m_map)
-            pnt = 0;
+        BitMap2D res(m_range);
+        for (size_t w = 0; w < m_words.size(); ++w)
+            res.m_words[w] = ~m_words[w];
+        res.ClearPadding();
+        return res;
     }
 
-    void SetPassableAll(bool passable)
+    /**
+     * \~english
+     * @brief Get map of set cells and their neighbours
+     *
+     * @tparam TNeighborhood neighborhood type
+     * @return dilated map
+     */
+    /**
+     * \~russian
+     * @brief Получить карту установленных клеток и их соседей
+     *
+     * @tparam TNeighborhood тип окрестности
+     * @return расширенная карта
+     */
+    template <typename TNeighborhood>
+    BitMap2D Dilated() const
     {
+        BitMap2D res(m_range);
+        std::vector<Word_t> shifted(m_row_words);
         for (int y = m_range.MinY(); y <= m_range.MaxY(); ++y)
         {
-            for (int x = m_range.MinX(); x <= m_range.MaxX(); ++x)
+            const Word_t* row = Row(y);
+            Word_t* res_row   = res.Row(y);
+            for (int w = 0; w < m_row_words; ++w)
+                res_row[w] |= row[w] | ShiftedUp(row, w) | ShiftedDown(row, w);
+            for (const int y2 : {y - 1, y + 1})
+            {
+                if ((y2 < m_range.MinY()) or (y2 > m_range.MaxY()))
+                    continue;
+                const Word_t* row2 = Row(y2);
+                for (int w = 0; w < m_row_words; ++w)
+                {
+                    Word_t word = row2[w];
+                    if constexpr (TNeighborhood::IsHex())
+                    {
+                        if ((y2 % 2) == 0)
+                            word |= ShiftedDown(row2, w);
+                        else if ((y2 % 2) == 1)
+                            word |= ShiftedUp(row2, w);
+                    }
+                    else if constexpr (std::is_same_v<TNeighborhood, NeighborhoodMoore>)
+                    {
+                        word |= ShiftedUp(row2, w) | ShiftedDown(row2, w);
+                    }
+                    res_row[w] |= word;
+                }
+            }
+        }
+        res.ClearPadding();
+        return res;
+    }
+
+    /**
+     * \~english
+     * @brief Get map of cleared cells that have a set neighbour
+     *
+     * @tparam TNeighborhood neighborhood type
+     * @return perimeter map
+     */
+    /**
+     * \~russian
+     * @brief Получить карту сброшенных клеток, у которых есть установленный сосед
+     *
+     * @tparam TNeighborhood тип окрестности
+     * @return карта периметра
+     */
+    template <typename TNeighborhood>
+    BitMap2D Perimeter() const
+    {
+        auto res = Dilated<TNeighborhood>();
+        res.AndNot(*this);
+        return res;
+    }
+
+    /**
+     * \~english
+     * @brief Get map of set cells that have a cleared neighbour
+     *
+     * @tparam TNeighborhood neighborhood type
+     * @return boundary map
+     */
+    /**
+     * \~russian
+     * @brief Получить карту установленных клеток, у которых есть сброшенный сосед
+     *
+     * @tparam TNeighborhood тип окрестности
+     * @return карта границы
+     */
+    template <typename TNeighborhood>
+    BitMap2D Boundary() const
+    {
+        auto res = Inverted().Dilated<TNeighborhood>();
+        res &= *this;
+        return res;
+    }
+
+    /**
+     * \~english
+     * @brief Call a function for every set cell, row by row
+     *
+     * Empty words are skipped, so sparse maps are traversed in time proportional to the count of words plus set cells.
+     *
+     * @param func function taking cell coordinate
+     */
+    /**
+     * \~russian
+     * @brief Вызвать функцию для каждой установленной клетки, строка за строкой
+     *
+     * Пустые слова пропускаются, поэтому разреженные карты обходятся за время, пропорциональное количеству слов плюс
+     * установленных клеток.
+     *
+     * @param func функция, принимающая координату клетки
+     */
+    template <typename TFunc>
+    void ForEachSet(TFunc func) const
+    {
+        for (int y = m_range.MinY(); y <= m_range.MaxY(); ++y)
+        {
+            const Word_t* row = Row(y);
+            for (int w = 0; w < m_row_words; ++w)
             {
-                SetPassable(Coord2D(x, y), passable);
+                for (Word_t word = row[w]; word != 0; word &= word - 1)
+                    func(Coord2D(m_range.MinX() + w * WordBits + std::countr_zero(word), y));
             }
         }
     }
 
-    bool Passable(const Coord2D& coord) const { return (m_map[m_range.CoordToLineByY(coord)] == 1); }
+  private:
+    Word_t* Row(int y) { return m_words.data() + static_cast<size_t>(y - m_range.MinY()) * m_row_words; }
+    const Word_t* Row(int y) const { return m_words.data() + static_cast<size_t>(y - m_range.MinY()) * m_row_words; }
+
+    /**
+     * @brief Get word of a row shifted by one cell towards greater X
+     */
+    Word_t ShiftedUp(const Word_t* row, int w) const
+    {
+        return (row[w] << 1U) | ((w > 0) ? (row[w - 1] >> (WordBits - 1)) : 0);
+    }
+
+    /**
+     * @brief Get word of a row shifted by one cell towards lesser X
+     */
+    Word_t ShiftedDown(const Word_t* row, int w) const
+    {
+        return (row[w] >> 1U) | ((w + 1 < m_row_words) ? (row[w + 1] << (WordBits - 1)) : 0);
+    }
+
+    /**
+     * @brief Get word mask of bits in [begin, end) clamped to the word
+     */
+    static Word_t RangeMask(int begin, int end)
+    {
+        begin = std::max(begin, 0);
+        end   = std::min(end, WordBits);
+        if (begin >= end)
+            return 0;
+        const Word_t high = (end == WordBits) ? AllSet : ((Word_t{1} << end) - 1);
+        return high & (AllSet << begin);
+    }
+
+    void ClearPadding()
+    {
+        const Word_t mask = RangeMask(0, m_width - (m_row_words - 1) * WordBits);
+        for (int y = 0; y < m_height; ++y)
+            m_words[(y + 1) * m_row_words - 1] &= mask;
+    }
+
+    Range2D m_range;
+    int m_width     = 0;
+    int m_height    = 0;
+    int m_row_words = 0;
+    std::vector<Word_t> m_words;
+};
+
+template <typename TNode, typename TNeighborhood,
+          typename TConnectedComponentWatch = ConnectedComponentWatch<TNode, Edge<TNode>, false>>
+class Area2D
+{
+  public:
+    Area2D() = default;
+
+    explicit Area2D(const Range2D& range) : m_range(range), m_map(m_range) {}
+
+    explicit Area2D(Range2D&& range) : m_range(range), m_map(m_range) {}
+
+    void SetPassableAll(bool passable) { SetPassableRegion(m_range, passable); }
+
+    /**
+     * \~english
+     * @brief Set passability of all cells of a rectangle with one graph update
+     *
+     * @param rect rectangle, must lie inside the area range
+     * @param passable passability
+     */
+    /**
+     * \~russian
+     * @brief Установить проходимость всех клеток прямоугольника одним изменением графа
+     *
+     * @param rect прямоугольник, должен лежать внутри диапазона области
+     * @param passable проходимость
+     */
+    void SetPassableRegion(const Range2D& rect, bool passable)
+    {
+        BitMap2D map = m_map;
+        map.SetRect(rect, passable);
+        SetMap(map);
+    }
+
+    /**
+     * \~english
+     * @brief Set passability of all cells set in a mask with one graph update
+     *
+     * @param mask mask over the area range
+     * @param passable passability
+     */
+    /**
+     * \~russian
+     * @brief Установить проходимость всех клеток, установленных в маске, одним изменением графа
+     *
+     * @param mask маска над диапазоном области
+     * @param passable проходимость
+     */
+    void ApplyMask(const BitMap2D& mask, bool passable)
+    {
+        BitMap2D map = m_map;
+        if (passable)
+            map |= mask;
+        else
+            map.AndNot(mask);
+        SetMap(map);
+    }
+
+    /**
+     * \~english
+     * @brief Replace the passability map with one graph update
+     *
+     * Only cells that differ from the current map are touched. Connected components are not tracked during the update
+     * and are recomputed once at its end.
+     *
+     * @param map new map over the area range
+     */
+    /**
+     * \~russian
+     * @brief Заменить карту проходимости одним изменением графа
+     *
+     * Затрагиваются только клетки, отличающиеся от текущей карты. Компоненты связности не отслеживаются во время
+     * изменения и однократно пересчитываются в его конце.
+     *
+     * @param map новая карта над диапазоном области
+     */
+    void SetMap(const BitMap2D& map)
+    {
+        GRAPH_DEBUG_ASSERT(map.Range() == m_range, "Wrong map range");
+        if (map == m_map)
+            return;
+        BitMap2D removed = m_map;
+        removed.AndNot(map);
+        BitMap2D added = map;
+        added.AndNot(m_map);
+
+        m_graph.BeginBulkUpdate();
+        removed.ForEachSet([&](const Coord2D& coord) { m_graph.Del(m_graph.Find(coord)); });
+        m_map = map;
+        added.ForEachSet([&](const Coord2D& coord) {
+            auto node = m_graph.MakeNode(coord);
+            TNeighborhood::ForEachNeighbour(coord, m_range, [&](const Coord2D& neighbour) {
+                if (not m_map.Get(neighbour))
+                    return;
+                auto node2 = m_graph.Find(neighbour);
+                if (node2 != nullptr)
+                    m_graph.MakeEdge(node, node2);
+            });
+        });
+        m_graph.EndBulkUpdate();
+        GRAPH_DEBUG_ASSERT(m_graph.CheckCorrect(), "Incorrect graph");
+    }
+
+    bool Passable(const Coord2D& coord) const { return m_map.Get(coord); }
 
     void SetPassable(const Coord2D& coord, bool passable)
     {
         GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
         if (passable)
         {
-            if (m_map[m_range.CoordToLineByY(coord)] != 0)
+            if (m_map.Get(coord))
                 return;
-            m_map[m_range.CoordToLineByY(coord)] = 1;
-            auto node                            = m_graph.MakeNode(coord);
-
-            const auto neighbours = TNeighborhood::NeighbourCoordinates(coord, m_range);
-            for (auto const& neighbour : neighbours)
-            {
-                if (m_map[m_range.CoordToLineByY(neighbour)] == 0)
-                    continue;
+            m_map.Set(coord, true);
+            auto node = m_graph.MakeNode(coord);
+            TNeighborhood::ForEachNeighbour(coord, m_range, [&](const Coord2D& neighbour) {
+                if (not m_map.Get(neighbour))
+                    return;
                 auto node2 = m_graph.Find(neighbour);
                 m_graph.MakeEdge(node, node2);
-            }
+            });
         }
         else
         {
-            if (m_map[m_range.CoordToLineByY(coord)] == 0)
+            if (not m_map.Get(coord))
                 return;
-            m_map[m_range.CoordToLineByY(coord)] = 0;
-            auto node                            = m_graph.Find(coord);
+            m_map.Set(coord, false);
+            auto node = m_graph.Find(coord);
             m_graph.Del(node);
         }
         GRAPH_DEBUG_ASSERT(m_graph.CheckCorrect(), "Incorrect graph");
@@ -413,7 +1062,7 @@ class Area2D
         {
             for (int x = m_range.MinX(); x <= m_range.MaxX(); ++x)
             {
-                if (m_map[m_range.CoordToLineByY(Coord2D(x, y))] == 0)
+                if (not m_map.Get(Coord2D(x, y)))
                 {
                     str += R"GG(  \node[fill=black] at ()GG";
                     str += std::to_string(static_cast<float>(x - m_range.MinX()) - 0.5);
@@ -453,7 +1102,7 @@ class Area2D
                             TConnectedComponentWatch, Named<false>>* path_find_context = nullptr) const
     {
         std::string res;
-        res.reserve(m_map.size() + m_range.MaxY() + 1);
+        res.reserve(m_range.Count() + m_range.MaxY() + 1);
         res += "┌";
         for (int x = m_range.MinX(); x <= m_range.MaxX(); ++x)
             res += "──";
@@ -467,7 +1116,7 @@ class Area2D
                 res += " ";
             for (int x = m_range.MinX(); x <= m_range.MaxX(); ++x)
             {
-                if (m_map[m_range.CoordToLineByY(Coord2D(x, y))] == 0)
+                if (not m_map.Get(Coord2D(x, y)))
                 {
                     res += "██";
                 }
@@ -501,10 +1150,12 @@ class Area2D
     }
 
     const auto& Graph() const { return m_graph; }
+    const Range2D& Range() const { return m_range; }
+    const BitMap2D& Map() const { return m_map; }
 
   private:
     Range2D m_range;
-    std::vector<int> m_map;
+    BitMap2D m_map;
     GraphInclusive<TNode, Edge<TNode>, Directed<Edge<TNode>, false>, Weighted<Edge<TNode>, false>,
                    TConnectedComponentWatch, Named<false>>
         m_graph;
@@ -517,10 +1168,10 @@ template <>
 struct hash<GG::Coord2D> {
     std::size_t operator()(const GG::Coord2D& coord) const
     {
-        std::size_t result = 0;
-        result ^= std::hash<int>()(coord.X());
-        result ^= std::hash<int>()(coord.Y());
-        return result;
+        // both coordinates are packed into one word, so distinct coordinates never collide before mixing
+        const uint64_t packed =
+            (static_cast<uint64_t>(static_cast<uint32_t>(coord.X())) << 32U) | static_cast<uint32_t>(coord.Y());
+        return GG::MixHash(packed);
     }
 };
 }  // namespace std
\ No newline at end of file
@@ -0,0 +1,343 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+#include "./area.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief 2D area split into square chunks that are materialized lazily
+ *
+ * Cells of a chunk that was never changed have the default passability and take no memory. A chunk gets its bit map
+ * when a cell in it is first changed, and gets its nodes and edges in the graph when it is first reached by a
+ * search. Edges to neighbouring chunks are stitched when the later of the two chunks is materialized. Graphs of least
+ * recently used chunks are evicted when their count exceeds the budget, their bit maps are kept unless they are
+ * uniform with the default passability.
+ *
+ * Connectivity watched by the graph covers materialized chunks only.
+ *
+ * @tparam TNode node type
+ * @tparam TNeighborhood neighborhood type
+ * @tparam TConnectedComponentWatch connected component watch type
+ */
+/**
+ * \~russian
+ * @brief 2D область, разбитая на квадратные куски, которые материализуются лениво
+ *
+ * Клетки куска, который ни разу не изменялся, имеют проходимость по умолчанию и не занимают памяти. Кусок получает
+ * битовую карту при первом изменении клетки в нём, а вершины и рёбра в графе при первом достижении поиском. Рёбра к
+ * соседним кускам сшиваются при материализации более позднего из двух кусков. Графы давно не использованных кусков
+ * вытесняются, когда их количество превышает бюджет, их битовые карты сохраняются, если они не совпадают с
+ * проходимостью по умолчанию.
+ *
+ * Связность, отслеживаемая графом, охватывает только материализованные куски.
+ *
+ * @tparam TNode тип вершины
+ * @tparam TNeighborhood тип окрестности
+ * @tparam TConnectedComponentWatch тип отслеживания компонент связности
+ */
+template <typename TNode, typename TNeighborhood,
+          typename TConnectedComponentWatch = ConnectedComponentWatch<TNode, Edge<TNode>, false>>
+class AreaChunked2D
+{
+  public:
+    using Graph_t = GraphInclusive<TNode, Edge<TNode>, Directed<Edge<TNode>, false>, Weighted<Edge<TNode>, false>,
+                                   TConnectedComponentWatch, Named<false>>;
+    static constexpr int ChunkSideDefault = 64;
+    // a search touches a chunk and up to eight chunks around it at once
+    static constexpr size_t ChunksBudgetMin = 9;
+
+    /**
+     * \~english
+     * @brief Constructor for AreaChunked2D object
+     *
+     * @param range area range
+     * @param passable_default passability of cells that were never changed
+     * @param chunks_budget maximum count of chunks with materialized graph, 0 for unlimited
+     * @param chunk_side chunk side in cells
+     */
+    /**
+     * \~russian
+     * @brief Конструктор объекта AreaChunked2D
+     *
+     * @param range диапазон области
+     * @param passable_default проходимость клеток, которые ни разу не изменялись
+     * @param chunks_budget максимальное количество кусков с материализованным графом, 0 без ограничения
+     * @param chunk_side сторона куска в клетках
+     */
+    AreaChunked2D(const Range2D& range, bool passable_default, size_t chunks_budget = 0,
+                  int chunk_side = ChunkSideDefault)
+        : m_range(range),
+          m_passable_default(passable_default),
+          m_chunks_budget(chunks_budget),
+          m_chunk_side(chunk_side),
+          m_chunks_x((range.MaxX() - range.MinX() + chunk_side) / chunk_side)
+    {
+        GRAPH_DEBUG_ASSERT(m_chunk_side > 0, "Wrong chunk side");
+        GRAPH_DEBUG_ASSERT((m_chunks_budget == 0) or (m_chunks_budget >= ChunksBudgetMin), "Too small chunks budget");
+    }
+
+    AreaChunked2D(const AreaChunked2D&)            = delete;
+    AreaChunked2D& operator=(const AreaChunked2D&) = delete;
+
+    const Range2D& Range() const { return m_range; }
+    const Graph_t& Graph() const { return m_graph; }
+
+    bool Passable(const Coord2D& coord) const
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        const auto chunk_it = m_chunks.find(ChunkIndex(coord));
+        if ((chunk_it == m_chunks.end()) or not chunk_it->second.map.has_value())
+            return m_passable_default;
+        return chunk_it->second.map->Get(coord);
+    }
+
+    /**
+     * \~english
+     * @brief Set passability of a cell, the graph is updated only if the chunk of the cell is materialized
+     *
+     * @param coord cell coordinate
+     * @param passable passability
+     */
+    /**
+     * \~russian
+     * @brief Установить проходимость клетки, граф изменяется, только если кусок клетки материализован
+     *
+     * @param coord координата клетки
+     * @param passable проходимость
+     */
+    void SetPassable(const Coord2D& coord, bool passable)
+    {
+        if (Passable(coord) == passable)
+            return;
+        auto& chunk = m_chunks[ChunkIndex(coord)];
+        if (not chunk.map.has_value())
+        {
+            chunk.map.emplace(ChunkRange(ChunkIndex(coord)));
+            chunk.map->SetAll(m_passable_default);
+        }
+        chunk.map->Set(coord, passable);
+        if (not chunk.materialized)
+            return;
+        if (passable)
+            MakeNode(coord);
+        else
+            m_graph.Del(m_graph.Find(coord));
+        GRAPH_DEBUG_ASSERT(m_graph.CheckCorrect(), "Incorrect graph");
+    }
+
+    /**
+     * \~english
+     * @brief Get node of a cell, materializing its chunk and the chunks around the cell
+     *
+     * Pointers to nodes of evicted chunks become invalid, so node pointers must not be kept across calls.
+     *
+     * @param coord cell coordinate
+     * @return node or nullptr for impassable cell
+     */
+    /**
+     * \~russian
+     * @brief Получить вершину клетки, материализуя её кусок и куски вокруг клетки
+     *
+     * Указатели на вершины вытесненных кусков становятся недействительными, поэтому указатели на вершины нельзя
+     * сохранять между вызовами.
+     *
+     * @param coord координата клетки
+     * @return вершина или nullptr для непроходимой клетки
+     */
+    TNode* MaterializedNode(const Coord2D& coord)
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        const int x_in_chunk = (coord.X() - m_range.MinX()) % m_chunk_side;
+        const int y_in_chunk = (coord.Y() - m_range.MinY()) % m_chunk_side;
+        if ((x_in_chunk == 0) or (y_in_chunk == 0) or (x_in_chunk == m_chunk_side - 1) or
+            (y_in_chunk == m_chunk_side - 1))
+        {
+            TNeighborhood::ForEachNeighbour(coord, m_range,
+                                            [&](const Coord2D& neighbour) { Touch(ChunkIndex(neighbour)); });
+        }
+        Touch(ChunkIndex(coord));
+        Trim();
+        return m_graph.Find(coord);
+    }
+
+    /**
+     * \~english
+     * @brief Evict graphs of least recently used chunks down to the budget
+     */
+    /**
+     * \~russian
+     * @brief Вытеснить графы давно не использованных кусков до бюджета
+     */
+    void Trim()
+    {
+        if (m_chunks_budget == 0)
+            return;
+        while (m_lru.size() > m_chunks_budget)
+        {
+            Evict(m_lru.back());
+        }
+    }
+
+    size_t MaterializedChunksCount() const { return m_lru.size(); }
+
+    size_t StoredChunksCount() const
+    {
+        size_t count = 0;
+        for (const auto& chunk_el : m_chunks)
+        {
+            if (chunk_el.second.map.has_value())
+                ++count;
+        }
+        return count;
+    }
+
+  private:
+    struct Chunk {
+        // nullopt - all cells have the default passability
+        std::optional<BitMap2D> map;
+        bool materialized = false;
+        std::list<uint64_t>::iterator lru_it;
+    };
+
+    uint64_t ChunkIndex(const Coord2D& coord) const
+    {
+        const uint64_t chunk_x = (coord.X() - m_range.MinX()) / m_chunk_side;
+        const uint64_t chunk_y = (coord.Y() - m_range.MinY()) / m_chunk_side;
+        return chunk_y * m_chunks_x + chunk_x;
+    }
+
+    Range2D ChunkRange(uint64_t chunk_index) const
+    {
+        const int min_x = m_range.MinX() + static_cast<int>(chunk_index % m_chunks_x) * m_chunk_side;
+        const int min_y = m_range.MinY() + static_cast<int>(chunk_index / m_chunks_x) * m_chunk_side;
+        return Range2D(Coord2D(std::min(min_x + m_chunk_side - 1, m_range.MaxX()),
+                               std::min(min_y + m_chunk_side - 1, m_range.MaxY())),
+                       Coord2D(min_x, min_y));
+    }
+
+    /**
+     * @brief Make node of a passable cell and link it with nodes of materialized neighbours
+     */
+    TNode* MakeNode(const Coord2D& coord)
+    {
+        auto node = m_graph.MakeNode(coord);
+        TNeighborhood::ForEachNeighbour(coord, m_range, [&](const Coord2D& neighbour) {
+            auto node2 = m_graph.Find(neighbour);
+            if (node2 != nullptr)
+                m_graph.MakeEdge(node, node2);
+        });
+        return node;
+    }
+
+    /**
+     * @brief Materialize a chunk if needed and mark it as most recently used
+     */
+    void Touch(uint64_t chunk_index)
+    {
+        auto& chunk = m_chunks[chunk_index];
+        if (chunk.materialized)
+        {
+            m_lru.splice(m_lru.begin(), m_lru, chunk.lru_it);
+            return;
+        }
+        chunk.materialized = true;
+        m_lru.push_front(chunk_index);
+        chunk.lru_it           = m_lru.begin();
+        const auto chunk_range = ChunkRange(chunk_index);
+        for (int y = chunk_range.MinY(); y <= chunk_range.MaxY(); ++y)
+        {
+            for (int x = chunk_range.MinX(); x <= chunk_range.MaxX(); ++x)
+            {
+                const Coord2D coord(x, y);
+                if (chunk.map.has_value() ? chunk.map->Get(coord) : m_passable_default)
+                    MakeNode(coord);
+            }
+        }
+    }
+
+    /**
+     * @brief Delete nodes of a chunk from the graph and drop its map if it holds no information
+     */
+    void Evict(uint64_t chunk_index)
+    {
+        const auto chunk_it = m_chunks.find(chunk_index);
+        GRAPH_DEBUG_ASSERT(chunk_it != m_chunks.end(), "No chunk");
+        auto& chunk = chunk_it->second;
+        GRAPH_DEBUG_ASSERT(chunk.materialized, "Chunk is not materialized");
+        const auto chunk_range = ChunkRange(chunk_index);
+        for (int y = chunk_range.MinY(); y <= chunk_range.MaxY(); ++y)
+        {
+            for (int x = chunk_range.MinX(); x <= chunk_range.MaxX(); ++x)
+            {
+                auto node = m_graph.Find(Coord2D(x, y));
+                if (node != nullptr)
+                    m_graph.Del(node);
+            }
+        }
+        m_lru.erase(chunk.lru_it);
+        chunk.materialized = false;
+        if (chunk.map.has_value() and (chunk.map->Count() == (m_passable_default ? chunk_range.Count() : 0)))
+            chunk.map.reset();
+        if (not chunk.map.has_value())
+            m_chunks.erase(chunk_it);
+    }
+
+    Range2D m_range;
+    bool m_passable_default = false;
+    size_t m_chunks_budget  = 0;
+    int m_chunk_side        = ChunkSideDefault;
+    uint64_t m_chunks_x     = 0;
+    std::unordered_map<uint64_t, Chunk> m_chunks;
+    // materialized chunks, most recently used first
+    std::list<uint64_t> m_lru;
+    Graph_t m_graph;
+};
+
+/**
+ * \~english
+ * @brief Adjacency provider over a chunked area, materializes chunks as a search reaches them
+ *
+ * Nodes are identified by coordinates, so they stay valid when chunks are evicted during a search.
+ *
+ * @tparam TArea chunked area type
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности над областью из кусков, материализует куски по мере их достижения поиском
+ *
+ * Вершины идентифицируются координатами, поэтому остаются действительными при вытеснении кусков во время поиска.
+ *
+ * @tparam TArea тип области из кусков
+ */
+template <typename TArea>
+class AreaChunkedAdjacency
+{
+  public:
+    using NodeHandle_t = Coord2D;
+
+    explicit AreaChunkedAdjacency(TArea* area) : m_area(area) { GRAPH_DEBUG_ASSERT(m_area != nullptr, "Null area"); }
+
+    template <typename TFunc>
+    void ForEachNeighbour(const Coord2D& coord, TFunc func) const
+    {
+        const auto node = m_area->MaterializedNode(coord);
+        if (node == nullptr)
+            return;
+        for (const auto edge : node->Edges())
+            func(edge->OtherNode(node)->Id());
+    }
+
+  private:
+    TArea* m_area = nullptr;
+};
+
+}  // namespace GG
@@ -0,0 +1,455 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <variant>
+#include <vector>
+
+#include "./algorithms.h"
+#include "./area.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief 2D area without materialized graph
+ *
+ * Only the passability map is stored. Neighbours are generated on the fly from coordinates by the neighborhood
+ * policy, so path finding and connectivity run directly on the map. Component labels take the narrowest of 1, 2 or 4
+ * bytes per cell that fits the count of components. A single cell edit updates them in place unless it may merge or
+ * split components, then they are relabeled on the next query.
+ *
+ * @tparam TNeighborhood neighborhood type
+ * @tparam TLinearization linearization of per-cell arrays
+ */
+/**
+ * \~russian
+ * @brief 2D область без материализованного графа
+ *
+ * Хранится только карта проходимости. Соседи порождаются на лету из координат политикой окрестности, поэтому поиск
+ * пути и связность работают непосредственно по карте. Метки компонент занимают наименьшее из 1, 2 или 4 байт на
+ * клетку, вмещающее количество компонент. Изменение одной клетки обновляет их на месте, если только оно не может
+ * объединить или разделить компоненты, тогда они переразмечаются при следующем запросе.
+ *
+ * @tparam TNeighborhood тип окрестности
+ * @tparam TLinearization линеаризация массивов по клеткам
+ */
+template <typename TNeighborhood, typename TLinearization = LinearizationByY>
+class AreaImplicit2D
+{
+  public:
+    static constexpr int ComponentIdNone = LabelNone;
+    using Neighborhood_t                 = TNeighborhood;
+    using Linearization_t                = TLinearization;
+    using NodeHandle_t                   = Coord2D;
+
+    explicit AreaImplicit2D(const Range2D& range) : m_range(range), m_map(m_range) {}
+
+    const Range2D& Range() const { return m_range; }
+    const BitMap2D& Map() const { return m_map; }
+
+    bool Passable(const Coord2D& coord) const { return m_map.Get(coord); }
+
+    void SetPassable(const Coord2D& coord, bool passable)
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        if (m_map.Get(coord) == passable)
+            return;
+        m_map.Set(coord, passable);
+        if (not m_dirty)
+            UpdateComponents(coord, passable);
+    }
+
+    void SetPassableAll(bool passable)
+    {
+        m_map.SetAll(passable);
+        m_dirty = true;
+    }
+
+    void SetPassableRegion(const Range2D& rect, bool passable)
+    {
+        m_map.SetRect(rect, passable);
+        m_dirty = true;
+    }
+
+    void ApplyMask(const BitMap2D& mask, bool passable)
+    {
+        if (passable)
+            m_map |= mask;
+        else
+            m_map.AndNot(mask);
+        m_dirty = true;
+    }
+
+    /**
+     * \~english
+     * @brief Call a function for every passable neighbour of a coordinate
+     *
+     * @param coord coordinate
+     * @param func function taking neighbour coordinate
+     */
+    /**
+     * \~russian
+     * @brief Вызвать функцию для каждого проходимого соседа координаты
+     *
+     * @param coord координата
+     * @param func функция, принимающая координату соседа
+     */
+    template <typename TFunc>
+    void ForEachNeighbour(const Coord2D& coord, TFunc func) const
+    {
+        TNeighborhood::ForEachNeighbour(coord, m_range, [&](const Coord2D& neighbour) {
+            if (m_map.Get(neighbour))
+                func(neighbour);
+        });
+    }
+
+    /**
+     * \~english
+     * @brief Call a function for every passable coordinate
+     *
+     * @param func function taking coordinate
+     */
+    /**
+     * \~russian
+     * @brief Вызвать функцию для каждой проходимой координаты
+     *
+     * @param func функция, принимающая координату
+     */
+    template <typename TFunc>
+    void ForEachNode(TFunc func) const
+    {
+        for (int y = m_range.MinY(); y <= m_range.MaxY(); ++y)
+        {
+            for (int x = m_range.MinX(); x <= m_range.MaxX(); ++x)
+            {
+                if (m_map.Get(Coord2D(x, y)))
+                    func(Coord2D(x, y));
+            }
+        }
+    }
+
+    size_t NodeIndex(const Coord2D& coord) const { return TLinearization::Index(m_range, coord); }
+    size_t NodeIndexCount() const { return TLinearization::Count(m_range); }
+
+    int ConnectedComponentsCount() const
+    {
+        Actualize();
+        return m_components_count;
+    }
+
+    /**
+     * \~english
+     * @brief Get identifier of the connected component containing the coordinate
+     *
+     * @param coord coordinate
+     * @return component identifier or ComponentIdNone for impassable coordinate
+     */
+    /**
+     * \~russian
+     * @brief Получить идентификатор компоненты связности, содержащей координату
+     *
+     * @param coord координата
+     * @return идентификатор компоненты или ComponentIdNone для непроходимой координаты
+     */
+    int ComponentId(const Coord2D& coord) const
+    {
+        GRAPH_DEBUG_ASSERT(m_range.Contains(coord), "Wrong coordinates");
+        Actualize();
+        return static_cast<int>(LabelAt(NodeIndex(coord))) - 1;
+    }
+
+    bool SurelyConnected(const Coord2D& coord1, const Coord2D& coord2) const
+    {
+        const auto component_id = ComponentId(coord1);
+        return (component_id != ComponentIdNone) and (component_id == ComponentId(coord2));
+    }
+
+    bool SurelyNotConnected(const Coord2D& coord1, const Coord2D& coord2) const
+    {
+        return (ComponentId(coord1) != ComponentId(coord2)) or (ComponentId(coord1) == ComponentIdNone);
+    }
+
+  private:
+    // label 0 is an impassable cell, label L is the component L - 1
+    using Labels_t = std::variant<std::vector<uint8_t>, std::vector<uint16_t>, std::vector<uint32_t>>;
+
+    /**
+     * @brief Label connected components if the map was changed
+     */
+    void Actualize() const
+    {
+        if (not m_dirty)
+            return;
+        if (not Label<uint8_t>() and not Label<uint16_t>())
+            Label<uint32_t>();
+        m_dirty = false;
+    }
+
+    /**
+     * @brief Label connected components with labels of the given width
+     *
+     * @return false if the components do not fit the width
+     */
+    template <typename TLabel>
+    bool Label() const
+    {
+        if (not std::holds_alternative<std::vector<TLabel>>(m_labels))
+            m_labels.template emplace<std::vector<TLabel>>();
+        auto& labels = std::get<std::vector<TLabel>>(m_labels);
+        labels.assign(NodeIndexCount(), 0);
+        uint32_t count = 0;
+        bool fits      = true;
+        std::vector<Coord2D> front;
+        ForEachNode([&](const Coord2D& start) {
+            auto& start_label = labels[NodeIndex(start)];
+            if (not fits or (start_label != 0))
+                return;
+            if (count == std::numeric_limits<TLabel>::max())
+            {
+                fits = false;
+                return;
+            }
+            start_label = static_cast<TLabel>(++count);
+            front.push_back(start);
+            while (not front.empty())
+            {
+                const Coord2D coord = front.back();
+                front.pop_back();
+                ForEachNeighbour(coord, [&](const Coord2D& neighbour) {
+                    auto& label = labels[NodeIndex(neighbour)];
+                    if (label != 0)
+                        return;
+                    label = start_label;
+                    front.push_back(neighbour);
+                });
+            }
+        });
+        m_components_count = static_cast<int>(count);
+        m_next_label       = count + 1;
+        return fits;
+    }
+
+    uint32_t LabelAt(size_t index) const
+    {
+        return std::visit([index](const auto& labels) -> uint32_t { return labels[index]; }, m_labels);
+    }
+
+    /**
+     * @brief Update labels after one cell is changed or mark them for relabeling
+     */
+    void UpdateComponents(const Coord2D& coord, bool passable)
+    {
+        uint32_t label    = 0;
+        size_t neighbours = 0;
+        bool joins        = false;
+        ForEachNeighbour(coord, [&](const Coord2D& neighbour) {
+            const auto neighbour_label = LabelAt(NodeIndex(neighbour));
+            joins                      = joins or ((neighbours != 0) and (neighbour_label != label));
+            label                      = neighbour_label;
+            ++neighbours;
+        });
+        if (passable)
+        {
+            if (neighbours == 0)
+                label = m_next_label;
+            const bool fits = std::visit(
+                [&](auto& labels) {
+                    using Label_t = typename std::remove_reference_t<decltype(labels)>::value_type;
+                    if (label > std::numeric_limits<Label_t>::max())
+                        return false;
+                    labels[NodeIndex(coord)] = static_cast<Label_t>(label);
+                    return true;
+                },
+                m_labels);
+            m_dirty = joins or not fits;
+            if (not m_dirty and (neighbours == 0))
+            {
+                ++m_next_label;
+                ++m_components_count;
+            }
+            return;
+        }
+        std::visit([&](auto& labels) { labels[NodeIndex(coord)] = 0; }, m_labels);
+        if (neighbours == 0)
+            --m_components_count;
+        else if ((neighbours > 1) and not NeighboursStayConnected(coord))
+            m_dirty = true;
+    }
+
+    /**
+     * @brief Check if passable neighbours of a cell are connected around it within the 3x3 window
+     *
+     * A path found within the window proves that removing the cell splits nothing, no path means a possible split.
+     */
+    bool NeighboursStayConnected(const Coord2D& coord) const
+    {
+        auto in_window = [&coord](const Coord2D& cell) {
+            return (std::abs(cell.X() - coord.X()) <= 1) and (std::abs(cell.Y() - coord.Y()) <= 1) and (cell != coord);
+        };
+        auto window_index = [&coord](const Coord2D& cell) -> size_t {
+            return static_cast<size_t>((cell.X() - coord.X() + 1) * 3 + (cell.Y() - coord.Y() + 1));
+        };
+        std::array<bool, 9> is_neighbour{};
+        std::array<bool, 9> visited{};
+        std::array<size_t, 9> front{};
+        size_t front_size = 0;
+        size_t neighbours = 0;
+        ForEachNeighbour(coord, [&](const Coord2D& neighbour) {
+            is_neighbour[window_index(neighbour)] = true;
+            if (neighbours++ == 0)
+            {
+                visited[window_index(neighbour)] = true;
+                front[front_size++]              = window_index(neighbour);
+            }
+        });
+        size_t reached = 0;
+        while (front_size > 0)
+        {
+            const size_t cell_index = front[--front_size];
+            if (is_neighbour[cell_index])
+                ++reached;
+            const Coord2D cell(coord.X() + static_cast<int>(cell_index / 3) - 1,
+                               coord.Y() + static_cast<int>(cell_index % 3) - 1);
+            ForEachNeighbour(cell, [&](const Coord2D& next) {
+                if (not in_window(next) or visited[window_index(next)])
+                    return;
+                const size_t index = window_index(next);
+                visited[index]      = true;
+                front[front_size++] = index;
+            });
+        }
+        return reached == neighbours;
+    }
+
+    Range2D m_range;
+    BitMap2D m_map;
+    mutable Labels_t m_labels;
+    mutable bool m_dirty           = true;
+    mutable int m_components_count = 0;
+    mutable uint32_t m_next_label  = 1;
+};
+
+/**
+ * \~english
+ * @brief Wave path finding over an implicit area
+ *
+ * The wave stores one byte per cell: the direction to the parent cell. Distances are restored by walking back.
+ *
+ * @tparam TArea implicit area type
+ */
+/**
+ * \~russian
+ * @brief Волновой поиск пути по неявной области
+ *
+ * Волна хранит один байт на клетку: направление на родительскую клетку. Расстояния восстанавливаются обратным ходом.
+ *
+ * @tparam TArea тип неявной области
+ */
+template <typename TArea>
+class AreaImplicitPathFindContext
+{
+  public:
+    using Path_t = std::vector<Coord2D>;
+
+    AreaImplicitPathFindContext(const TArea* area, const Coord2D& start)
+        : m_area(area), m_start(start), m_parents(area->NodeIndexCount(), ParentNone)
+    {
+        GRAPH_DEBUG_ASSERT(m_area != nullptr, "Null area");
+        GRAPH_DEBUG_ASSERT(m_area->Passable(m_start), "Impassable start");
+        m_parents[Index(m_start)] = ParentStart;
+        m_forefront.push_back(m_start);
+    }
+
+    const Coord2D& Start() const { return m_start; }
+
+    bool Exhausted() const { return m_forefront.empty(); }
+
+    void Step()
+    {
+        std::vector<Coord2D> new_forefront;
+        for (const auto& coord : m_forefront)
+        {
+            m_area->ForEachNeighbour(coord, [&](const Coord2D& neighbour) {
+                auto& parent = m_parents[Index(neighbour)];
+                if (parent != ParentNone)
+                    return;
+                parent = Direction(neighbour, coord);
+                new_forefront.push_back(neighbour);
+            });
+        }
+        m_forefront = std::move(new_forefront);
+    }
+
+    void SpreadWave()
+    {
+        while (not Exhausted())
+        {
+            Step();
+        }
+    }
+
+    bool Reached(const Coord2D& target) const { return (m_parents[Index(target)] != ParentNone); }
+
+    float DistanceTo(const Coord2D& target) const
+    {
+        if (not Reached(target))
+            return 0.0;
+        return PathTo(target).size() - 1;
+    }
+
+    Path_t FindPathTo(const Coord2D& target)
+    {
+        Path_t path;
+        if (m_area->SurelyNotConnected(m_start, target))
+            return path;
+        while (not Reached(target) and not Exhausted())
+        {
+            Step();
+        }
+        return PathTo(target);
+    }
+
+    Path_t PathTo(const Coord2D& target) const
+    {
+        Path_t path;
+        if (not Reached(target))
+            return path;
+        Coord2D coord = target;
+        path.push_back(coord);
+        while (coord != m_start)
+        {
+            const auto parent = m_parents[Index(coord)];
+            coord             = Coord2D(coord.X() + (parent / 3) - 1, coord.Y() + (parent % 3) - 1);
+            path.push_back(coord);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+  private:
+    static constexpr uint8_t ParentNone  = 0xFF;
+    static constexpr uint8_t ParentStart = 4;
+
+    size_t Index(const Coord2D& coord) const { return m_area->NodeIndex(coord); }
+
+    /**
+     * @brief Encode direction from a cell to its adjacent parent cell
+     */
+    static uint8_t Direction(const Coord2D& from, const Coord2D& to)
+    {
+        return static_cast<uint8_t>((to.X() - from.X() + 1) * 3 + (to.Y() - from.Y() + 1));
+    }
+
+    const TArea* m_area = nullptr;
+    Coord2D m_start;
+    std::vector<uint8_t> m_parents;
+    std::vector<Coord2D> m_forefront;
+};
+
+}  // namespace GG
@@ -0,0 +1,185 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "./algorithms.h"
+#include "./common.h"
+#include "./concepts.h"
+#include "./thread_pool.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Executor of batches of path and distance queries over a thread pool
+ *
+ * Queries with the same start are answered by one wave, which is continued from target to target. Groups of queries
+ * are spread over the threads of a work stealing pool, every thread keeps its wave search and reuses its memory for
+ * the next group. Answers are returned in the order of queries.
+ *
+ * Frozen graphs such as CsrGraph are read without locks. A mutable graph is read under a shared lock of the mutex its
+ * writers lock exclusively.
+ *
+ * @tparam TAdjacency adjacency provider type
+ */
+/**
+ * \~russian
+ * @brief Исполнитель пакетов запросов путей и расстояний в пуле потоков
+ *
+ * На запросы с одинаковым стартом отвечает одна волна, которая продолжается от цели к цели. Группы запросов
+ * распределяются по потокам пула с перехватом работы, каждый поток хранит свой волновой поиск и повторно использует
+ * его память для следующей группы. Ответы возвращаются в порядке запросов.
+ *
+ * Замороженные графы, такие как CsrGraph, читаются без блокировок. Изменяемый граф читается под разделяемой
+ * блокировкой мьютекса, который его писатели блокируют монопольно.
+ *
+ * @tparam TAdjacency тип поставщика смежности
+ */
+template <AdjacencyProvider TAdjacency>
+class BatchPathFinder
+{
+  public:
+    using Node_t = typename TAdjacency::NodeHandle_t;
+    using Wave_t = WaveSearch<TAdjacency>;
+
+    struct Query {
+        Node_t start;
+        Node_t target;
+    };
+
+    struct Answer {
+        bool reached   = false;
+        float distance = 0.0;
+        // nodes from the start to the target, filled only if paths are requested
+        std::vector<Node_t> path;
+    };
+
+    /**
+     * \~english
+     * @brief Constructor
+     *
+     * @param adjacency adjacency provider
+     * @param pool thread pool
+     */
+    /**
+     * \~russian
+     * @brief Конструктор
+     *
+     * @param adjacency поставщик смежности
+     * @param pool пул потоков
+     */
+    BatchPathFinder(const TAdjacency* adjacency, WorkStealingPool* pool)
+        : m_adjacency(adjacency), m_pool(pool), m_waves(pool->ThreadsCount())
+    {
+        GRAPH_DEBUG_ASSERT(m_adjacency != nullptr, "Null adjacency");
+    }
+
+    /**
+     * \~english
+     * @brief Answer queries, the graph must not change meanwhile
+     *
+     * @param queries queries
+     * @param paths fill paths, otherwise only distances
+     * @return answers in the order of queries
+     */
+    /**
+     * \~russian
+     * @brief Ответить на запросы, граф не должен меняться в это время
+     *
+     * @param queries запросы
+     * @param paths заполнять пути, иначе только расстояния
+     * @return ответы в порядке запросов
+     */
+    std::vector<Answer> Run(std::span<const Query> queries, bool paths = true)
+    {
+        std::vector<Answer> answers(queries.size());
+        std::unordered_map<Node_t, size_t> group_of_start;
+        std::vector<std::vector<size_t>> groups;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            const auto [group_it, added] = group_of_start.try_emplace(queries[i].start, groups.size());
+            if (added)
+                groups.emplace_back();
+            groups[group_it->second].push_back(i);
+        }
+        // a lazy component watch such as StronglyConnectedComponentWatch recomputes pending edits on its first query,
+        // which must happen here and not on the pool threads
+        if constexpr (requires { m_adjacency->Graph()->ConnectedComponentsCount(); })
+            m_adjacency->Graph()->ConnectedComponentsCount();
+        m_pool->ParallelFor(groups.size(), [&](size_t group, size_t thread) {
+            const auto& indices = groups[group];
+            auto& wave          = m_waves[thread];
+            const auto& start   = queries[indices.front()].start;
+            if (wave.has_value())
+                wave->Reset(start);
+            else
+                wave.emplace(m_adjacency, start);
+            for (const auto i : indices)
+                Solve(*wave, queries[i].target, paths, &answers[i]);
+        });
+        return answers;
+    }
+
+    /**
+     * \~english
+     * @brief Answer queries over a mutable graph, holding a shared lock of its mutex for the whole batch
+     *
+     * Pending edits of a lazy component watch are recomputed under the shared lock, so other readers of such a graph
+     * must not query it at the same time.
+     *
+     * @param queries queries
+     * @param mutex mutex the writers of the graph lock exclusively
+     * @param paths fill paths, otherwise only distances
+     * @return answers in the order of queries
+     */
+    /**
+     * \~russian
+     * @brief Ответить на запросы к изменяемому графу, удерживая разделяемую блокировку его мьютекса на весь пакет
+     *
+     * Отложенные изменения ленивого наблюдателя компонент пересчитываются под разделяемой блокировкой, поэтому другие
+     * читатели такого графа не должны обращаться к нему в это же время.
+     *
+     * @param queries запросы
+     * @param mutex мьютекс, который писатели графа блокируют монопольно
+     * @param paths заполнять пути, иначе только расстояния
+     * @return ответы в порядке запросов
+     */
+    std::vector<Answer> Run(std::span<const Query> queries, std::shared_mutex& mutex, bool paths = true)
+    {
+        const std::shared_lock lock(mutex);
+        return Run(queries, paths);
+    }
+
+  private:
+    void Solve(Wave_t& wave, const Node_t& target, bool paths, Answer* answer) const
+    {
+        if constexpr (requires { m_adjacency->Graph()->SurelyNotConnected(wave.Start(), target); })
+        {
+            if (m_adjacency->Graph()->SurelyNotConnected(wave.Start(), target))
+                return;
+        }
+        while (not wave.Reached(target) and not wave.Exhausted())
+            wave.Step();
+        answer->reached = wave.Reached(target);
+        if (not answer->reached)
+            return;
+        answer->distance = wave.DistanceTo(target);
+        if (paths)
+            answer->path = wave.PathTo(target);
+    }
+
+    const TAdjacency* m_adjacency = nullptr;
+    WorkStealingPool* m_pool      = nullptr;
+    // search of every pool thread, kept between groups and batches
+    std::vector<std::optional<Wave_t>> m_waves;
+};
+
+}  // namespace GG
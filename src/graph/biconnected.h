@@ -0,0 +1,198 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Index of articulation points and bridges of a graph
+ *
+ * The index is rebuilt lazily by an iterative Tarjan's traversal in O(V+E) on the first query after the graph has
+ * changed. Queries on an actual index are O(1), so a caller can check whether a deletion splits a component before
+ * the graph is mutated. Edges are treated as undirected.
+ *
+ * @tparam TGraph graph type
+ */
+/**
+ * \~russian
+ * @brief Индекс точек сочленения и мостов графа
+ *
+ * Индекс перестраивается лениво итеративным обходом Тарьяна за O(V+E) при первом запросе после изменения графа.
+ * Запросы к актуальному индексу выполняются за O(1), поэтому можно проверить, разбивает ли удаление компоненту, до
+ * изменения графа. Рёбра считаются ненаправленными.
+ *
+ * @tparam TGraph тип графа
+ */
+template <typename TGraph>
+class BiconnectedIndex
+{
+  public:
+    using Node_t = typename TGraph::Node_t;
+    using Edge_t = typename TGraph::Edge_t;
+
+    explicit BiconnectedIndex(const TGraph* graph) : m_graph(graph)
+    {
+        GRAPH_DEBUG_ASSERT(m_graph != nullptr, "Null graph");
+    }
+
+    /**
+     * \~english
+     * @brief Check if the node is an articulation point, so deleting it disconnects its component
+     *
+     * @param node node
+     * @return true node is an articulation point
+     * @return false node is not an articulation point
+     */
+    /**
+     * \~russian
+     * @brief Проверить, является ли вершина точкой сочленения, то есть разбивает ли её удаление компоненту
+     *
+     * @param node вершина
+     * @return true вершина является точкой сочленения
+     * @return false вершина не является точкой сочленения
+     */
+    bool IsArticulation(Node_t* node) const
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        Actualize();
+        return m_articulations.contains(node);
+    }
+
+    /**
+     * \~english
+     * @brief Check if the edge is a bridge, so deleting it disconnects its component
+     *
+     * @param edge edge
+     * @return true edge is a bridge
+     * @return false edge is not a bridge
+     */
+    /**
+     * \~russian
+     * @brief Проверить, является ли ребро мостом, то есть разбивает ли его удаление компоненту
+     *
+     * @param edge ребро
+     * @return true ребро является мостом
+     * @return false ребро не является мостом
+     */
+    bool IsBridge(Edge_t* edge) const
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        Actualize();
+        return m_bridges.contains(edge);
+    }
+
+    bool WouldDisconnect(Node_t* node) const { return IsArticulation(node); }
+    bool WouldDisconnect(Edge_t* edge) const { return IsBridge(edge); }
+
+    const std::unordered_set<Node_t*>& Articulations() const
+    {
+        Actualize();
+        return m_articulations;
+    }
+
+    const std::unordered_set<Edge_t*>& Bridges() const
+    {
+        Actualize();
+        return m_bridges;
+    }
+
+  private:
+    void Actualize() const
+    {
+        if (m_actual and (m_version == m_graph->Version()))
+            return;
+        Rebuild();
+        m_version = m_graph->Version();
+        m_actual  = true;
+    }
+
+    void Rebuild() const
+    {
+        struct NodeState {
+            int index   = 0;
+            int lowlink = 0;
+        };
+        struct Frame {
+            Node_t* node        = nullptr;
+            Edge_t* parent_edge = nullptr;
+            size_t edge_pos     = 0;
+            int children        = 0;
+        };
+
+        m_articulations.clear();
+        m_bridges.clear();
+        std::unordered_map<Node_t*, NodeState> states;
+        states.reserve(m_graph->Nodes().size());
+        std::vector<Frame> call_stack;
+        int index = 0;
+
+        for (const auto& node_el : m_graph->Nodes())
+        {
+            auto root = node_el.second;
+            if (states.contains(root))
+                continue;
+            states[root] = NodeState{index, index};
+            ++index;
+            call_stack.push_back(Frame{root, nullptr, 0, 0});
+            while (not call_stack.empty())
+            {
+                auto& frame       = call_stack.back();
+                const auto& edges = frame.node->Edges();
+                if (frame.edge_pos < edges.size())
+                {
+                    auto edge = edges[frame.edge_pos++];
+                    if (edge == frame.parent_edge)
+                        continue;
+                    auto node_to  = edge->OtherNode(frame.node);
+                    auto state_it = states.find(node_to);
+                    if (state_it != states.end())
+                    {
+                        auto& state   = states[frame.node];
+                        state.lowlink = std::min(state.lowlink, state_it->second.index);
+                        continue;
+                    }
+                    ++frame.children;
+                    states[node_to] = NodeState{index, index};
+                    ++index;
+                    call_stack.push_back(Frame{node_to, edge, 0, 0});
+                    continue;
+                }
+
+                const auto done = frame;
+                call_stack.pop_back();
+                if (call_stack.empty())
+                {
+                    if (done.children > 1)
+                        m_articulations.insert(done.node);
+                    continue;
+                }
+                const auto& state  = states[done.node];
+                auto& parent       = call_stack.back();
+                auto& parent_state = states[parent.node];
+                parent_state.lowlink = std::min(parent_state.lowlink, state.lowlink);
+                if (state.lowlink > parent_state.index)
+                    m_bridges.insert(done.parent_edge);
+                if ((parent.parent_edge != nullptr) and (state.lowlink >= parent_state.index))
+                    m_articulations.insert(parent.node);
+            }
+        }
+    }
+
+    const TGraph* m_graph = nullptr;
+    mutable bool m_actual      = false;
+    mutable uint64_t m_version = 0;
+    mutable std::unordered_set<Node_t*> m_articulations;
+    mutable std::unordered_set<Edge_t*> m_bridges;
+};
+
+}  // namespace GG
@@ -0,0 +1,276 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+#include "./csr.h"
+#include "./hash.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Builder of a graph by many threads at once
+ *
+ * Node ids are spread over shards, each with its own lock and id table, so threads making different nodes rarely
+ * wait for each other. Node and edge objects are allocated by the threads that make them, adjacency appends take the
+ * lock of the node shard. When the threads are done the result is moved into a GraphInclusive without copying the
+ * objects or frozen into a CsrGraph.
+ *
+ * @tparam TGraph graph type to finalize into
+ */
+/**
+ * \~russian
+ * @brief Построитель графа многими потоками одновременно
+ *
+ * Идентификаторы вершин распределяются по сегментам, у каждого своя блокировка и таблица идентификаторов, поэтому
+ * потоки, создающие разные вершины, редко ждут друг друга. Объекты вершин и рёбер выделяются создающими их потоками,
+ * добавление в списки смежности берёт блокировку сегмента вершины. Когда потоки закончили, результат переносится в
+ * GraphInclusive без копирования объектов или замораживается в CsrGraph.
+ *
+ * @tparam TGraph тип графа, в который завершается построение
+ */
+template <typename TGraph>
+class ParallelBuilder
+{
+  public:
+    using Node_t   = typename TGraph::Node_t;
+    using Edge_t   = typename TGraph::Edge_t;
+    using NodeId_t = typename Node_t::NodeId_t;
+    using Frozen_t = CsrGraph<NodeId_t, TGraph::IsWeighted>;
+
+    static constexpr bool IsDirected = TGraph::IsDirected;
+
+  private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<NodeId_t, Node_t*, NodeIdHash<NodeId_t>> nodes;
+    };
+
+    struct Local {
+        std::vector<Edge_t*> edges;
+    };
+
+  public:
+    /**
+     * \~english
+     * @brief Handle of one building thread, its edges are kept apart from edges of other threads
+     */
+    /**
+     * \~russian
+     * @brief Дескриптор одного строящего потока, его рёбра хранятся отдельно от рёбер других потоков
+     */
+    class Worker
+    {
+      public:
+        /**
+         * \~english
+         * @brief Find node by id
+         *
+         * @param id node id
+         * @return node found or nullptr
+         */
+        /**
+         * \~russian
+         * @brief Найти вершину по идентификатору
+         *
+         * @param id идентификатор вершины
+         * @return найденная вершина или nullptr
+         */
+        Node_t* Find(const NodeId_t& id) const
+        {
+            auto& shard = m_builder->ShardOf(id);
+            const std::lock_guard lock(shard.mutex);
+            const auto node_it = shard.nodes.find(id);
+            return (node_it == shard.nodes.end()) ? nullptr : node_it->second;
+        }
+
+        /**
+         * \~english
+         * @brief Find node by id or make it, only one of the threads racing for an id makes the node
+         *
+         * @param id node id
+         * @return node and true if it is made by this call
+         */
+        /**
+         * \~russian
+         * @brief Найти вершину по идентификатору или создать её, только один из соревнующихся за идентификатор
+         * потоков создаёт вершину
+         *
+         * @param id идентификатор вершины
+         * @return вершина и true, если она создана этим вызовом
+         */
+        std::pair<Node_t*, bool> FindOrMake(const NodeId_t& id)
+        {
+            auto& shard = m_builder->ShardOf(id);
+            const std::lock_guard lock(shard.mutex);
+            auto [node_it, made] = shard.nodes.emplace(id, nullptr);
+            if (made)
+                node_it->second = new Node_t(id);
+            return {node_it->second, made};
+        }
+
+        Edge_t* MakeEdge(Node_t* node1, Node_t* node2, bool directed = false)
+        {
+            auto* edge = new Edge_t(node1, node2, directed);
+            auto& shard1 = m_builder->ShardOf(node1->Id());
+            auto& shard2 = m_builder->ShardOf(node2->Id());
+            {
+                const std::lock_guard lock(shard1.mutex);
+                node1->AddEdge(edge);
+                if (&shard1 == &shard2)
+                    node2->AddEdge(edge);
+            }
+            if (&shard1 != &shard2)
+            {
+                const std::lock_guard lock(shard2.mutex);
+                node2->AddEdge(edge);
+            }
+            m_local->edges.push_back(edge);
+            return edge;
+        }
+
+      private:
+        friend class ParallelBuilder;
+        Worker(ParallelBuilder* builder, Local* local) : m_builder(builder), m_local(local) {}
+
+        ParallelBuilder* m_builder = nullptr;
+        Local* m_local             = nullptr;
+    };
+
+    /**
+     * \~english
+     * @brief Constructor
+     *
+     * @param shards count of shards, rounded up to a power of two, several times the count of threads is enough
+     */
+    /**
+     * \~russian
+     * @brief Конструктор
+     *
+     * @param shards количество сегментов, округляется вверх до степени двойки, достаточно в несколько раз больше
+     * количества потоков
+     */
+    explicit ParallelBuilder(size_t shards = 64)
+        : m_shards(std::bit_ceil(std::max<size_t>(shards, 1))), m_shards_mask(m_shards.size() - 1)
+    {}
+    ParallelBuilder(const ParallelBuilder&)            = delete;
+    ParallelBuilder& operator=(const ParallelBuilder&) = delete;
+    ~ParallelBuilder()
+    {
+        for (auto edge : Edges())
+            delete edge;
+        for (const auto& node_el : Nodes())
+            delete node_el.second;
+    }
+
+    /**
+     * \~english
+     * @brief Register a building thread, may be called from any thread
+     *
+     * @return worker to be used by one thread
+     */
+    /**
+     * \~russian
+     * @brief Зарегистрировать строящий поток, может вызываться из любого потока
+     *
+     * @return исполнитель для использования одним потоком
+     */
+    Worker MakeWorker()
+    {
+        const std::lock_guard lock(m_locals_mutex);
+        m_locals.push_back(std::make_unique<Local>());
+        return Worker(this, m_locals.back().get());
+    }
+
+    /**
+     * \~english
+     * @brief Nodes made so far, pairs of id and node, not to be called while workers run
+     */
+    /**
+     * \~russian
+     * @brief Созданные вершины, пары идентификатора и вершины, не вызывать во время работы исполнителей
+     */
+    auto Nodes() const
+    {
+        return m_shards | std::views::transform([](const Shard& shard) -> const auto& { return shard.nodes; }) |
+               std::views::join;
+    }
+
+    /**
+     * \~english
+     * @brief Edges made so far, not to be called while workers run
+     */
+    /**
+     * \~russian
+     * @brief Созданные рёбра, не вызывать во время работы исполнителей
+     */
+    auto Edges() const
+    {
+        return m_locals | std::views::transform([](const auto& local) -> const auto& { return local->edges; }) |
+               std::views::join;
+    }
+
+    /**
+     * \~english
+     * @brief Move everything built into a graph, the builder becomes empty
+     *
+     * Entries of the shard tables are spliced into the node map of the graph when it is a std::unordered_map with
+     * the same key and value, see GraphInclusive::Adopt.
+     *
+     * @param graph graph, may already have nodes with other ids
+     */
+    /**
+     * \~russian
+     * @brief Перенести всё построенное в граф, построитель становится пустым
+     *
+     * Элементы таблиц сегментов переносятся в отображение вершин графа, если оно std::unordered_map с теми же ключом
+     * и значением, см. GraphInclusive::Adopt.
+     *
+     * @param graph граф, в нём уже могут быть вершины с другими идентификаторами
+     */
+    void Finalize(TGraph& graph)
+    {
+        graph.Adopt(m_shards | std::views::transform([](Shard& shard) -> auto& { return shard.nodes; }), Edges());
+        m_locals.clear();
+    }
+
+    /**
+     * \~english
+     * @brief Freeze everything built, the builder keeps its objects
+     *
+     * @return frozen graph
+     */
+    /**
+     * \~russian
+     * @brief Заморозить всё построенное, построитель сохраняет свои объекты
+     *
+     * @return замороженный граф
+     */
+    Frozen_t Freeze() const { return Frozen_t(*this); }
+
+  private:
+    Shard& ShardOf(const NodeId_t& id)
+    {
+        // high half of the hash, the low one picks buckets inside the shard
+        return m_shards[(NodeIdHash<NodeId_t>{}(id) >> (sizeof(size_t) * 4)) & m_shards_mask];
+    }
+
+    std::vector<Shard> m_shards;
+    size_t m_shards_mask = 0;
+    std::mutex m_locals_mutex;
+    std::vector<std::unique_ptr<Local>> m_locals;
+};
+
+}  // namespace GG
@@ -0,0 +1,166 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "./common.h"
+#include "./csr.h"
+#include "./thread_pool.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Label connected components of a frozen graph by many threads
+ *
+ * Afforest algorithm over a lock-free union-find: nodes are linked along their first few neighbours, the largest
+ * component is guessed by sampling, and then only nodes outside of it link the rest of their neighbours. Links are
+ * compare-and-swap of parent pointers towards smaller node handles, so threads never wait for each other. Directed
+ * edges are taken as undirected, the result is weakly connected components.
+ *
+ * @param csr frozen graph
+ * @param pool thread pool
+ * @param components dense component label of every node handle
+ * @return count of components
+ */
+/**
+ * \~russian
+ * @brief Разметить компоненты связности замороженного графа многими потоками
+ *
+ * Алгоритм Afforest над неблокирующим объединением-поиском: вершины связываются по нескольким первым соседям,
+ * наибольшая компонента угадывается выборкой, а затем только вершины вне неё связывают остальных своих соседей.
+ * Связывание - это сравнение с обменом указателей на родителя в сторону меньших дескрипторов вершин, поэтому потоки
+ * никогда не ждут друг друга. Направленные рёбра считаются ненаправленными, результат - слабо связные компоненты.
+ *
+ * @param csr замороженный граф
+ * @param pool пул потоков
+ * @param components плотная метка компоненты каждого дескриптора вершины
+ * @return количество компонент
+ */
+template <typename TNodeId, bool IsWeighted>
+int ParallelConnectedComponents(const CsrGraph<TNodeId, IsWeighted>& csr, WorkStealingPool& pool,
+                                std::vector<int32_t>* components)
+{
+    using Node_t                    = typename CsrGraph<TNodeId, IsWeighted>::NodeHandle_t;
+    static constexpr size_t Chunk   = 4096;
+    static constexpr Node_t Samples = 2;
+    const auto& data                = csr.Data();
+    const auto count                = static_cast<Node_t>(csr.NodesCount());
+    std::vector<std::atomic<Node_t>> parents(count);
+
+    auto for_nodes = [&](auto func) {
+        pool.ParallelFor((count + Chunk - 1) / Chunk, [&](size_t chunk, [[maybe_unused]] size_t thread) {
+            const auto end = static_cast<Node_t>(std::min<size_t>((chunk + 1) * Chunk, count));
+            for (auto node = static_cast<Node_t>(chunk * Chunk); node < end; ++node)
+                func(node);
+        });
+    };
+    auto parent = [&](Node_t node) { return parents[node].load(std::memory_order_relaxed); };
+    auto link   = [&](Node_t node1, Node_t node2) {
+        Node_t parent1 = parent(node1);
+        Node_t parent2 = parent(node2);
+        while (parent1 != parent2)
+        {
+            const Node_t high  = std::max(parent1, parent2);
+            const Node_t low   = std::min(parent1, parent2);
+            Node_t parent_high = parent(high);
+            if (parent_high == low)
+                return;
+            if ((parent_high == high) and
+                parents[high].compare_exchange_strong(parent_high, low, std::memory_order_relaxed))
+                return;
+            parent1 = parent(parent(high));
+            parent2 = parent(low);
+        }
+    };
+    auto compress = [&](Node_t node) {
+        while (parent(node) != parent(parent(node)))
+            parents[node].store(parent(parent(node)), std::memory_order_relaxed);
+    };
+
+    for_nodes([&](Node_t node) { parents[node].store(node, std::memory_order_relaxed); });
+    for (Node_t round = 0; round < Samples; ++round)
+    {
+        for_nodes([&](Node_t node) {
+            const auto pos = data.offsets[node] + round;
+            if (pos < data.offsets[node + 1])
+                link(node, data.neighbours[pos]);
+        });
+        for_nodes(compress);
+    }
+
+    // edges stored only from their first node are not seen from the largest component, so it can not be skipped
+    Node_t largest = CsrGraph<TNodeId, IsWeighted>::NodeNone;
+    if (data.directions.empty() and (count > 0))
+    {
+        static constexpr size_t Probes = 1024;
+        std::unordered_map<Node_t, size_t> frequency;
+        for (size_t i = 0; i < Probes; ++i)
+            ++frequency[parent(static_cast<Node_t>(i * count / Probes))];
+        largest = std::max_element(frequency.begin(), frequency.end(), [](const auto& lhs, const auto& rhs) {
+                      return lhs.second < rhs.second;
+                  })->first;
+    }
+    for_nodes([&](Node_t node) {
+        if (parent(node) == largest)
+            return;
+        for (auto pos = data.offsets[node] + Samples; pos < data.offsets[node + 1]; ++pos)
+            link(node, data.neighbours[pos]);
+    });
+    for_nodes(compress);
+
+    components->assign(count, -1);
+    int components_count = 0;
+    for (Node_t node = 0; node < count; ++node)
+    {
+        // roots are the smallest nodes of their components, so they are labeled before the rest
+        const auto root = parent(node);
+        if (root == node)
+            (*components)[node] = components_count++;
+        else
+            (*components)[node] = (*components)[root];
+    }
+    return components_count;
+}
+
+/**
+ * \~english
+ * @brief Recompute connected components of a graph by many threads and set them to its watch in one shot
+ *
+ * Meant to follow bulk loads and large deletions made in a bulk update ended without rebuilding components.
+ *
+ * @param graph graph, not in a bulk update
+ * @param pool thread pool
+ * @return count of components
+ */
+/**
+ * \~russian
+ * @brief Пересчитать компоненты связности графа многими потоками и задать их его отслеживанию за один раз
+ *
+ * Предназначено для выполнения после групповых загрузок и больших удалений, сделанных в групповом изменении,
+ * законченном без пересчёта компонент.
+ *
+ * @param graph граф, не в групповом изменении
+ * @param pool пул потоков
+ * @return количество компонент
+ */
+template <typename TGraph>
+int BootstrapComponents(TGraph& graph, WorkStealingPool& pool)
+{
+    GRAPH_DEBUG_ASSERT(not graph.InBulkUpdate(), "Bulk update not ended");
+    // frozen node handles follow the order of graph nodes
+    const CsrGraph<typename TGraph::Node_t::NodeId_t> csr(graph);
+    std::vector<int32_t> components;
+    const int count = ParallelConnectedComponents(csr, pool, &components);
+    graph.AssignComponents(components, count);
+    return count;
+}
+
+}  // namespace GG
@@ -0,0 +1,96 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Node handle: a cheap copyable and hashable value identifying a node of an adjacency provider
+ */
+/**
+ * \~russian
+ * @brief Дескриптор вершины: дешёвое копируемое и хешируемое значение, идентифицирующее вершину поставщика смежности
+ */
+template <typename T>
+concept NodeHandle = std::copyable<T> and std::equality_comparable<T> and requires(const T& node) {
+    { std::hash<T>{}(node) } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * \~english
+ * @brief Adjacency provider: anything that can enumerate neighbours of a node handle
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности: всё, что может перечислить соседей дескриптора вершины
+ */
+template <typename T>
+concept AdjacencyProvider = NodeHandle<typename T::NodeHandle_t> and
+                            requires(const T& adjacency, const typename T::NodeHandle_t& node) {
+                                adjacency.ForEachNeighbour(node, [](const typename T::NodeHandle_t&) {});
+                            };
+
+/**
+ * \~english
+ * @brief Adjacency provider with edge weights
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности с весами рёбер
+ */
+template <typename T>
+concept WeightedAdjacencyProvider =
+    AdjacencyProvider<T> and requires(const T& adjacency, const typename T::NodeHandle_t& node) {
+        adjacency.ForEachNeighbourWeighted(node, [](const typename T::NodeHandle_t&, float) {});
+    };
+
+/**
+ * \~english
+ * @brief Adjacency provider that can also enumerate predecessors of a node
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности, который также может перечислить предшественников вершины
+ */
+template <typename T>
+concept ReverseAdjacencyProvider =
+    AdjacencyProvider<T> and requires(const T& adjacency, const typename T::NodeHandle_t& node) {
+        adjacency.ForEachPredecessor(node, [](const typename T::NodeHandle_t&) {});
+    };
+
+/**
+ * \~english
+ * @brief Adjacency provider that can enumerate all its nodes
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности, который может перечислить все свои вершины
+ */
+template <typename T>
+concept NodeEnumerableProvider = AdjacencyProvider<T> and requires(const T& adjacency) {
+    adjacency.ForEachNode([](const typename T::NodeHandle_t&) {});
+};
+
+/**
+ * \~english
+ * @brief Adjacency provider that maps its nodes to dense indices, so per-node state can live in plain arrays
+ */
+/**
+ * \~russian
+ * @brief Поставщик смежности, отображающий свои вершины в плотные индексы, так что состояние вершин хранится в
+ * обычных массивах
+ */
+template <typename T>
+concept DenseIndexedProvider =
+    AdjacencyProvider<T> and requires(const T& adjacency, const typename T::NodeHandle_t& node) {
+        { adjacency.NodeIndex(node) } -> std::convertible_to<std::size_t>;
+        { adjacency.NodeIndexCount() } -> std::convertible_to<std::size_t>;
+    };
+
+}  // namespace GG
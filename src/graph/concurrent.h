@@ -0,0 +1,314 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "./algorithms.h"
+#include "./common.h"
+#include "./csr.h"
+#include "./epoch.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Graph mutated by one writer and read by many threads without locks
+ *
+ * The writer owns a mutable graph and publishes frozen versions of it. Readers pin the latest published version for
+ * the time of a query and run Find, traversals and WaveSearch path queries on it while the writer keeps mutating.
+ * Replaced versions are freed by epoch based reclamation after the last reader leaves them.
+ *
+ * Every publication freezes the whole graph, O(V + E). Mutations applied with Apply are gathered into one version by
+ * the next Publish, a publication without mutations is skipped. Every reader keeps one wave search whose memory is
+ * reused by the queries of all versions.
+ *
+ * @tparam TGraph mutable graph type
+ */
+/**
+ * \~russian
+ * @brief Граф, изменяемый одним писателем и читаемый многими потоками без блокировок
+ *
+ * Писатель владеет изменяемым графом и публикует его замороженные версии. Читатели закрепляют последнюю
+ * опубликованную версию на время запроса и выполняют на ней Find, обходы и поиск путей WaveSearch, пока писатель
+ * продолжает изменения. Заменённые версии освобождаются на основе эпох после ухода последнего читателя.
+ *
+ * Каждая публикация замораживает весь граф, O(V + E). Изменения, применённые через Apply, собираются в одну версию
+ * следующим Publish, публикация без изменений пропускается. Каждый читатель хранит один волновой поиск, память
+ * которого повторно используется запросами всех версий.
+ *
+ * @tparam TGraph тип изменяемого графа
+ */
+template <typename TGraph>
+class ConcurrentGraph
+{
+  public:
+    using Frozen_t = CsrGraph<typename TGraph::Node_t::NodeId_t, TGraph::IsWeighted>;
+    using Search_t = WaveSearch<Frozen_t>;
+
+    /**
+     * \~english
+     * @brief Published version of the graph
+     */
+    /**
+     * \~russian
+     * @brief Опубликованная версия графа
+     */
+    struct Version {
+        Frozen_t graph;
+        // version of the mutable graph the frozen one was made of
+        uint64_t version = 0;
+        // sequence number of the publication, weight changes are published without a new graph version
+        uint64_t publication = 0;
+    };
+
+    /**
+     * \~english
+     * @brief Published version pinned by a reader, it stays alive until the guard is destroyed
+     */
+    /**
+     * \~russian
+     * @brief Опубликованная версия, закреплённая читателем, она существует до уничтожения защиты
+     */
+    class ReadGuard
+    {
+      public:
+        ReadGuard(const ReadGuard&)            = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() { m_reader->Leave(); }
+
+        const Frozen_t& Graph() const { return m_version->graph; }
+        uint64_t GraphVersion() const { return m_version->version; }
+
+      private:
+        friend class ConcurrentGraph;
+        ReadGuard(EpochDomain::Reader* reader, const std::atomic<const Version*>& published) : m_reader(reader)
+        {
+            m_reader->Enter();
+            m_version = published.load(std::memory_order_seq_cst);
+        }
+
+        EpochDomain::Reader* m_reader = nullptr;
+        const Version* m_version      = nullptr;
+    };
+
+    /**
+     * \~english
+     * @brief Reader registered in the graph, one per reader thread
+     */
+    /**
+     * \~russian
+     * @brief Читатель, зарегистрированный в графе, по одному на поток-читатель
+     */
+    class Reader
+    {
+      public:
+        /**
+         * \~english
+         * @brief Pin the latest published version, never blocks
+         *
+         * @return guard of the version
+         */
+        /**
+         * \~russian
+         * @brief Закрепить последнюю опубликованную версию, никогда не блокируется
+         *
+         * @return защита версии
+         */
+        ReadGuard Read() { return ReadGuard(&m_reader, m_graph->m_published); }
+
+        /**
+         * \~english
+         * @brief Start a wave search over a pinned version, reusing memory of the previous search of this reader
+         *
+         * @param guard guard of the version, must outlive the use of the search
+         * @param start start node
+         * @return search
+         */
+        /**
+         * \~russian
+         * @brief Начать волновой поиск по закреплённой версии, повторно используя память предыдущего поиска читателя
+         *
+         * @param guard защита версии, должна существовать всё время использования поиска
+         * @param start стартовая вершина
+         * @return поиск
+         */
+        Search_t& Search(const ReadGuard& guard, typename Frozen_t::NodeHandle_t start)
+        {
+            const auto publication = guard.m_version->publication;
+            if (not m_search.has_value())
+                m_search.emplace(&guard.Graph(), start);
+            else if (m_search_publication == publication)
+                m_search->Reset(start);
+            else
+                m_search->Reset(&guard.Graph(), start);
+            m_search_publication = publication;
+            return *m_search;
+        }
+
+      private:
+        friend class ConcurrentGraph;
+        Reader(const ConcurrentGraph* graph, EpochDomain::Reader&& reader) : m_graph(graph), m_reader(std::move(reader))
+        {}
+
+        const ConcurrentGraph* m_graph = nullptr;
+        EpochDomain::Reader m_reader;
+        std::optional<Search_t> m_search;
+        uint64_t m_search_publication = 0;
+    };
+
+    /**
+     * \~english
+     * @brief Constructor, publishes the empty graph
+     *
+     * @param readers_max maximum count of simultaneously registered readers
+     * @param args arguments of the mutable graph constructor
+     */
+    /**
+     * \~russian
+     * @brief Конструктор, публикует пустой граф
+     *
+     * @param readers_max максимальное количество одновременно зарегистрированных читателей
+     * @param args аргументы конструктора изменяемого графа
+     */
+    template <typename... TArgs>
+    explicit ConcurrentGraph(size_t readers_max = 64, TArgs&&... args)
+        : m_domain(readers_max), m_graph(std::forward<TArgs>(args)...)
+    {
+        Publish();
+    }
+    ConcurrentGraph(const ConcurrentGraph&)            = delete;
+    ConcurrentGraph& operator=(const ConcurrentGraph&) = delete;
+    ~ConcurrentGraph() { delete m_published.load(); }
+
+    /**
+     * \~english
+     * @brief Register a reader, may be called from any thread
+     *
+     * @return reader, or nothing if the maximum count of readers is reached
+     */
+    /**
+     * \~russian
+     * @brief Зарегистрировать читателя, может вызываться из любого потока
+     *
+     * @return читатель или ничего, если достигнуто максимальное количество читателей
+     */
+    std::optional<Reader> MakeReader()
+    {
+        auto reader = m_domain.MakeReader();
+        if (not reader.has_value())
+            return std::nullopt;
+        return Reader(this, std::move(*reader));
+    }
+
+    /**
+     * \~english
+     * @brief Mutable graph, only the writer thread may use it, the next Publish publishes it even without changes
+     */
+    /**
+     * \~russian
+     * @brief Изменяемый граф, использовать его может только поток-писатель, следующий Publish публикует его даже без
+     * изменений
+     */
+    TGraph& Writer()
+    {
+        m_pending = true;
+        return m_graph;
+    }
+
+    /**
+     * \~english
+     * @brief Apply mutations without publishing them, only the writer thread may call it
+     *
+     * @param mutate function changing the graph given as its argument
+     */
+    /**
+     * \~russian
+     * @brief Применить изменения без их публикации, вызывать может только поток-писатель
+     *
+     * @param mutate функция, изменяющая граф, переданный ей аргументом
+     */
+    template <typename TMutate>
+    void Apply(TMutate mutate)
+    {
+        mutate(m_graph);
+        m_pending = true;
+    }
+
+    /**
+     * \~english
+     * @brief Apply mutations and publish the result, only the writer thread may call it
+     *
+     * @param mutate function changing the graph given as its argument
+     */
+    /**
+     * \~russian
+     * @brief Применить изменения и опубликовать результат, вызывать может только поток-писатель
+     *
+     * @param mutate функция, изменяющая граф, переданный ей аргументом
+     */
+    template <typename TMutate>
+    void Mutate(TMutate mutate)
+    {
+        Apply(mutate);
+        Publish();
+    }
+
+    /**
+     * \~english
+     * @brief Publish the current state of the mutable graph if it was mutated since the last publication and free
+     * versions no reader uses, called by the writer
+     *
+     * @return true if a new version is published
+     */
+    /**
+     * \~russian
+     * @brief Опубликовать текущее состояние изменяемого графа, если он изменялся после последней публикации, и
+     * освободить версии, не используемые читателями, вызывается писателем
+     *
+     * @return true, если опубликована новая версия
+     */
+    bool Publish()
+    {
+        const auto published = m_published.load(std::memory_order_relaxed);
+        if ((published != nullptr) and not m_pending and (published->version == m_graph.Version()))
+        {
+            m_domain.Reclaim();
+            return false;
+        }
+        m_pending    = false;
+        auto version = new Version{Frozen_t(m_graph), m_graph.Version(), ++m_publications};
+        auto old     = m_published.exchange(version, std::memory_order_seq_cst);
+        if (old != nullptr)
+            m_domain.Retire([old]() { delete old; });
+        m_domain.Reclaim();
+        return true;
+    }
+
+    /**
+     * \~english
+     * @brief Free versions no reader uses, called by the writer
+     *
+     * @return count of versions still used by readers
+     */
+    /**
+     * \~russian
+     * @brief Освободить версии, не используемые читателями, вызывается писателем
+     *
+     * @return количество версий, ещё используемых читателями
+     */
+    size_t Reclaim() { return m_domain.Reclaim(); }
+
+  private:
+    EpochDomain m_domain;
+    TGraph m_graph;
+    bool m_pending                          = false;
+    uint64_t m_publications                 = 0;
+    std::atomic<const Version*> m_published = nullptr;
+};
+
+}  // namespace GG
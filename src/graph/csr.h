@@ -0,0 +1,293 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "./common.h"
+#include "./concepts.h"
+#include "./hash.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Frozen graph in compressed sparse row form
+ *
+ * Nodes are numbered densely, the neighbours of node i are neighbours[offsets[i]..offsets[i+1]). Undirected edges are
+ * stored in both directions, directed edges only from their first node.
+ *
+ * @tparam TNodeId node id type
+ * @tparam IsWeighted store edge weights
+ */
+/**
+ * \~russian
+ * @brief Замороженный граф в форме сжатых разреженных строк
+ *
+ * Вершины нумеруются плотно, соседи вершины i лежат в neighbours[offsets[i]..offsets[i+1]). Ненаправленные рёбра
+ * хранятся в обоих направлениях, направленные только от их первой вершины.
+ *
+ * @tparam TNodeId тип идентификатора вершины
+ * @tparam IsWeighted хранить веса рёбер
+ */
+template <typename TNodeId, bool IsWeighted = false>
+class CsrGraph
+{
+  public:
+    using NodeId_t                      = TNodeId;
+    using NodeHandle_t                  = uint32_t;
+    static constexpr NodeHandle_t NodeNone = std::numeric_limits<NodeHandle_t>::max();
+    static constexpr int ComponentIdNone   = -1;
+
+    /**
+     * \~english
+     * @brief Read-only arrays of a frozen graph
+     *
+     * index is an open addressing table of node handles with linear probing by NodeIdHash, so it can be used directly
+     * from a memory mapped snapshot. directions is not empty only for directed graphs, it marks adjacency entries of
+     * edges stored only from their first node.
+     */
+    /**
+     * \~russian
+     * @brief Массивы замороженного графа только для чтения
+     *
+     * index - таблица с открытой адресацией дескрипторов вершин с линейным пробированием по NodeIdHash, поэтому её
+     * можно использовать прямо из отображённого в память снимка. directions не пуст только для направленных графов,
+     * он отмечает элементы смежности рёбер, хранящихся только от их первой вершины.
+     */
+    struct Sections {
+        std::span<const TNodeId> ids;
+        std::span<const uint32_t> offsets;
+        std::span<const NodeHandle_t> neighbours;
+        std::span<const float> weights;
+        std::span<const int32_t> components;
+        std::span<const uint8_t> directions;
+        std::span<const NodeHandle_t> index;
+    };
+
+    CsrGraph() = default;
+
+    /**
+     * \~english
+     * @brief Freeze a graph
+     *
+     * @param graph graph
+     */
+    /**
+     * \~russian
+     * @brief Заморозить граф
+     *
+     * @param graph граф
+     */
+    template <typename TGraph>
+    explicit CsrGraph(const TGraph& graph)
+    {
+        auto storage      = std::make_shared<Storage>();
+        const auto& nodes = graph.Nodes();
+        const auto nodes_count = static_cast<size_t>(std::ranges::distance(nodes));
+        storage->ids.reserve(nodes_count);
+        storage->components.reserve(nodes_count);
+        for (const auto& node_el : nodes)
+        {
+            storage->ids.push_back(node_el.first);
+            if constexpr (requires { graph.ComponentId(node_el.second); })
+                storage->components.push_back(graph.ComponentId(node_el.second));
+            else
+                storage->components.push_back(ComponentIdNone);
+        }
+        m_data.ids        = storage->ids;
+        m_data.components = storage->components;
+        storage->index    = MakeIndex(storage->ids);
+        m_data.index      = storage->index;
+
+        auto forward_only = [](const auto* edge) {
+            if constexpr (TGraph::IsDirected)
+                return edge->Directed();
+            else
+                return false;
+        };
+
+        auto& offsets = storage->offsets;
+        offsets.assign(storage->ids.size() + 1, 0);
+        for (const auto edge : graph.Edges())
+        {
+            ++offsets[Find(edge->Nodes().first->Id()) + 1];
+            if (not forward_only(edge))
+                ++offsets[Find(edge->Nodes().second->Id()) + 1];
+        }
+        for (size_t i = 1; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+
+        storage->neighbours.resize(offsets.back());
+        if constexpr (IsWeighted)
+            storage->weights.resize(offsets.back());
+        if constexpr (TGraph::IsDirected)
+            storage->directions.resize(offsets.back());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        auto append = [&](NodeHandle_t node_from, NodeHandle_t node_to, [[maybe_unused]] float weight,
+                          [[maybe_unused]] bool directed) {
+            if constexpr (IsWeighted)
+                storage->weights[fill[node_from]] = weight;
+            if constexpr (TGraph::IsDirected)
+                storage->directions[fill[node_from]] = directed ? 1 : 0;
+            storage->neighbours[fill[node_from]++] = node_to;
+        };
+        for (const auto edge : graph.Edges())
+        {
+            const auto node1 = Find(edge->Nodes().first->Id());
+            const auto node2 = Find(edge->Nodes().second->Id());
+            const bool directed = forward_only(edge);
+            append(node1, node2, edge->Weight(), directed);
+            if (not directed)
+                append(node2, node1, edge->Weight(), directed);
+        }
+        m_data.offsets    = storage->offsets;
+        m_data.neighbours = storage->neighbours;
+        m_data.weights    = storage->weights;
+        m_data.directions = storage->directions;
+        m_keepalive       = std::move(storage);
+    }
+
+    /**
+     * \~english
+     * @brief Use arrays owned by another object without copying, e.g. a memory mapped snapshot
+     *
+     * @param sections arrays
+     * @param keepalive owner of the arrays, kept while the graph or its copies exist
+     */
+    /**
+     * \~russian
+     * @brief Использовать массивы, принадлежащие другому объекту, без копирования, например отображённому в память
+     * снимку
+     *
+     * @param sections массивы
+     * @param keepalive владелец массивов, удерживается, пока существует граф или его копии
+     */
+    CsrGraph(const Sections& sections, std::shared_ptr<const void> keepalive)
+        : m_data(sections), m_keepalive(std::move(keepalive))
+    {
+        GRAPH_DEBUG_ASSERT(m_data.offsets.size() == m_data.ids.size() + 1, "Wrong offsets count");
+        GRAPH_DEBUG_ASSERT(m_data.components.size() == m_data.ids.size(), "Wrong components count");
+        GRAPH_DEBUG_ASSERT(std::has_single_bit(m_data.index.size()), "Wrong index size");
+    }
+
+    const Sections& Data() const { return m_data; }
+
+    size_t NodesCount() const { return m_data.ids.size(); }
+    size_t AdjacencyCount() const { return m_data.neighbours.size(); }
+
+    const TNodeId& Id(NodeHandle_t node) const { return m_data.ids[node]; }
+
+    /**
+     * \~english
+     * @brief Get connected component id of a node as it was when the graph was frozen
+     *
+     * @param node node
+     * @return component id or ComponentIdNone
+     */
+    /**
+     * \~russian
+     * @brief Получить идентификатор компоненты связности вершины на момент заморозки графа
+     *
+     * @param node вершина
+     * @return идентификатор компоненты или ComponentIdNone
+     */
+    int ComponentId(NodeHandle_t node) const { return m_data.components[node]; }
+
+    /**
+     * \~english
+     * @brief Find node by id
+     *
+     * @param id node id
+     * @return node found or NodeNone
+     */
+    /**
+     * \~russian
+     * @brief Найти вершину по идентификатору
+     *
+     * @param id идентификатор вершины
+     * @return найденная вершина или NodeNone
+     */
+    NodeHandle_t Find(const TNodeId& id) const
+    {
+        if (m_data.index.empty())
+            return NodeNone;
+        const size_t mask = m_data.index.size() - 1;
+        for (size_t pos = NodeIdHash<TNodeId>{}(id) & mask;; pos = (pos + 1) & mask)
+        {
+            const auto node = m_data.index[pos];
+            if ((node == NodeNone) or (m_data.ids[node] == id))
+                return node;
+        }
+    }
+
+    std::span<const NodeHandle_t> Neighbours(NodeHandle_t node) const
+    {
+        return m_data.neighbours.subspan(m_data.offsets[node], m_data.offsets[node + 1] - m_data.offsets[node]);
+    }
+
+    size_t NodeIndex(NodeHandle_t node) const { return node; }
+    size_t NodeIndexCount() const { return m_data.ids.size(); }
+
+    template <typename TFunc>
+    void ForEachNode(TFunc func) const
+    {
+        for (NodeHandle_t node = 0; node < m_data.ids.size(); ++node)
+            func(node);
+    }
+
+    template <typename TFunc>
+    void ForEachNeighbour(NodeHandle_t node, TFunc func) const
+    {
+        for (auto pos = m_data.offsets[node]; pos < m_data.offsets[node + 1]; ++pos)
+            func(m_data.neighbours[pos]);
+    }
+
+    template <typename TFunc>
+        requires IsWeighted
+    void ForEachNeighbourWeighted(NodeHandle_t node, TFunc func) const
+    {
+        for (auto pos = m_data.offsets[node]; pos < m_data.offsets[node + 1]; ++pos)
+            func(m_data.neighbours[pos], m_data.weights[pos]);
+    }
+
+  private:
+    struct Storage {
+        std::vector<TNodeId> ids;
+        std::vector<uint32_t> offsets;
+        std::vector<NodeHandle_t> neighbours;
+        std::vector<float> weights;
+        std::vector<int32_t> components;
+        std::vector<uint8_t> directions;
+        std::vector<NodeHandle_t> index;
+    };
+
+    static std::vector<NodeHandle_t> MakeIndex(const std::vector<TNodeId>& ids)
+    {
+        // load factor at most 1/2 keeps probe sequences short
+        std::vector<NodeHandle_t> index(std::bit_ceil(std::max<size_t>(ids.size() * 2, 2)), NodeNone);
+        const size_t mask = index.size() - 1;
+        for (NodeHandle_t node = 0; node < ids.size(); ++node)
+        {
+            size_t pos = NodeIdHash<TNodeId>{}(ids[node]) & mask;
+            while (index[pos] != NodeNone)
+                pos = (pos + 1) & mask;
+            index[pos] = node;
+        }
+        return index;
+    }
+
+    Sections m_data;
+    // frozen graph is immutable, so copies share arrays
+    std::shared_ptr<const void> m_keepalive;
+};
+
+}  // namespace GG
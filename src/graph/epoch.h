@@ -0,0 +1,192 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Epoch based memory reclamation for one writer and many readers
+ *
+ * A reader announces the current epoch in its own slot before reading shared data and clears the slot after, this
+ * is two atomic stores without locks. The writer retires objects unlinked from shared data with the epoch of
+ * unlinking and frees them when every active reader has announced a later epoch.
+ */
+/**
+ * \~russian
+ * @brief Освобождение памяти на основе эпох для одного писателя и многих читателей
+ *
+ * Читатель объявляет текущую эпоху в своём слоте перед чтением общих данных и очищает слот после, это две атомарные
+ * записи без блокировок. Писатель откладывает объекты, исключённые из общих данных, с эпохой исключения и освобождает
+ * их, когда каждый активный читатель объявил более позднюю эпоху.
+ */
+class EpochDomain
+{
+  public:
+    static constexpr uint64_t EpochIdle = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * \~english
+     * @brief Registered reader owning an epoch slot
+     */
+    /**
+     * \~russian
+     * @brief Зарегистрированный читатель, владеющий слотом эпохи
+     */
+    class Reader
+    {
+      public:
+        Reader(const Reader&)            = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader(Reader&& other) noexcept : m_domain(std::exchange(other.m_domain, nullptr)), m_slot(other.m_slot) {}
+        ~Reader()
+        {
+            if (m_domain != nullptr)
+                m_domain->m_slots[m_slot].used.store(false, std::memory_order_release);
+        }
+
+        /**
+         * \~english
+         * @brief Enter a read-side critical section, objects loaded inside it are not freed until Leave
+         */
+        /**
+         * \~russian
+         * @brief Войти в критическую секцию чтения, объекты, загруженные внутри неё, не освобождаются до Leave
+         */
+        void Enter()
+        {
+            auto& slot = m_domain->m_slots[m_slot];
+            GRAPH_DEBUG_ASSERT(slot.epoch.load(std::memory_order_relaxed) == EpochIdle, "Reader already entered");
+            // sequentially consistent store orders the announcement before loads of shared pointers
+            slot.epoch.store(m_domain->m_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        }
+
+        void Leave() { m_domain->m_slots[m_slot].epoch.store(EpochIdle, std::memory_order_release); }
+
+      private:
+        friend class EpochDomain;
+        Reader(EpochDomain* domain, size_t slot) : m_domain(domain), m_slot(slot) {}
+
+        EpochDomain* m_domain = nullptr;
+        size_t m_slot         = 0;
+    };
+
+    /**
+     * \~english
+     * @brief Constructor
+     *
+     * @param readers_max maximum count of simultaneously registered readers
+     */
+    /**
+     * \~russian
+     * @brief Конструктор
+     *
+     * @param readers_max максимальное количество одновременно зарегистрированных читателей
+     */
+    explicit EpochDomain(size_t readers_max = 64) : m_slots(readers_max) {}
+    EpochDomain(const EpochDomain&)            = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+    ~EpochDomain()
+    {
+        for (auto& retired : m_retired)
+            retired.free();
+    }
+
+    /**
+     * \~english
+     * @brief Register a reader, may be called from any thread
+     *
+     * @return reader, or nothing if all slots are taken
+     */
+    /**
+     * \~russian
+     * @brief Зарегистрировать читателя, может вызываться из любого потока
+     *
+     * @return читатель или ничего, если все слоты заняты
+     */
+    std::optional<Reader> MakeReader()
+    {
+        for (size_t slot = 0; slot < m_slots.size(); ++slot)
+        {
+            bool used = false;
+            if (m_slots[slot].used.compare_exchange_strong(used, true, std::memory_order_acq_rel))
+                return Reader(this, slot);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \~english
+     * @brief Retire an object already unlinked from shared data, called by the writer
+     *
+     * @param free function freeing the object
+     */
+    /**
+     * \~russian
+     * @brief Отложить освобождение объекта, уже исключённого из общих данных, вызывается писателем
+     *
+     * @param free функция, освобождающая объект
+     */
+    void Retire(std::function<void()> free)
+    {
+        m_retired.push_back({m_epoch.fetch_add(1, std::memory_order_seq_cst), std::move(free)});
+    }
+
+    /**
+     * \~english
+     * @brief Free retired objects no reader can still see, called by the writer
+     *
+     * @return count of objects still waiting
+     */
+    /**
+     * \~russian
+     * @brief Освободить отложенные объекты, которые больше не может видеть ни один читатель, вызывается писателем
+     *
+     * @return количество ещё ожидающих объектов
+     */
+    size_t Reclaim()
+    {
+        uint64_t epoch_min = EpochIdle;
+        for (const auto& slot : m_slots)
+            epoch_min = std::min(epoch_min, slot.epoch.load(std::memory_order_seq_cst));
+        size_t kept = 0;
+        for (size_t i = 0; i < m_retired.size(); ++i)
+        {
+            if (m_retired[i].epoch < epoch_min)
+                m_retired[i].free();
+            else if (kept++ != i)
+                m_retired[kept - 1] = std::move(m_retired[i]);
+        }
+        m_retired.resize(kept);
+        return kept;
+    }
+
+  private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch = EpochIdle;
+        std::atomic<bool> used      = false;
+    };
+
+    struct Retired {
+        uint64_t epoch = 0;
+        std::function<void()> free;
+    };
+
+    std::atomic<uint64_t> m_epoch = 0;
+    std::vector<Slot> m_slots;
+    std::vector<Retired> m_retired;
+};
+
+}  // namespace GG
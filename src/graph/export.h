@@ -0,0 +1,427 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Writer to a standard stream
+ */
+/**
+ * \~russian
+ * @brief Писатель в стандартный поток
+ */
+class StreamWriter
+{
+  public:
+    explicit StreamWriter(std::ostream& stream) : m_stream(&stream) {}
+    void Write(const char* data, size_t size) { m_stream->write(data, static_cast<std::streamsize>(size)); }
+    bool Ok() const { return m_stream->good(); }
+
+  private:
+    std::ostream* m_stream = nullptr;
+};
+
+/**
+ * \~english
+ * @brief Writer to a C file
+ */
+/**
+ * \~russian
+ * @brief Писатель в файл C
+ */
+class FileWriter
+{
+  public:
+    explicit FileWriter(FILE* file) : m_file(file) { GRAPH_DEBUG_ASSERT(m_file != nullptr, "Null file"); }
+    void Write(const char* data, size_t size)
+    {
+        if (fwrite(data, 1, size, m_file) != size)
+            m_failed = true;
+    }
+    bool Ok() const { return not m_failed; }
+
+  private:
+    FILE* m_file  = nullptr;
+    bool m_failed = false;
+};
+
+/**
+ * \~english
+ * @brief Writer to a file descriptor
+ *
+ * The first failed write is remembered: later data is dropped and Ok() stays false, so a truncated output is never
+ * reported as written.
+ */
+/**
+ * \~russian
+ * @brief Писатель в файловый дескриптор
+ *
+ * Первая неудачная запись запоминается: последующие данные отбрасываются, а Ok() остаётся ложным, поэтому усечённый
+ * вывод никогда не считается записанным.
+ */
+class FdWriter
+{
+  public:
+    explicit FdWriter(int fd) : m_fd(fd) { GRAPH_DEBUG_ASSERT(m_fd >= 0, "Wrong file descriptor"); }
+
+    void Write(const char* data, size_t size)
+    {
+        while ((size > 0) and (m_error == 0))
+        {
+            const auto written = ::write(m_fd, data, size);
+            if (written < 0)
+            {
+                if (errno != EINTR)
+                    m_error = errno;
+                continue;
+            }
+            data += written;
+            size -= written;
+        }
+    }
+    bool Ok() const { return m_error == 0; }
+    int Error() const { return m_error; }
+
+  private:
+    int m_fd    = -1;
+    int m_error = 0;
+};
+
+/**
+ * \~english
+ * @brief Writer to a string
+ */
+/**
+ * \~russian
+ * @brief Писатель в строку
+ */
+class StringWriter
+{
+  public:
+    explicit StringWriter(std::string* str) : m_str(str) { GRAPH_DEBUG_ASSERT(m_str != nullptr, "Null string"); }
+    void Write(const char* data, size_t size) { m_str->append(data, size); }
+    bool Ok() const { return true; }
+
+  private:
+    std::string* m_str = nullptr;
+};
+
+/**
+ * \~english
+ * @brief Output sink with a fixed buffer, numbers are formatted with std::to_chars
+ *
+ * @tparam TWriter writer type
+ * @tparam BufferSize buffer size
+ */
+/**
+ * \~russian
+ * @brief Выходной приёмник с буфером фиксированного размера, числа форматируются std::to_chars
+ *
+ * @tparam TWriter тип писателя
+ * @tparam BufferSize размер буфера
+ */
+template <typename TWriter, size_t BufferSize = 64 * 1024>
+class BufferedSink
+{
+  public:
+    explicit BufferedSink(TWriter writer) : m_writer(writer) {}
+    BufferedSink(const BufferedSink&)            = delete;
+    BufferedSink& operator=(const BufferedSink&) = delete;
+    ~BufferedSink() { Flush(); }
+
+    BufferedSink& operator<<(std::string_view str)
+    {
+        if (str.size() > BufferSize - m_size)
+        {
+            Flush();
+            if (str.size() > BufferSize)
+            {
+                m_writer.Write(str.data(), str.size());
+                return *this;
+            }
+        }
+        str.copy(m_buffer.data() + m_size, str.size());
+        m_size += str.size();
+        return *this;
+    }
+
+    BufferedSink& operator<<(char chr)
+    {
+        if (m_size == BufferSize)
+            Flush();
+        m_buffer[m_size++] = chr;
+        return *this;
+    }
+
+    template <typename TNumber>
+        requires std::is_arithmetic_v<TNumber>
+    BufferedSink& operator<<(TNumber number)
+    {
+        std::array<char, 64> chars;
+        std::to_chars_result res;
+        if constexpr (std::is_floating_point_v<TNumber>)
+            res = std::to_chars(chars.data(), chars.data() + chars.size(), number, std::chars_format::fixed, 6);
+        else
+            res = std::to_chars(chars.data(), chars.data() + chars.size(), number);
+        return *this << std::string_view(chars.data(), res.ptr - chars.data());
+    }
+
+    /**
+     * \~english
+     * @brief Pass buffered data to the writer
+     *
+     * @return false if the writer has failed on this or any earlier write
+     */
+    /**
+     * \~russian
+     * @brief Передать буферизованные данные писателю
+     *
+     * @return ложь, если писатель не справился с этой или любой более ранней записью
+     */
+    bool Flush()
+    {
+        if (m_size != 0)
+        {
+            m_writer.Write(m_buffer.data(), m_size);
+            m_size = 0;
+        }
+        return m_writer.Ok();
+    }
+
+    const TWriter& Writer() const { return m_writer; }
+
+  private:
+    TWriter m_writer;
+    std::array<char, BufferSize> m_buffer;
+    size_t m_size = 0;
+};
+
+/**
+ * \~english
+ * @brief Flush a sink and report whether everything written to it has reached its destination
+ *
+ * Buffered sinks report their writer state, standard streams report their stream state, other sinks are trusted.
+ */
+/**
+ * \~russian
+ * @brief Сбросить приёмник и сообщить, достигло ли всё записанное в него места назначения
+ *
+ * Буферизованные приёмники сообщают состояние своего писателя, стандартные потоки - состояние потока, остальным
+ * приёмникам доверяем.
+ */
+template <typename TSink>
+bool FlushSink(TSink& sink)
+{
+    if constexpr (requires { { sink.Flush() } -> std::same_as<bool>; })
+        return sink.Flush();
+    else if constexpr (requires { sink.flush().good(); })
+        return sink.flush().good();
+    else
+        return true;
+}
+
+/**
+ * \~english
+ * @brief Write node id, integral ids are formatted without temporary strings
+ */
+/**
+ * \~russian
+ * @brief Записать идентификатор вершины, целочисленные идентификаторы форматируются без временных строк
+ */
+template <typename TSink, typename TNodeId>
+void WriteNodeId(TSink& sink, const TNodeId& id)
+{
+    if constexpr (std::is_integral_v<TNodeId>)
+        sink << id;
+    else
+        sink << Id2Str(id);
+}
+
+/**
+ * \~english
+ * @brief Write nodes and edges of a graph in DOT language
+ *
+ * @tparam ForceArrows write every edge as directed
+ * @param graph graph
+ * @param sink output sink
+ * @param node_printer function returning node label or writing it into the sink given as the second argument
+ */
+/**
+ * \~russian
+ * @brief Записать вершины и рёбра графа на языке DOT
+ *
+ * @tparam ForceArrows записывать каждое ребро как направленное
+ * @param graph граф
+ * @param sink выходной приёмник
+ * @param node_printer функция, возвращающая метку вершины или записывающая её в приёмник, переданный вторым аргументом
+ */
+template <bool ForceArrows = false, typename TGraph, typename TSink, typename TNodePrinter>
+void WriteDOT_Body(const TGraph& graph, TSink& sink, TNodePrinter node_printer)
+{
+    using Node_t = typename TGraph::Node_t;
+    for (const auto& node_el : graph.Nodes())
+    {
+        const auto node = node_el.second;
+        sink << reinterpret_cast<uint64_t>(node) << " [label=\"";
+        if constexpr (std::is_invocable_v<TNodePrinter, Node_t*, TSink&>)
+            node_printer(node, sink);
+        else
+            sink << node_printer(node);
+        sink << "\"];\n";
+    }
+    for (const auto edge : graph.Edges())
+    {
+        sink << reinterpret_cast<uint64_t>(edge->Nodes().first);
+        if constexpr (ForceArrows)
+            sink << " -> ";
+        else if constexpr (TGraph::IsDirected)
+            sink << (edge->Directed() ? " -> " : " -- ");
+        else
+            sink << " -- ";
+        sink << reinterpret_cast<uint64_t>(edge->Nodes().second) << ";\n";
+    }
+}
+
+template <bool ForceArrows = false, typename TGraph, typename TSink>
+void WriteDOT_Body(const TGraph& graph, TSink& sink)
+{
+    WriteDOT_Body<ForceArrows>(graph, sink,
+                               [](typename TGraph::Node_t* node, TSink& sink) { WriteNodeId(sink, node->Id()); });
+}
+
+/**
+ * \~english
+ * @brief Write a graph in DOT language
+ *
+ * @param graph graph
+ * @param sink output sink
+ * @param node_printer optional node label printer, see WriteDOT_Body
+ * @return false if the output could not be written completely, see FlushSink
+ */
+/**
+ * \~russian
+ * @brief Записать граф на языке DOT
+ *
+ * @param graph граф
+ * @param sink выходной приёмник
+ * @param node_printer необязательный печатающий метку вершины, см. WriteDOT_Body
+ * @return ложь, если вывод не удалось записать полностью, см. FlushSink
+ */
+template <typename TGraph, typename TSink, typename... TNodePrinter>
+bool WriteDOT(const TGraph& graph, TSink& sink, TNodePrinter... node_printer)
+{
+    if constexpr (TGraph::IsDirected)
+        sink << "di";
+    sink << "graph \"" << graph.GetName() << "\" {\n";
+    WriteDOT_Body(graph, sink, node_printer...);
+    sink << "}\n";
+    return FlushSink(sink);
+}
+
+/**
+ * \~english
+ * @brief Write a graph in DOT language for the LaTeX graphviz package, all edges are written as directed
+ *
+ * @param graph graph
+ * @param sink output sink
+ * @return false if the output could not be written completely, see FlushSink
+ */
+/**
+ * \~russian
+ * @brief Записать граф на языке DOT для пакета LaTeX graphviz, все рёбра записываются как направленные
+ *
+ * @param graph граф
+ * @param sink выходной приёмник
+ * @return ложь, если вывод не удалось записать полностью, см. FlushSink
+ */
+template <typename TGraph, typename TSink>
+bool WriteLatexDOT(const TGraph& graph, TSink& sink)
+{
+    sink << R"GG(\digraph{)GG" << graph.GetName() << abs(rand()) << "}{\n";
+    sink << "rankdir=TB;\n";
+    WriteDOT_Body<true>(graph, sink);
+    sink << "}\n";
+    return FlushSink(sink);
+}
+
+template <typename TGraph, typename TSink, typename TNodePrinter>
+bool WriteLatexDOT(const TGraph& graph, TSink& sink, TNodePrinter node_printer)
+{
+    if constexpr (TGraph::IsDirected)
+        sink << R"GG(\digraph{)GG";
+    else
+        sink << R"GG(\graph{)GG";
+    sink << graph.GetName() << "{\n";
+    sink << "rankdir=LR;\n";
+    WriteDOT_Body(graph, sink, node_printer);
+    sink << "}\n";
+    return FlushSink(sink);
+}
+
+/**
+ * \~english
+ * @brief Write string description of a graph
+ *
+ * @param graph graph
+ * @param sink output sink
+ * @return false if the output could not be written completely, see FlushSink
+ */
+/**
+ * \~russian
+ * @brief Записать строковое описание графа
+ *
+ * @param graph граф
+ * @param sink выходной приёмник
+ * @return ложь, если вывод не удалось записать полностью, см. FlushSink
+ */
+template <typename TGraph, typename TSink>
+bool WriteStr(const TGraph& graph, TSink& sink)
+{
+    sink << "GraphInclusive(" << graph.GetName() << ")\n";
+    for (const auto& node_el : graph.Nodes())
+    {
+        const auto node = node_el.second;
+        sink << "Node ";
+        WriteNodeId(sink, node->Id());
+        sink << " edges ";
+        for (const auto& edge : node->Edges())
+        {
+            const bool forward = (edge->Nodes().first == node);
+            if constexpr (TGraph::IsDirected)
+            {
+                if (edge->Directed())
+                    sink << (forward ? "->" : "<-");
+            }
+            WriteNodeId(sink, edge->OtherNode(node)->Id());
+            if constexpr (TGraph::IsWeighted)
+            {
+                if (edge->Weight() != 1.0)
+                    sink << edge->Weight();
+            }
+            sink << ' ';
+        }
+        sink << '\n';
+    }
+    return FlushSink(sink);
+}
+
+}  // namespace GG
@@ -0,0 +1,141 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Lazy range of values produced by a coroutine with co_yield
+ *
+ * The coroutine runs only when the range is advanced and stops right after the next co_yield, so the caller decides
+ * when the work is done. The range can be iterated once.
+ *
+ * @tparam T value type
+ */
+/**
+ * \~russian
+ * @brief Ленивый диапазон значений, производимых сопрограммой через co_yield
+ *
+ * Сопрограмма выполняется только при продвижении диапазона и останавливается сразу после следующего co_yield, поэтому
+ * вызывающий решает, когда выполняется работа. Диапазон можно пройти один раз.
+ *
+ * @tparam T тип значения
+ */
+template <typename T>
+class Generator
+{
+  public:
+    struct promise_type {
+        std::optional<T> value;
+
+        Generator get_return_object() { return Generator(Handle_t::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T yielded)
+        {
+            value = std::move(yielded);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    using Handle_t = std::coroutine_handle<promise_type>;
+
+    class iterator
+    {
+      public:
+        using value_type      = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(Handle_t handle) : m_handle(handle) {}
+
+        const T& operator*() const { return *m_handle.promise().value; }
+        const T* operator->() const { return &*m_handle.promise().value; }
+
+        iterator& operator++()
+        {
+            m_handle.resume();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return not m_handle or m_handle.done(); }
+
+      private:
+        Handle_t m_handle;
+    };
+
+    Generator(const Generator&)            = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    ~Generator()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    /**
+     * \~english
+     * @brief Run the coroutine up to its first value
+     */
+    /**
+     * \~russian
+     * @brief Выполнить сопрограмму до её первого значения
+     */
+    iterator begin()
+    {
+        m_handle.resume();
+        return iterator(m_handle);
+    }
+    std::default_sentinel_t end() const { return {}; }
+
+    /**
+     * \~english
+     * @brief Run the coroutine up to its next value, convenient outside of loops
+     *
+     * @return true if a value is produced, false if the coroutine is finished
+     */
+    /**
+     * \~russian
+     * @brief Выполнить сопрограмму до её следующего значения, удобно вне циклов
+     *
+     * @return true, если значение произведено, false, если сопрограмма завершена
+     */
+    bool Resume()
+    {
+        if (m_handle.done())
+            return false;
+        m_handle.resume();
+        return not m_handle.done();
+    }
+
+    const T& Value() const { return *m_handle.promise().value; }
+
+  private:
+    explicit Generator(Handle_t handle) : m_handle(handle) {}
+
+    Handle_t m_handle;
+};
+
+}  // namespace GG
@@ -3,13 +3,21 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <ranges>
+#include <span>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "./common.h"
+#include "./export.h"
+#include "./hash.h"
+#include "./properties/edge_index.h"
+#include "./properties/journal.h"
 
 namespace GG
 {
@@ -17,6 +25,21 @@ namespace GG
 template <typename R, typename... Args>
 R return_type_of(R (*)(Args...));
 
+/**
+ * \~english
+ * @brief Default map from node id to node of GraphInclusive
+ *
+ * @tparam TNode node type
+ */
+/**
+ * \~russian
+ * @brief Отображение идентификатора вершины в вершину GraphInclusive по умолчанию
+ *
+ * @tparam TNode тип вершины
+ */
+template <typename TNode>
+using DefaultNodeMap = std::unordered_map<typename TNode::NodeId_t, TNode*, NodeIdHash<typename TNode::NodeId_t>>;
+
 /**
  * \~english
  * @brief Graph class that stores nodes and edges
@@ -26,6 +49,9 @@ R return_type_of(R (*)(Args...));
  * @tparam TEdge edge type
  * @tparam TDirected directed graph property
  * @tparam TWeighted weighted graph property
+ * @tparam TNodeMap map from node id to node, std::unordered_map or FlatHashMap with any hash policy
+ * @tparam TJournal mutation journal property
+ * @tparam TEdgeIndex edge index property
  */
 /**
  * \~russian
@@ -36,13 +62,26 @@ R return_type_of(R (*)(Args...));
  * @tparam TEdge тип ребра
  * @tparam TDirected свойство направленности графа
  * @tparam TWeighted свойство взвешенности графа
+ * @tparam TNodeMap отображение идентификатора вершины в вершину, std::unordered_map или FlatHashMap с любой политикой
+ * хеширования
+ * @tparam TJournal свойство журнала изменений
+ * @tparam TEdgeIndex свойство индекса рёбер
  */
 template <typename TNode, typename TEdge, typename TDirected, typename TWeighted, typename TConnectedComponentWatch,
-          typename TNamed>
-class GraphInclusive : public TDirected, public TWeighted, public TNamed, public TConnectedComponentWatch
+          typename TNamed, typename TNodeMap = DefaultNodeMap<TNode>, typename TJournal = Journal<TNode, TEdge, false>,
+          typename TEdgeIndex = EdgeIndex<TNode, TEdge, false>>
+class GraphInclusive : public TDirected,
+                       public TWeighted,
+                       public TNamed,
+                       public TConnectedComponentWatch,
+                       public TJournal,
+                       public TEdgeIndex
 {
   public:
-    using TNodeId = TNode::NodeId_t;
+    using TNodeId   = TNode::NodeId_t;
+    using Node_t    = TNode;
+    using Edge_t    = TEdge;
+    using NodeMap_t = TNodeMap;
 
     GraphInclusive() = default;
 
@@ -56,7 +95,36 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         return node;
     }
 
-    const std::unordered_map<TNodeId, TNode*>& Nodes() const { return m_nodes; }
+    const TNodeMap& Nodes() const { return m_nodes; }
+    const std::unordered_set<TEdge*>& Edges() const { return m_edges; }
+
+    /**
+     * \~english
+     * @brief Get graph version, it changes with every node or edge addition and deletion
+     * 
+     * @return graph version
+     */
+    /**
+     * \~russian
+     * @brief Получить версию графа, она меняется при каждом добавлении и удалении вершины или ребра
+     * 
+     * @return версия графа
+     */
+    uint64_t Version() const { return m_version; }
+
+    /**
+     * \~english
+     * @brief Get statistics of the node id hash table
+     * 
+     * @return statistics
+     */
+    /**
+     * \~russian
+     * @brief Получить статистику хеш-таблицы идентификаторов вершин
+     * 
+     * @return статистика
+     */
+    HashStats NodesHashStats() const { return CollectHashStats(m_nodes); }
 
     TEdge* MakeEdge(TNodeId node1_id, TNodeId node2_id, bool directed = false)
     {
@@ -69,8 +137,31 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         return MakeEdge(node1, node2, directed);
     }
 
+    /**
+     * \~english
+     * @brief Make an edge between two nodes of the graph
+     *
+     * @param node1 first node
+     * @param node2 second node
+     * @param directed the edge goes from the first node to the second one only
+     * @return edge made or nullptr if the graph is simple and the nodes are already connected so
+     */
+    /**
+     * \~russian
+     * @brief Создать ребро между двумя вершинами графа
+     *
+     * @param node1 первая вершина
+     * @param node2 вторая вершина
+     * @param directed ребро идёт только от первой вершины ко второй
+     * @return созданное ребро или nullptr, если граф простой и вершины уже так связаны
+     */
     TEdge* MakeEdge(TNode* node1, TNode* node2, bool directed = false)
     {
+        if constexpr (TEdgeIndex::IsSimpleGraph)
+        {
+            if (Duplicates(node1, node2, directed))
+                return nullptr;
+        }
         auto* edge = new TEdge(node1, node2, directed);
         node1->AddEdge(edge);
         node2->AddEdge(edge);
@@ -78,6 +169,170 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         return edge;
     }
 
+    /**
+     * \~english
+     * @brief Load many edges at once
+     *
+     * Nodes are created for unknown ids, edge storage is reserved once and connected components are recomputed once at
+     * the end instead of after every edge. A simple graph skips records duplicating existing connections.
+     *
+     * @param edges range of records with fields node1, node2, weight and directed
+     * @param nodes ids of nodes to create even if they have no edges
+     */
+    /**
+     * \~russian
+     * @brief Загрузить много рёбер за раз
+     *
+     * Вершины создаются для неизвестных идентификаторов, память для рёбер резервируется один раз, а компоненты
+     * связности пересчитываются один раз в конце, а не после каждого ребра. Простой граф пропускает записи,
+     * дублирующие существующие связи.
+     *
+     * @param edges диапазон записей с полями node1, node2, weight и directed
+     * @param nodes идентификаторы вершин, создаваемых даже при отсутствии рёбер
+     */
+    template <typename TEdgeRecords, typename TNodeIds = std::vector<TNodeId>>
+    void LoadEdges(const TEdgeRecords& edges, const TNodeIds& nodes = {})
+    {
+        auto find_or_make = [&](const TNodeId& id) {
+            const auto node_it = m_nodes.find(id);
+            if (node_it != m_nodes.end())
+                return node_it->second;
+            auto node = new TNode(id);
+            m_nodes.emplace(id, node);
+            TJournal::onAdd(node);
+            return node;
+        };
+
+        BeginBulkUpdate();
+        m_nodes.reserve(m_nodes.size() + std::size(nodes));
+        for (const auto& id : nodes)
+            find_or_make(id);
+        m_edges.reserve(m_edges.size() + std::size(edges));
+        TEdgeIndex::ReserveEdges(m_edges.size() + std::size(edges));
+        // edge lists are usually sorted by the first node, so it is looked up once per run of records
+        TNode* node1 = nullptr;
+        for (const auto& record : edges)
+        {
+            if ((node1 == nullptr) or not(node1->Id() == record.node1))
+                node1 = find_or_make(record.node1);
+            auto node2 = find_or_make(record.node2);
+            if constexpr (TEdgeIndex::IsSimpleGraph)
+            {
+                if (Duplicates(node1, node2, record.directed))
+                    continue;
+            }
+            auto* edge = new TEdge(node1, node2, record.directed);
+            if constexpr (TWeighted::IsWeighted)
+                edge->SetWeight(record.weight);
+            node1->AddEdge(edge);
+            node2->AddEdge(edge);
+            m_edges.insert(edge);
+            TJournal::onAdd(edge);
+            TEdgeIndex::onAdd(edge);
+        }
+        ++m_version;
+        EndBulkUpdate();
+    }
+
+    /**
+     * \~english
+     * @brief Take ownership of nodes and edges built outside the graph, e.g. by ParallelBuilder
+     *
+     * Edges must already be in the adjacency lists of their nodes, node ids must be new to the graph. Everything is
+     * added with one bulk update. Entries of node maps of the same type as the graph one are spliced without
+     * allocation, large edge sets are hashed on a second thread meanwhile. Journaling and recomputation of connected
+     * components stay serial.
+     *
+     * @param node_maps range of maps from node id to node, they are left empty
+     * @param edges range of edge pointers between the given nodes or nodes of the graph
+     */
+    /**
+     * \~russian
+     * @brief Принять во владение вершины и рёбра, созданные вне графа, например ParallelBuilder
+     *
+     * Рёбра уже должны быть в списках смежности своих вершин, идентификаторы вершин должны быть новыми для графа. Всё
+     * добавляется одним групповым изменением. Элементы отображений вершин того же типа, что и в графе, переносятся без
+     * выделения памяти, большие множества рёбер тем временем хешируются вторым потоком. Запись в журнал и пересчёт
+     * компонент связности остаются последовательными.
+     *
+     * @param node_maps диапазон отображений идентификатора вершины в вершину, они остаются пустыми
+     * @param edges диапазон указателей на рёбра между данными вершинами или вершинами графа
+     */
+    template <typename TNodeMaps, typename TEdges>
+    void Adopt(TNodeMaps&& node_maps, const TEdges& edges)
+    {
+        static constexpr size_t ParallelEdgesMin = 1 << 16;
+
+        BeginBulkUpdate();
+        size_t nodes_count = m_nodes.size();
+        for (const auto& node_map : node_maps)
+            nodes_count += node_map.size();
+        const auto edges_count = static_cast<size_t>(std::ranges::distance(edges));
+        m_nodes.reserve(nodes_count);
+        m_edges.reserve(m_edges.size() + edges_count);
+        TEdgeIndex::ReserveEdges(m_edges.size() + edges_count);
+        // the edge set and index do not look at the node map, so they are filled while nodes are moved
+        auto add_edges = [this, &edges]() {
+            for (auto edge : edges)
+            {
+                m_edges.insert(edge);
+                TEdgeIndex::onAdd(edge);
+            }
+        };
+        {
+            std::jthread edges_thread;
+            if (edges_count >= ParallelEdgesMin)
+                edges_thread = std::jthread(add_edges);
+            for (auto& node_map : node_maps)
+            {
+                for (const auto& node_el : node_map)
+                    TJournal::onAdd(node_el.second);
+                if constexpr (requires { m_nodes.merge(node_map); })
+                {
+                    m_nodes.merge(node_map);
+                    GRAPH_DEBUG_ASSERT(node_map.empty(), "Node id already in graph");
+                }
+                else
+                {
+                    for (const auto& node_el : node_map)
+                    {
+                        [[maybe_unused]] const bool added = m_nodes.emplace(node_el.first, node_el.second).second;
+                        GRAPH_DEBUG_ASSERT(added, "Node id already in graph");
+                    }
+                    node_map.clear();
+                }
+            }
+            if (not edges_thread.joinable())
+                add_edges();
+        }
+        for (auto edge : edges)
+            TJournal::onAdd(edge);
+        ++m_version;
+        EndBulkUpdate();
+    }
+
+    /**
+     * \~english
+     * @brief Set edge weight, unlike Edge::SetWeight the change is journaled
+     *
+     * @param edge edge
+     * @param weight weight
+     */
+    /**
+     * \~russian
+     * @brief Установить вес ребра, в отличие от Edge::SetWeight изменение записывается в журнал
+     *
+     * @param edge ребро
+     * @param weight вес
+     */
+    void SetWeight(TEdge* edge, float weight)
+        requires TWeighted::IsWeighted
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        TJournal::onSetWeight(edge, weight);
+        edge->SetWeight(weight);
+    }
+
     void Del(const TNodeId& id)
     {
         const auto node_it = m_nodes.find(id);
@@ -93,16 +348,41 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         if (node_it == m_nodes.end())
             return;
         GRAPH_DEBUG_ASSERT(node == node_it->second, "Wrong nodes in graph");
-        std::vector<TEdge*> edges = node->Edges();
+        const std::vector<TEdge*> edges(node->Edges().begin(), node->Edges().end());
         for (auto edge : edges)
         {
-            Del(edge);
+            // a loop is listed twice at its node
+            if (m_edges.contains(edge))
+                Del(edge);
         }
         m_nodes.erase(node_it);
-        TConnectedComponentWatch::onDel(node);
+        ++m_version;
+        if (m_bulk_update == 0)
+            TConnectedComponentWatch::onDel(node);
+        TJournal::onDel(node);
         delete node;
     }
 
+    /**
+     * \~english
+     * @brief Delete an edge
+     *
+     * The edge is found in the set of edges and the edge index in constant time, but it is removed from the adjacency
+     * lists of both its nodes by a scan that keeps their order and out-in partitions, so deletion takes O(degree) of
+     * the nodes.
+     *
+     * @param edge edge
+     */
+    /**
+     * \~russian
+     * @brief Удалить ребро
+     *
+     * Ребро находится в множестве рёбер и индексе рёбер за постоянное время, но удаляется из списков смежности обеих
+     * своих вершин просмотром, сохраняющим их порядок и разбиение на исходящие и входящие, поэтому удаление занимает
+     * O(степени) вершин.
+     *
+     * @param edge ребро
+     */
     void Del(TEdge* edge)
     {
         GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
@@ -117,7 +397,11 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         GRAPH_DEBUG_ASSERT(Find(node2->Id()) == node2, "No node in graph");
         node2->DelEdge(edge);
         m_edges.erase(edge);
-        TConnectedComponentWatch::onDel(edge);
+        TEdgeIndex::onDel(edge);
+        ++m_version;
+        if (m_bulk_update == 0)
+            TConnectedComponentWatch::onDel(edge);
+        TJournal::onDel(edge);
         delete edge;
     }
 
@@ -132,30 +416,29 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         DelEdgesTo(node_from, node_to);
     }
 
+    /**
+     * \~english
+     * @brief Delete edges that can be passed from one node to another
+     *
+     * Edges are found as by FindEdge, each of them is deleted in O(degree) of the nodes, see Del.
+     *
+     * @param node_from node from
+     * @param node_to node to
+     */
+    /**
+     * \~russian
+     * @brief Удалить рёбра, по которым можно пройти из одной вершины в другую
+     *
+     * Рёбра находятся как в FindEdge, каждое из них удаляется за O(степени) вершин, см. Del.
+     *
+     * @param node_from вершина откуда
+     * @param node_to вершина куда
+     */
     void DelEdgesTo(TNode* node_from, TNode* node_to)
     {
         GRAPH_DEBUG_ASSERT(node_from != nullptr, "Null node from");
         GRAPH_DEBUG_ASSERT(node_to != nullptr, "Null node to");
-        auto edges = node_from->Edges();
-        std::vector<TEdge> edges_to_delete;
-        edges_to_delete.reserve(edges.size());
-        for (auto edge : edges)
-        {
-            if (TDirected::GetDirected(edge))
-            {
-                if (edge->Nodes().second == node_to)
-                    edges_to_delete.push_back(edge);
-            }
-            else
-            {
-                if ((edge->Nodes().second == node_from) or (edge->Nodes().second == node_to))
-                    edges_to_delete.push_back(edge);
-            }
-        }
-        for (auto edge : edges_to_delete)
-        {
-            Del(edge);
-        }
+        DelEdges(EdgesTo(node_from, node_to));
     }
 
     void DelEdgesBetween(TNodeId node1_id, TNodeId node2_id)
@@ -169,23 +452,147 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
         DelEdgesBetween(node1, node2);
     }
 
+    /**
+     * \~english
+     * @brief Delete all edges between two nodes in any direction
+     *
+     * Edges are found as by FindEdge, each of them is deleted in O(degree) of the nodes, see Del.
+     *
+     * @param node1 first node
+     * @param node2 second node
+     */
+    /**
+     * \~russian
+     * @brief Удалить все рёбра между двумя вершинами в любом направлении
+     *
+     * Рёбра находятся как в FindEdge, каждое из них удаляется за O(степени) вершин, см. Del.
+     *
+     * @param node1 первая вершина
+     * @param node2 вторая вершина
+     */
     void DelEdgesBetween(TNode* node1, TNode* node2)
     {
         GRAPH_DEBUG_ASSERT(node1 != nullptr, "Null node 1");
         GRAPH_DEBUG_ASSERT(node2 != nullptr, "Null node 2");
-        auto edges = node1->Edges();
-        std::vector<TEdge*> edges_to_delete;
-        edges_to_delete.reserve(edges.size());
-        for (auto edge : edges)
-        {
-            if (((edge->Nodes().first == node1) and (edge->Nodes().second == node2)) or
-                ((edge->Nodes().first == node2) and (edge->Nodes().second == node1)))
-                edges_to_delete.push_back(edge);
-        }
-        for (auto edge : edges_to_delete)
-        {
-            Del(edge);
-        }
+        std::vector<TEdge*> edges;
+        auto collect = [&](TEdge* edge) { edges.push_back(edge); };
+        TEdgeIndex::ForEachStoredEdge(node1, node2, collect);
+        if (node1 != node2)
+            TEdgeIndex::ForEachStoredEdge(node2, node1, collect);
+        DelEdges(std::move(edges));
+    }
+
+    /**
+     * \~english
+     * @brief Find an edge that can be passed from one node to another
+     *
+     * Takes constant time with an indexed TEdgeIndex, otherwise scans the edges of the node of lower degree.
+     *
+     * @param node_from node the edge is passed from
+     * @param node_to node the edge is passed to
+     * @return edge found or nullptr
+     */
+    /**
+     * \~russian
+     * @brief Найти ребро, по которому можно пройти от одной вершины к другой
+     *
+     * Занимает постоянное время с индексирующим TEdgeIndex, иначе просматривает рёбра вершины меньшей степени.
+     *
+     * @param node_from вершина, от которой проходится ребро
+     * @param node_to вершина, к которой проходится ребро
+     * @return найденное ребро или nullptr
+     */
+    TEdge* FindEdge(TNode* node_from, TNode* node_to) const
+    {
+        GRAPH_DEBUG_ASSERT(node_from != nullptr, "Null node from");
+        GRAPH_DEBUG_ASSERT(node_to != nullptr, "Null node to");
+        TEdge* found = nullptr;
+        TEdgeIndex::ForEachStoredEdge(node_from, node_to, [&](TEdge* edge) { found = edge; });
+        if (found != nullptr)
+            return found;
+        TEdgeIndex::ForEachStoredEdge(node_to, node_from, [&](TEdge* edge) {
+            if (not TDirected::GetDirected(edge))
+                found = edge;
+        });
+        return found;
+    }
+
+    TEdge* FindEdge(const TNodeId& node_from_id, const TNodeId& node_to_id) const
+    {
+        auto node_from = Find(node_from_id);
+        if (node_from == nullptr)
+            return nullptr;
+        auto node_to = Find(node_to_id);
+        if (node_to == nullptr)
+            return nullptr;
+        return FindEdge(node_from, node_to);
+    }
+
+    bool HasEdge(TNode* node_from, TNode* node_to) const { return FindEdge(node_from, node_to) != nullptr; }
+
+    bool HasEdge(const TNodeId& node_from_id, const TNodeId& node_to_id) const
+    {
+        return FindEdge(node_from_id, node_to_id) != nullptr;
+    }
+
+    /**
+     * \~english
+     * @brief Start a bulk update: connected components are not tracked until it ends
+     *
+     * Bulk updates nest, e.g. LoadEdges inside an outer bulk update, components are recomputed when the outermost one
+     * ends.
+     */
+    /**
+     * \~russian
+     * @brief Начать групповое изменение: компоненты связности не отслеживаются до его окончания
+     *
+     * Групповые изменения вкладываются, например LoadEdges внутри внешнего группового изменения, компоненты
+     * пересчитываются по окончании самого внешнего.
+     */
+    void BeginBulkUpdate() { ++m_bulk_update; }
+
+    /**
+     * \~english
+     * @brief End a bulk update and recompute connected components once
+     *
+     * @param rebuild_components recompute components, otherwise they stay stale until the caller assigns them, e.g. by
+     * BootstrapComponents
+     */
+    /**
+     * \~russian
+     * @brief Закончить групповое изменение и однократно пересчитать компоненты связности
+     *
+     * @param rebuild_components пересчитать компоненты, иначе они остаются устаревшими, пока вызывающий не назначит их,
+     * например BootstrapComponents
+     */
+    void EndBulkUpdate(bool rebuild_components = true)
+    {
+        GRAPH_DEBUG_ASSERT(m_bulk_update > 0, "Bulk update not started");
+        --m_bulk_update;
+        if ((m_bulk_update == 0) and rebuild_components)
+            TConnectedComponentWatch::Rebuild(m_nodes);
+    }
+
+    bool InBulkUpdate() const { return (m_bulk_update > 0); }
+
+    /**
+     * \~english
+     * @brief Set connected components computed elsewhere, e.g. by ParallelConnectedComponents
+     *
+     * @param components dense component label of every node in the order of Nodes()
+     * @param count count of components
+     */
+    /**
+     * \~russian
+     * @brief Задать компоненты связности, вычисленные в другом месте, например ParallelConnectedComponents
+     *
+     * @param components плотная метка компоненты каждой вершины в порядке Nodes()
+     * @param count количество компонент
+     */
+    void AssignComponents(std::span<const int32_t> components, int count)
+    {
+        GRAPH_DEBUG_ASSERT(m_bulk_update == 0, "Bulk update not ended");
+        TConnectedComponentWatch::AssignComponents(m_nodes, components, count);
     }
 
     /**
@@ -217,7 +624,7 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
                 return false;
             for (const auto edge : node->Edges())
             {
-                if (std::find(m_edges.begin(), m_edges.end(), edge) == m_edges.end())
+                if (not m_edges.contains(edge))
                     return false;
             }
         }
@@ -251,24 +658,18 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
             delete edge;
         }
         m_edges.clear();
+        ++m_version;
         TConnectedComponentWatch::Clear();
+        TJournal::onClear();
+        TEdgeIndex::onClear();
     }
 
     std::string ToDOT_Body() const
     {
         std::string str;
-        for (const auto& node_el : m_nodes)
         {
-            const auto& node = node_el.second;
-            str += std::to_string(reinterpret_cast<u_int64_t>(node)) + " [label=\"" + Id2Str(node->Id()) + "\"];\n";
-        }
-        for (const auto& edge : m_edges)
-        {
-            const auto node1           = edge->Nodes().first;
-            const auto node2           = edge->Nodes().second;
-            const std::string edge_str = TDirected::GetDirected(edge) ? " -> " : " -- ";
-            str += std::to_string(reinterpret_cast<u_int64_t>(node1)) + edge_str +
-                   std::to_string(reinterpret_cast<u_int64_t>(node2)) + ";\n";
+            BufferedSink sink{StringWriter(&str)};
+            WriteDOT_Body(*this, sink);
         }
         return str;
     }
@@ -276,18 +677,9 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
     std::string ToDOT_Body(std::function<std::string(TNode*)> node_printer) const
     {
         std::string str;
-        for (const auto& node_el : m_nodes)
-        {
-            const auto& node = node_el.second;
-            str += std::to_string(reinterpret_cast<u_int64_t>(node)) + " [label=\"" + node_printer(node) + "\"];\n";
-        }
-        for (const auto& edge : m_edges)
         {
-            const auto node1           = edge->Nodes().first;
-            const auto node2           = edge->Nodes().second;
-            const std::string edge_str = TDirected::GetDirected(edge) ? " -> " : " -- ";
-            str += std::to_string(reinterpret_cast<u_int64_t>(node1)) + edge_str +
-                   std::to_string(reinterpret_cast<u_int64_t>(node2)) + ";\n";
+            BufferedSink sink{StringWriter(&str)};
+            WriteDOT_Body(*this, sink, node_printer);
         }
         return str;
     }
@@ -295,69 +687,40 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
     std::string ToDOT() const
     {
         std::string str;
-        if (TDirected::IsDirected)
-            str += "di";
-        str += "graph \"";
-        str += TNamed::GetName();
-        str += "\" {\n";
-        str += ToDOT_Body();
-        str += "}\n";
+        {
+            BufferedSink sink{StringWriter(&str)};
+            WriteDOT(*this, sink);
+        }
         return str;
     }
 
     std::string ToDOT(std::function<std::string(TNode*)> node_printer) const
     {
         std::string str;
-        if (TDirected::IsDirected)
-            str += "di";
-        str += "graph \"";
-        str += TNamed::GetName();
-        str += "\" {\n";
-        str += ToDOT_Body(node_printer);
-        str += "}\n";
+        {
+            BufferedSink sink{StringWriter(&str)};
+            WriteDOT(*this, sink, node_printer);
+        }
         return str;
     }
 
     std::string ToLatexDOT() const
     {
         std::string str;
-        /*
-        if (TDirected::IsDirected)
-            str += R"GG(\digraph{)GG";
-        else
-            str += R"GG(\graph{)GG";
-        */
-        str += R"GG(\digraph{)GG";
-        str += TNamed::GetName() + std::to_string(abs(rand()));
-        str += "}{\n";
-        str += "rankdir=TB;\n";
-        str += ToDOT_Body();
-        str += "}\n";
-
-        const std::string replace_word = " -- ";
-        const std::string replace_by   = " -> ";
-        size_t pos                     = str.find(replace_word);
-        while (pos != std::string::npos)
         {
-            str.replace(pos, replace_word.size(), replace_by);
-            pos = str.find(replace_word, pos + replace_by.size());
+            BufferedSink sink{StringWriter(&str)};
+            WriteLatexDOT(*this, sink);
         }
-
         return str;
     }
 
     std::string ToLatexDOT(std::function<std::string(TNode*)> node_printer) const
     {
         std::string str;
-        if (TDirected::IsDirected)
-            str += R"GG(\digraph{)GG";
-        else
-            str += R"GG(\graph{)GG";
-        str += TNamed::GetName();
-        str += "{\n";
-        str += "rankdir=LR;\n";
-        str += ToDOT_Body(node_printer);
-        str += "}\n";
+        {
+            BufferedSink sink{StringWriter(&str)};
+            WriteLatexDOT(*this, sink, node_printer);
+        }
         return str;
     }
 
@@ -375,17 +738,10 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
      */
     std::string ToStr() const
     {
-        std::string str{"GraphInclusive("};
-        str += TNamed::GetName();
-        str += ")\n";
-        std::array<char, 256> strbuf;
-        for (const auto& node_el : m_nodes)
+        std::string str;
         {
-            const auto& node = node_el.second;
-            snprintf(strbuf.data(), strbuf.size(), "Node %s ", node->ToStr().c_str());
-            str.append(strbuf.data());
-            str.append(ToStrNodeEdges(node));
-            str += "\n";
+            BufferedSink sink{StringWriter(&str)};
+            WriteStr(*this, sink);
         }
         return str;
     }
@@ -400,7 +756,10 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
     {
         GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
         m_nodes.emplace(node->Id(), node);
-        TConnectedComponentWatch::onAdd(node);
+        ++m_version;
+        if (m_bulk_update == 0)
+            TConnectedComponentWatch::onAdd(node);
+        TJournal::onAdd(node);
     }
 
     /**
@@ -412,33 +771,66 @@ class GraphInclusive : public TDirected, public TWeighted, public TNamed, public
     {
         GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
         m_edges.insert(edge);
-        TConnectedComponentWatch::onAdd(edge);
+        TEdgeIndex::onAdd(edge);
+        ++m_version;
+        if (m_bulk_update == 0)
+            TConnectedComponentWatch::onAdd(edge);
+        TJournal::onAdd(edge);
     }
 
-    std::string ToStrNodeEdges(TNode* node) const
+    /**
+     * @brief Get edges that can be passed from one node to another
+     *
+     * @param node_from node the edges are passed from
+     * @param node_to node the edges are passed to
+     * @return edges
+     */
+    std::vector<TEdge*> EdgesTo(TNode* node_from, TNode* node_to) const
     {
-        std::string str{"edges "};
-        for (const auto& edge : node->Edges())
+        std::vector<TEdge*> edges;
+        TEdgeIndex::ForEachStoredEdge(node_from, node_to, [&](TEdge* edge) { edges.push_back(edge); });
+        if (node_from != node_to)
         {
-            if (edge->Nodes().first == node)
-            {
-                str += TDirected::GetDirected(edge) ? "->" : "";
-                str += edge->Nodes().second->ToStr();
-                str += TWeighted::GetWeight(edge) == 1.0 ? "" : std::to_string(TWeighted::GetWeight(edge));
-            }
-            else
-            {
-                str += TDirected::GetDirected(edge) ? "<-" : "";
-                str += edge->Nodes().first->ToStr();
-                str += TWeighted::GetWeight(edge) == 1.0 ? "" : std::to_string(TWeighted::GetWeight(edge));
-            }
-            str += " ";
+            TEdgeIndex::ForEachStoredEdge(node_to, node_from, [&](TEdge* edge) {
+                if (not TDirected::GetDirected(edge))
+                    edges.push_back(edge);
+            });
         }
-        return str;
+        return edges;
+    }
+
+    /**
+     * @brief Check that a new edge would only repeat connections already made, for simple graphs
+     *
+     * @param node1 first node
+     * @param node2 second node
+     * @param directed the new edge is directed
+     * @return true if the new edge duplicates a connection
+     */
+    bool Duplicates(TNode* node1, TNode* node2, bool directed) const
+    {
+        return HasEdge(node1, node2) or ((not(TDirected::IsDirected and directed)) and HasEdge(node2, node1));
+    }
+
+    /**
+     * @brief Delete edges, each once even if listed twice as loops are
+     *
+     * @param edges edges
+     */
+    void DelEdges(std::vector<TEdge*> edges)
+    {
+        std::ranges::sort(edges);
+        const auto [unique_end, edges_end] = std::ranges::unique(edges);
+        edges.erase(unique_end, edges_end);
+        for (auto edge : edges)
+            Del(edge);
     }
 
-    std::unordered_map<TNodeId, TNode*> m_nodes;
+    TNodeMap m_nodes;
     std::unordered_set<TEdge*> m_edges;
+    uint64_t m_version = 0;
+    // depth of nested bulk updates
+    int m_bulk_update = 0;
 };
 
 }  // namespace GG
\ No newline at end of file
@@ -0,0 +1,326 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Mix bits of a value so that every input bit affects every output bit (splitmix64 finalizer)
+ *
+ * @param value value
+ * @return mixed value
+ */
+/**
+ * \~russian
+ * @brief Перемешать биты значения так, что каждый входной бит влияет на каждый выходной (финализатор splitmix64)
+ *
+ * @param value значение
+ * @return перемешанное значение
+ */
+constexpr uint64_t MixHash(uint64_t value)
+{
+    value ^= value >> 30U;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27U;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31U;
+    return value;
+}
+
+/**
+ * \~english
+ * @brief Default hash policy for node ids: std::hash followed by bit mixing
+ *
+ * std::hash of integers is the identity, so regular ids fill only some buckets of power-of-two tables. Mixing makes
+ * every id type usable in both chained and open addressing tables.
+ *
+ * @tparam TNodeId node id type
+ */
+/**
+ * \~russian
+ * @brief Политика хеширования идентификаторов вершин по умолчанию: std::hash с последующим перемешиванием битов
+ *
+ * std::hash целых чисел тождественен, поэтому регулярные идентификаторы заполняют лишь часть корзин таблиц размера
+ * степени двойки. Перемешивание делает любой тип идентификатора пригодным и для цепочечных таблиц, и для таблиц с
+ * открытой адресацией.
+ *
+ * @tparam TNodeId тип идентификатора вершины
+ */
+template <typename TNodeId>
+struct NodeIdHash {
+    std::size_t operator()(const TNodeId& id) const { return MixHash(std::hash<TNodeId>{}(id)); }
+};
+
+/**
+ * \~english
+ * @brief Hash table statistics
+ */
+/**
+ * \~russian
+ * @brief Статистика хеш-таблицы
+ */
+struct HashStats {
+    size_t size          = 0;
+    size_t buckets       = 0;
+    float load_factor    = 0.0;
+    // average count of buckets or chain elements looked at to find a present key
+    float average_probe  = 0.0;
+    // longest chain or probe sequence
+    size_t worst_bucket  = 0;
+};
+
+/**
+ * \~english
+ * @brief Hash map with open addressing and linear probing
+ *
+ * Elements are stored in one array, deletion shifts following elements back instead of leaving tombstones. Iterators
+ * are invalidated by any insertion or deletion.
+ *
+ * @tparam TKey key type
+ * @tparam TValue value type
+ * @tparam THash hash policy, must spread keys over low bits
+ */
+/**
+ * \~russian
+ * @brief Хеш-таблица с открытой адресацией и линейным пробированием
+ *
+ * Элементы хранятся в одном массиве, удаление сдвигает последующие элементы назад вместо пометок удаления. Итераторы
+ * становятся недействительными при любой вставке или удалении.
+ *
+ * @tparam TKey тип ключа
+ * @tparam TValue тип значения
+ * @tparam THash политика хеширования, должна распределять ключи по младшим битам
+ */
+template <typename TKey, typename TValue, typename THash = NodeIdHash<TKey>>
+class FlatHashMap
+{
+  public:
+    using key_type    = TKey;
+    using mapped_type = TValue;
+    using value_type  = std::pair<TKey, TValue>;
+
+    class const_iterator
+    {
+      public:
+        const_iterator(const FlatHashMap* map, size_t pos) : m_map(map), m_pos(pos) { SkipEmpty(); }
+
+        const value_type& operator*() const { return *m_map->m_slots[m_pos]; }
+        const value_type* operator->() const { return &*m_map->m_slots[m_pos]; }
+
+        const_iterator& operator++()
+        {
+            ++m_pos;
+            SkipEmpty();
+            return *this;
+        }
+
+        bool operator==(const const_iterator& rhs) const { return (m_pos == rhs.m_pos); }
+        bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+      private:
+        friend class FlatHashMap;
+
+        void SkipEmpty()
+        {
+            while ((m_pos < m_map->m_slots.size()) and not m_map->m_slots[m_pos].has_value())
+                ++m_pos;
+        }
+
+        const FlatHashMap* m_map = nullptr;
+        size_t m_pos             = 0;
+    };
+    using iterator = const_iterator;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_slots.size()); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return (m_size == 0); }
+
+    const_iterator find(const TKey& key) const
+    {
+        if (m_slots.empty())
+            return end();
+        for (size_t pos = Home(key);; pos = (pos + 1) & m_mask)
+        {
+            const auto& slot = m_slots[pos];
+            if (not slot.has_value())
+                return end();
+            if (slot->first == key)
+                return const_iterator(this, pos);
+        }
+    }
+
+    bool contains(const TKey& key) const { return (find(key) != end()); }
+
+    std::pair<const_iterator, bool> emplace(const TKey& key, const TValue& value)
+    {
+        if ((m_size + 1) * MaxLoadDen > m_slots.size() * MaxLoadNum)
+            Rehash(std::max<size_t>(m_slots.size() * 2, CapacityMin));
+        size_t pos = Home(key);
+        for (; m_slots[pos].has_value(); pos = (pos + 1) & m_mask)
+        {
+            if (m_slots[pos]->first == key)
+                return {const_iterator(this, pos), false};
+        }
+        m_slots[pos].emplace(key, value);
+        ++m_size;
+        return {const_iterator(this, pos), true};
+    }
+
+    void erase(const_iterator it)
+    {
+        GRAPH_DEBUG_ASSERT(it.m_map == this, "Iterator of other map");
+        GRAPH_DEBUG_ASSERT(it != end(), "Erase end iterator");
+        size_t hole = it.m_pos;
+        m_slots[hole].reset();
+        --m_size;
+        for (size_t pos = (hole + 1) & m_mask; m_slots[pos].has_value(); pos = (pos + 1) & m_mask)
+        {
+            // the element may fill the hole if the hole lies between its home and its position
+            const size_t home = Home(m_slots[pos]->first);
+            if (((pos - home) & m_mask) < ((pos - hole) & m_mask))
+                continue;
+            m_slots[hole] = std::move(m_slots[pos]);
+            m_slots[pos].reset();
+            hole = pos;
+        }
+    }
+
+    size_t erase(const TKey& key)
+    {
+        const auto it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_mask = 0;
+        m_size = 0;
+    }
+
+    void reserve(size_t count)
+    {
+        size_t capacity = CapacityMin;
+        while (count * MaxLoadDen > capacity * MaxLoadNum)
+            capacity *= 2;
+        if (capacity > m_slots.size())
+            Rehash(capacity);
+    }
+
+    /**
+     * \~english
+     * @brief Collect statistics of the table
+     *
+     * @return statistics
+     */
+    /**
+     * \~russian
+     * @brief Собрать статистику таблицы
+     *
+     * @return статистика
+     */
+    HashStats Stats() const
+    {
+        HashStats stats;
+        stats.size        = m_size;
+        stats.buckets     = m_slots.size();
+        stats.load_factor = m_slots.empty() ? 0.0F : static_cast<float>(m_size) / m_slots.size();
+        size_t probes     = 0;
+        for (size_t pos = 0; pos < m_slots.size(); ++pos)
+        {
+            if (not m_slots[pos].has_value())
+                continue;
+            const size_t probe = ((pos - Home(m_slots[pos]->first)) & m_mask) + 1;
+            probes += probe;
+            stats.worst_bucket = std::max(stats.worst_bucket, probe);
+        }
+        stats.average_probe = (m_size == 0) ? 0.0F : static_cast<float>(probes) / m_size;
+        return stats;
+    }
+
+  private:
+    static constexpr size_t CapacityMin = 16;
+    // maximum load factor 7/8
+    static constexpr size_t MaxLoadNum = 7;
+    static constexpr size_t MaxLoadDen = 8;
+
+    size_t Home(const TKey& key) const { return THash{}(key) & m_mask; }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<std::optional<value_type>> slots(capacity);
+        std::swap(slots, m_slots);
+        m_mask = capacity - 1;
+        for (auto& slot : slots)
+        {
+            if (not slot.has_value())
+                continue;
+            size_t pos = Home(slot->first);
+            while (m_slots[pos].has_value())
+                pos = (pos + 1) & m_mask;
+            m_slots[pos] = std::move(slot);
+        }
+    }
+
+    std::vector<std::optional<value_type>> m_slots;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+};
+
+/**
+ * \~english
+ * @brief Collect statistics of a chained hash table
+ *
+ * @param map hash table
+ * @return statistics
+ */
+/**
+ * \~russian
+ * @brief Собрать статистику цепочечной хеш-таблицы
+ *
+ * @param map хеш-таблица
+ * @return статистика
+ */
+template <typename TKey, typename TValue, typename THash, typename TEqual, typename TAllocator>
+HashStats CollectHashStats(const std::unordered_map<TKey, TValue, THash, TEqual, TAllocator>& map)
+{
+    HashStats stats;
+    stats.size        = map.size();
+    stats.buckets     = map.bucket_count();
+    stats.load_factor = map.load_factor();
+    size_t probes     = 0;
+    for (size_t bucket = 0; bucket < map.bucket_count(); ++bucket)
+    {
+        const size_t bucket_size = map.bucket_size(bucket);
+        probes += bucket_size * (bucket_size + 1) / 2;
+        stats.worst_bucket = std::max(stats.worst_bucket, bucket_size);
+    }
+    stats.average_probe = map.empty() ? 0.0F : static_cast<float>(probes) / map.size();
+    return stats;
+}
+
+template <typename TKey, typename TValue, typename THash>
+HashStats CollectHashStats(const FlatHashMap<TKey, TValue, THash>& map)
+{
+    return map.Stats();
+}
+
+}  // namespace GG
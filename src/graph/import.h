@@ -0,0 +1,728 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Edge record of an imported graph
+ *
+ * @tparam TNodeId node id type
+ */
+/**
+ * \~russian
+ * @brief Запись ребра импортированного графа
+ *
+ * @tparam TNodeId тип идентификатора вершины
+ */
+template <typename TNodeId>
+struct EdgeRecord {
+    TNodeId node1{};
+    TNodeId node2{};
+    float weight  = 1.0;
+    bool directed = false;
+};
+
+/**
+ * \~english
+ * @brief Import result status
+ */
+/**
+ * \~russian
+ * @brief Статус результата импорта
+ */
+struct ImportStatus {
+    bool ok = true;
+    // 1-based number of the first wrong line, 0 if the error is not bound to a line
+    size_t error_line = 0;
+    std::string error;
+};
+
+/**
+ * \~english
+ * @brief Parsed graph ready to be loaded with LoadImported
+ *
+ * @tparam TNodeId node id type
+ */
+/**
+ * \~russian
+ * @brief Разобранный граф, готовый к загрузке через LoadImported
+ *
+ * @tparam TNodeId тип идентификатора вершины
+ */
+template <typename TNodeId>
+struct ImportedGraph {
+    std::vector<EdgeRecord<TNodeId>> edges;
+    // nodes declared explicitly, they may have no edges
+    std::vector<TNodeId> nodes;
+    std::string name;
+    ImportStatus status;
+};
+
+/**
+ * \~english
+ * @brief Read-only memory mapped file
+ */
+/**
+ * \~russian
+ * @brief Отображённый в память файл только для чтения
+ */
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat file_stat {};
+        // a file of unknown size is neither mapped nor reported as empty
+        const bool stat_ok = (::fstat(fd, &file_stat) == 0);
+        if (stat_ok and (file_stat.st_size > 0))
+        {
+            void* data = ::mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                ::madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(data);
+                m_size = file_stat.st_size;
+            }
+        }
+        else if (stat_ok and (file_stat.st_size == 0))
+        {
+            // empty file can not be mapped but is still a valid file
+            m_empty = true;
+        }
+        ::close(fd);
+    }
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile()
+    {
+        if (m_data != nullptr)
+            ::munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    bool Ok() const { return (m_data != nullptr) or m_empty; }
+    std::string_view Data() const { return {m_data, m_size}; }
+
+  private:
+    const char* m_data = nullptr;
+    size_t m_size      = 0;
+    bool m_empty       = false;
+};
+
+/**
+ * \~english
+ * @brief Split a text into whitespace separated tokens
+ */
+/**
+ * \~russian
+ * @brief Разбить текст на токены, разделённые пробельными символами
+ */
+class Tokenizer
+{
+  public:
+    explicit Tokenizer(std::string_view text) : m_text(text) {}
+
+    /**
+     * \~english
+     * @brief Get next token
+     *
+     * @return token, empty if there are no more tokens
+     */
+    /**
+     * \~russian
+     * @brief Получить следующий токен
+     *
+     * @return токен, пустой, если токенов больше нет
+     */
+    std::string_view Next()
+    {
+        size_t pos = 0;
+        while ((pos < m_text.size()) and IsSpace(m_text[pos]))
+            ++pos;
+        size_t end = pos;
+        while ((end < m_text.size()) and not IsSpace(m_text[end]))
+            ++end;
+        const auto token = m_text.substr(pos, end - pos);
+        m_text.remove_prefix(end);
+        return token;
+    }
+
+    static bool IsSpace(char chr) { return (chr == ' ') or (chr == '\t') or (chr == '\r') or (chr == '\n'); }
+
+  private:
+    std::string_view m_text;
+};
+
+/**
+ * \~english
+ * @brief Node id that can be parsed from a token: an integral id, an id constructible from a string or an id with a
+ * Str2Id(token, id) overload found by argument dependent lookup
+ */
+/**
+ * \~russian
+ * @brief Идентификатор вершины, который можно разобрать из токена: целочисленный, конструируемый из строки или с
+ * перегрузкой Str2Id(токен, ид), находимой поиском, зависящим от аргументов
+ */
+template <typename TNodeId>
+concept ParsableNodeId = std::is_integral_v<TNodeId> or std::is_constructible_v<TNodeId, std::string_view> or
+                         requires(std::string_view token, TNodeId& id) {
+                             { Str2Id(token, id) } -> std::same_as<bool>;
+                         };
+
+/**
+ * \~english
+ * @brief Parse node id from a token, integral ids are parsed with std::from_chars
+ *
+ * @param token token
+ * @param id parsed id
+ * @return true if the whole token is a correct id
+ */
+/**
+ * \~russian
+ * @brief Разобрать идентификатор вершины из токена, целочисленные идентификаторы разбираются std::from_chars
+ *
+ * @param token токен
+ * @param id разобранный идентификатор
+ * @return true, если весь токен является корректным идентификатором
+ */
+template <ParsableNodeId TNodeId>
+bool ParseNodeId(std::string_view token, TNodeId& id)
+{
+    if (token.empty())
+        return false;
+    if constexpr (std::is_integral_v<TNodeId>)
+    {
+        const auto res = std::from_chars(token.data(), token.data() + token.size(), id);
+        return (res.ec == std::errc()) and (res.ptr == token.data() + token.size());
+    }
+    else if constexpr (std::is_constructible_v<TNodeId, std::string_view>)
+    {
+        id = TNodeId(token);
+        return true;
+    }
+    else
+    {
+        return Str2Id(token, id);
+    }
+}
+
+/**
+ * \~english
+ * @brief Parse a number from a token
+ *
+ * @param token token
+ * @param number parsed number
+ * @return true if the whole token is a correct number
+ */
+/**
+ * \~russian
+ * @brief Разобрать число из токена
+ *
+ * @param token токен
+ * @param number разобранное число
+ * @return true, если весь токен является корректным числом
+ */
+template <typename TNumber>
+bool ParseNumber(std::string_view token, TNumber& number)
+{
+    const auto res = std::from_chars(token.data(), token.data() + token.size(), number);
+    return (res.ec == std::errc()) and (res.ptr == token.data() + token.size());
+}
+
+/**
+ * \~english
+ * @brief Parse lines of a text in parallel
+ *
+ * The text is split into chunks at line boundaries, every thread parses its chunk into its own vector, vectors are
+ * concatenated in the order of chunks, so records keep the order of lines.
+ *
+ * @param text text
+ * @param first_line number of the first line of the text, used for error reporting
+ * @param threads thread count, 0 to use hardware concurrency
+ * @param parse_line function (line, records) returning false if the line is wrong
+ * @param records parsed records
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Разобрать строки текста параллельно
+ *
+ * Текст делится на части по границам строк, каждый поток разбирает свою часть в собственный вектор, векторы
+ * объединяются в порядке частей, поэтому записи сохраняют порядок строк.
+ *
+ * @param text текст
+ * @param first_line номер первой строки текста, используется для сообщений об ошибках
+ * @param threads количество потоков, 0 для использования аппаратного параллелизма
+ * @param parse_line функция (строка, записи), возвращающая false, если строка ошибочна
+ * @param records разобранные записи
+ * @return статус
+ */
+template <typename TRecord, typename TParseLine>
+ImportStatus ParseLinesParallel(std::string_view text, size_t first_line, unsigned threads, TParseLine parse_line,
+                                std::vector<TRecord>* records)
+{
+    // small texts are not worth starting threads
+    static constexpr size_t ChunkSizeMin = 1024 * 1024;
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min<size_t>(threads, text.size() / ChunkSizeMin));
+
+    struct Chunk {
+        std::string_view text;
+        std::vector<TRecord> records;
+        size_t lines      = 0;
+        size_t error_line = 0;
+    };
+    std::vector<Chunk> chunks(threads);
+    size_t begin = 0;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        size_t end = (i + 1 == threads) ? text.size() : text.size() / threads * (i + 1);
+        if (end < begin)
+            end = begin;
+        if (end < text.size())
+        {
+            end = text.find('\n', end);
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+        chunks[i].text = text.substr(begin, end - begin);
+        begin          = end;
+    }
+
+    auto parse_chunk = [&parse_line](Chunk& chunk) {
+        chunk.records.reserve(chunk.text.size() / 16);
+        std::string_view rest = chunk.text;
+        while (not rest.empty())
+        {
+            const size_t end = rest.find('\n');
+            const auto line  = rest.substr(0, end);
+            rest.remove_prefix((end == std::string_view::npos) ? rest.size() : end + 1);
+            ++chunk.lines;
+            if (not parse_line(line, chunk.records))
+            {
+                chunk.error_line = chunk.lines;
+                return;
+            }
+        }
+    };
+
+    if (threads == 1)
+    {
+        parse_chunk(chunks[0]);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (auto& chunk : chunks)
+            workers.emplace_back(parse_chunk, std::ref(chunk));
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    ImportStatus status;
+    size_t line  = first_line;
+    size_t count = records->size();
+    for (const auto& chunk : chunks)
+    {
+        if (chunk.error_line != 0)
+        {
+            status.ok         = false;
+            status.error_line = line + chunk.error_line - 1;
+            status.error      = "Wrong line";
+            return status;
+        }
+        line += chunk.lines;
+        count += chunk.records.size();
+    }
+    records->reserve(count);
+    for (auto& chunk : chunks)
+    {
+        records->insert(records->end(), std::make_move_iterator(chunk.records.begin()),
+                        std::make_move_iterator(chunk.records.end()));
+        std::vector<TRecord>().swap(chunk.records);
+    }
+    return status;
+}
+
+/**
+ * \~english
+ * @brief Parse a whitespace separated edge list
+ *
+ * Every line is "node1 node2 [weight]", empty lines and lines starting with '#' or '%' are skipped.
+ *
+ * @param text text
+ * @param directed make edges directed
+ * @param threads thread count, 0 to use hardware concurrency
+ * @return parsed graph
+ */
+/**
+ * \~russian
+ * @brief Разобрать список рёбер, разделённых пробельными символами
+ *
+ * Каждая строка имеет вид "вершина1 вершина2 [вес]", пустые строки и строки, начинающиеся с '#' или '%', пропускаются.
+ *
+ * @param text текст
+ * @param directed делать рёбра направленными
+ * @param threads количество потоков, 0 для использования аппаратного параллелизма
+ * @return разобранный граф
+ */
+template <typename TNodeId>
+ImportedGraph<TNodeId> ParseEdgeList(std::string_view text, bool directed = false, unsigned threads = 0)
+{
+    ImportedGraph<TNodeId> graph;
+    auto parse_line = [directed](std::string_view line, std::vector<EdgeRecord<TNodeId>>& edges) {
+        Tokenizer tokenizer(line);
+        const auto token1 = tokenizer.Next();
+        if (token1.empty() or (token1.front() == '#') or (token1.front() == '%'))
+            return true;
+        EdgeRecord<TNodeId> edge;
+        edge.directed = directed;
+        if (not ParseNodeId(token1, edge.node1) or not ParseNodeId(tokenizer.Next(), edge.node2))
+            return false;
+        const auto token_weight = tokenizer.Next();
+        if (not token_weight.empty() and not ParseNumber(token_weight, edge.weight))
+            return false;
+        if (not tokenizer.Next().empty())
+            return false;
+        edges.push_back(std::move(edge));
+        return true;
+    };
+    graph.status = ParseLinesParallel(text, 1, threads, parse_line, &graph.edges);
+    return graph;
+}
+
+/**
+ * \~english
+ * @brief Parse a sparse matrix in Matrix Market coordinate format as a graph
+ *
+ * Every nonzero entry (i, j) becomes an edge from node i to node j weighted by the entry value. General matrices give
+ * directed edges, symmetric matrices give undirected ones. Only real, integer and pattern fields are supported.
+ *
+ * @param text text
+ * @param threads thread count, 0 to use hardware concurrency
+ * @return parsed graph
+ */
+/**
+ * \~russian
+ * @brief Разобрать разреженную матрицу в координатном формате Matrix Market как граф
+ *
+ * Каждый ненулевой элемент (i, j) становится ребром из вершины i в вершину j с весом, равным значению элемента.
+ * Матрицы общего вида дают направленные рёбра, симметричные - ненаправленные. Поддерживаются только поля real, integer
+ * и pattern.
+ *
+ * @param text текст
+ * @param threads количество потоков, 0 для использования аппаратного параллелизма
+ * @return разобранный граф
+ */
+template <typename TNodeId>
+ImportedGraph<TNodeId> ParseMatrixMarket(std::string_view text, unsigned threads = 0)
+{
+    ImportedGraph<TNodeId> graph;
+    auto fail = [&graph](size_t line, const char* error) {
+        graph.status.ok         = false;
+        graph.status.error_line = line;
+        graph.status.error      = error;
+        return graph;
+    };
+    auto next_line = [&text]() {
+        const size_t end = text.find('\n');
+        const auto line  = text.substr(0, end);
+        text.remove_prefix((end == std::string_view::npos) ? text.size() : end + 1);
+        return line;
+    };
+
+    Tokenizer header(next_line());
+    if ((header.Next() != "%%MatrixMarket") or (header.Next() != "matrix") or (header.Next() != "coordinate"))
+        return fail(1, "Not a Matrix Market coordinate matrix");
+    const auto field = header.Next();
+    if ((field != "real") and (field != "integer") and (field != "pattern"))
+        return fail(1, "Unsupported Matrix Market field");
+    const bool pattern  = (field == "pattern");
+    const auto symmetry = header.Next();
+    if ((symmetry != "general") and (symmetry != "symmetric"))
+        return fail(1, "Unsupported Matrix Market symmetry");
+    const bool directed = (symmetry == "general");
+
+    size_t line_number = 1;
+    size_t rows        = 0;
+    size_t columns     = 0;
+    size_t entries     = 0;
+    while (true)
+    {
+        if (text.empty())
+            return fail(line_number, "No matrix size line");
+        ++line_number;
+        Tokenizer size_line(next_line());
+        const auto token = size_line.Next();
+        if (token.empty() or (token.front() == '%'))
+            continue;
+        if (not ParseNumber(token, rows) or not ParseNumber(size_line.Next(), columns) or
+            not ParseNumber(size_line.Next(), entries))
+            return fail(line_number, "Wrong matrix size line");
+        break;
+    }
+
+    const size_t size_line_number = line_number;
+    auto parse_line = [directed, pattern, rows, columns](std::string_view line,
+                                                         std::vector<EdgeRecord<TNodeId>>& edges) {
+        Tokenizer tokenizer(line);
+        const auto token1 = tokenizer.Next();
+        if (token1.empty() or (token1.front() == '%'))
+            return true;
+        const auto token2 = tokenizer.Next();
+        // indices are 1-based and bounded by the size line
+        size_t row    = 0;
+        size_t column = 0;
+        if (not ParseNumber(token1, row) or not ParseNumber(token2, column) or (row == 0) or (row > rows) or
+            (column == 0) or (column > columns))
+            return false;
+        EdgeRecord<TNodeId> edge;
+        edge.directed = directed;
+        if (not ParseNodeId(token1, edge.node1) or not ParseNodeId(token2, edge.node2))
+            return false;
+        if (not pattern and not ParseNumber(tokenizer.Next(), edge.weight))
+            return false;
+        edges.push_back(std::move(edge));
+        return true;
+    };
+    graph.edges.reserve(entries);
+    graph.status = ParseLinesParallel(text, line_number + 1, threads, parse_line, &graph.edges);
+    if (graph.status.ok and (graph.edges.size() != entries))
+        return fail(size_line_number, "Entries count differs from the matrix size line");
+    return graph;
+}
+
+/**
+ * \~english
+ * @brief Parse a graph in the subset of DOT language written by WriteDOT
+ *
+ * One statement per line: header "graph|digraph "name" {", node "handle [label="id"];", edge "handle1 -> handle2;"
+ * or "handle1 -- handle2;" and closing "}". Edge handles without node statements are parsed as node ids.
+ *
+ * @param text text
+ * @param threads thread count, 0 to use hardware concurrency
+ * @return parsed graph
+ */
+/**
+ * \~russian
+ * @brief Разобрать граф в подмножестве языка DOT, записываемом WriteDOT
+ *
+ * Одно утверждение на строку: заголовок "graph|digraph "имя" {", вершина "метка [label="ид"];", ребро
+ * "метка1 -> метка2;" или "метка1 -- метка2;" и закрывающая "}". Метки рёбер без утверждений вершин разбираются как
+ * идентификаторы вершин.
+ *
+ * @param text текст
+ * @param threads количество потоков, 0 для использования аппаратного параллелизма
+ * @return разобранный граф
+ */
+template <typename TNodeId>
+ImportedGraph<TNodeId> ParseDOT(std::string_view text, unsigned threads = 0)
+{
+    ImportedGraph<TNodeId> graph;
+    auto fail = [&graph](size_t line, const char* error) {
+        graph.status.ok         = false;
+        graph.status.error_line = line;
+        graph.status.error      = error;
+        return graph;
+    };
+
+    const size_t header_end = text.find('\n');
+    auto header             = text.substr(0, header_end);
+    text.remove_prefix((header_end == std::string_view::npos) ? text.size() : header_end + 1);
+    const size_t name_begin = header.find('"');
+    const size_t name_end   = header.rfind('"');
+    const auto keyword      = header.substr(0, header.find_first_of(" \t"));
+    if ((keyword != "graph") and (keyword != "digraph"))
+        return fail(1, "No graph header");
+    if ((name_begin != std::string_view::npos) and (name_end > name_begin))
+        graph.name = header.substr(name_begin + 1, name_end - name_begin - 1);
+    if (header.find('{') == std::string_view::npos)
+        return fail(1, "No graph header");
+
+    // statements refer to text of the mapped file, node handles are resolved after parallel parsing
+    struct Statement {
+        std::string_view handle1;
+        std::string_view handle2;
+        bool node     = false;
+        bool directed = false;
+    };
+    auto parse_line = [](std::string_view line, std::vector<Statement>& statements) {
+        Tokenizer tokenizer(line);
+        const auto handle1 = tokenizer.Next();
+        if (handle1.empty() or (handle1 == "}"))
+            return true;
+        const auto token = tokenizer.Next();
+        Statement statement;
+        statement.handle1 = handle1;
+        if ((token == "->") or (token == "--"))
+        {
+            statement.directed = (token == "->");
+            statement.handle2  = tokenizer.Next();
+            if (statement.handle2.empty() or (statement.handle2.back() != ';'))
+                return false;
+            statement.handle2.remove_suffix(1);
+        }
+        else
+        {
+            static constexpr std::string_view LabelPrefix = "[label=\"";
+            const size_t label_begin                      = line.find(LabelPrefix);
+            const size_t label_end                        = line.rfind("\"]");
+            if ((label_begin == std::string_view::npos) or (label_end == std::string_view::npos) or
+                (label_end < label_begin + LabelPrefix.size()))
+                return false;
+            statement.node    = true;
+            statement.handle2 = line.substr(label_begin + LabelPrefix.size(),
+                                            label_end - label_begin - LabelPrefix.size());
+        }
+        statements.push_back(statement);
+        return true;
+    };
+    std::vector<Statement> statements;
+    graph.status = ParseLinesParallel(text, 2, threads, parse_line, &statements);
+    if (not graph.status.ok)
+        return graph;
+
+    std::unordered_map<std::string_view, TNodeId> handles;
+    size_t nodes_count = 0;
+    for (const auto& statement : statements)
+        nodes_count += statement.node ? 1 : 0;
+    handles.reserve(nodes_count);
+    graph.nodes.reserve(nodes_count);
+    graph.edges.reserve(statements.size() - nodes_count);
+    for (const auto& statement : statements)
+    {
+        if (not statement.node)
+            continue;
+        TNodeId id;
+        if (not ParseNodeId(statement.handle2, id))
+            return fail(0, "Wrong node label");
+        handles.emplace(statement.handle1, id);
+        graph.nodes.push_back(std::move(id));
+    }
+    auto resolve = [&handles](std::string_view handle, TNodeId& id) {
+        const auto handle_it = handles.find(handle);
+        if (handle_it == handles.end())
+            return ParseNodeId(handle, id);
+        id = handle_it->second;
+        return true;
+    };
+    for (const auto& statement : statements)
+    {
+        if (statement.node)
+            continue;
+        EdgeRecord<TNodeId> edge;
+        edge.directed = statement.directed;
+        if (not resolve(statement.handle1, edge.node1) or not resolve(statement.handle2, edge.node2))
+            return fail(0, "Wrong edge node");
+        graph.edges.push_back(std::move(edge));
+    }
+    return graph;
+}
+
+/**
+ * \~english
+ * @brief Load a parsed graph into a graph with one bulk update
+ *
+ * @param graph graph
+ * @param imported parsed graph
+ * @return status of the parsed graph, nothing is loaded if it is an error
+ */
+/**
+ * \~russian
+ * @brief Загрузить разобранный граф в граф одним групповым изменением
+ *
+ * @param graph граф
+ * @param imported разобранный граф
+ * @return статус разобранного графа, при ошибке ничего не загружается
+ */
+template <typename TGraph, typename TNodeId>
+ImportStatus LoadImported(TGraph& graph, const ImportedGraph<TNodeId>& imported)
+{
+    if (imported.status.ok)
+        graph.LoadEdges(imported.edges, imported.nodes);
+    return imported.status;
+}
+
+/**
+ * \~english
+ * @brief Import a graph from a file with a parser through a memory mapping
+ *
+ * @param graph graph
+ * @param path file path
+ * @param parse function parsing file text into ImportedGraph
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Импортировать граф из файла парсером через отображение в память
+ *
+ * @param graph граф
+ * @param path путь к файлу
+ * @param parse функция, разбирающая текст файла в ImportedGraph
+ * @return статус
+ */
+template <typename TGraph, typename TParse>
+ImportStatus ImportFile(TGraph& graph, const std::string& path, TParse parse)
+{
+    const MappedFile file(path);
+    if (not file.Ok())
+    {
+        ImportStatus status;
+        status.ok    = false;
+        status.error = "Can not map file " + path;
+        return status;
+    }
+    return LoadImported(graph, parse(file.Data()));
+}
+
+template <typename TGraph>
+ImportStatus ImportEdgeList(TGraph& graph, const std::string& path, bool directed = false, unsigned threads = 0)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    return ImportFile(graph, path, [directed, threads](std::string_view text) {
+        return ParseEdgeList<NodeId_t>(text, directed, threads);
+    });
+}
+
+template <typename TGraph>
+ImportStatus ImportMatrixMarket(TGraph& graph, const std::string& path, unsigned threads = 0)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    return ImportFile(graph, path, [threads](std::string_view text) {
+        return ParseMatrixMarket<NodeId_t>(text, threads);
+    });
+}
+
+template <typename TGraph>
+ImportStatus ImportDOT(TGraph& graph, const std::string& path, unsigned threads = 0)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    return ImportFile(graph, path, [threads](std::string_view text) { return ParseDOT<NodeId_t>(text, threads); });
+}
+
+}  // namespace GG
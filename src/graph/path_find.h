@@ -2,9 +2,13 @@
 
 #pragma once
 
+#include <array>
 #include <list>
-#include <unordered_set>
+#include <span>
+#include <vector>
 
+#include "./adjacency.h"
+#include "./algorithms.h"
 #include "./graph_inclusive.h"
 #include "./primitives.h"
 #include "./properties/all.h"
@@ -61,259 +65,61 @@ class Path
     std::list<TNode*> m_nodes;
 };
 
-template <typename TNode>
-class PathFindNode
-{
-  public:
-    using NodeId_t = TNode::NodeId_t;
-    using Edge_t   = Edge<PathFindNode<TNode>>;
-
-    template <typename TNode_>
-    PathFindNode(TNode_* node, float distance) : m_node(node), m_distance(distance)
-    {
-        GRAPH_DEBUG_ASSERT(m_node != nullptr, "Null node");
-    }
-
-    TNode* BaseNode() const { return m_node; }
-    float Distance() const { return m_distance; }
-
-  private:
-    TNode* m_node    = nullptr;
-    float m_distance = 0.0;
-
-  public:
-    /**
-     * \~english
-     * @brief Get node identificator
-     * 
-     * @return node identificator
-     */
-    /**
-     * \~russian
-     * @brief Получить идентификатор узла
-     * 
-     * @return идентификатор узла
-     */
-    const NodeId_t& Id() const { return m_node->Id(); }
-
-    /**
-     * \~english
-     * @brief Add edge
-     * 
-     * @param edge edge
-     */
-    /**
-     * \~russian
-     * @brief Добавить ребро
-     * 
-     * @param edge ребро
-     */
-    void AddEdge(Edge_t* edge)
-    {
-        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
-        m_edges.push_back(edge);
-    }
-
-    /**
-     * \~english
-     * @brief Get edges for this node
-     * 
-     * @return edges for this node
-     */
-    /**
-     * \~russian
-     * @brief Получить рёбра этой вершины
-     * 
-     * @return рёбра этой вершины
-     */
-    const std::vector<Edge_t*>& Edges() const { return m_edges; }
-
-    /**
-     * \~english
-     * @brief Get string description
-     * 
-     * @return string description
-     */
-    /**
-     * \~russian
-     * @brief Получить строковое описание
-     * 
-     * @return строковое описание
-     */
-    std::string ToStr() const { return m_node->ToStr(); }
-
-  private:
-    std::vector<Edge_t*> m_edges;
-};
-
-template <typename TNode>
-class Forefront
-{
-  public:
-    using PNode = PathFindNode<TNode>;
-
-    const std::unordered_set<PNode*>& Nodes() const { return m_pnodes; }
-
-    void Add(PNode* pnode)
-    {
-        GRAPH_DEBUG_ASSERT(pnode != nullptr, "Null pnode");
-        m_pnodes.insert(pnode);
-        m_max_distance = std::max(m_max_distance, pnode->Distance());
-    }
-
-    float MaxDistance() const { return m_max_distance; }
-
-    bool Empty() const { return m_pnodes.empty(); }
-
-    /**
-     * \~english
-     * @brief Get string description
-     * 
-     * @return string description
-     */
-    /**
-     * \~russian
-     * @brief Получить строковое описание
-     * 
-     * @return строковое описание
-     */
-    std::string ToStr() const
-    {
-        std::string str{"Forefront\n"};
-        std::array<char, 256> strbuf;
-        for (const auto pnode : m_pnodes)
-        {
-            const auto node = pnode->BaseNode();
-            const auto dist = pnode->Distance();
-            snprintf(strbuf.data(), strbuf.size(), "Node %s (%p) %f\n", node->ToStr().c_str(), node, dist);
-            str.append(strbuf.data());
-        }
-        return str;
-    }
-
-  private:
-    std::unordered_set<PNode*> m_pnodes;
-    float m_max_distance = 0.0;
-};
-
 template <typename TNode, typename TEdge, typename TDirected, typename TWeighted, typename TConnectedComponentWatch,
-          typename TNamed>
+          typename TNamed, typename TNodeMap = DefaultNodeMap<TNode>, typename TJournal = Journal<TNode, TEdge, false>,
+          typename TEdgeIndex = EdgeIndex<TNode, TEdge, false>>
 class PathFindContext
 {
   public:
-    using PNode_t     = PathFindNode<TNode>;
-    using PEdge_t     = Edge<PNode_t>;
-    using Path_t      = Path<TNode>;
-    using Graph_t     = GraphInclusive<TNode, TEdge, TDirected, TWeighted, TConnectedComponentWatch, TNamed>;
-    using GraphWave_t = GraphInclusive<PNode_t, PEdge_t, GG::Directed<PEdge_t, true>, Weighted<PEdge_t, false>,
-                                       ConnectedComponentWatch<PNode_t, PEdge_t, false>, Named<false>>;
-    using Forefront_t = Forefront<TNode>;
+    using Path_t  = Path<TNode>;
+    using Graph_t = GraphInclusive<TNode, TEdge, TDirected, TWeighted, TConnectedComponentWatch, TNamed, TNodeMap,
+                                   TJournal, TEdgeIndex>;
+    using Adjacency_t = GraphInclusiveAdjacency<Graph_t>;
+    using Wave_t      = WaveSearch<Adjacency_t>;
 
-    PathFindContext(const Graph_t* graph, TNode* start) : m_graph(graph), m_start(start)
+    PathFindContext(const Graph_t* graph, TNode* start)
+        : m_graph(graph), m_adjacency(graph), m_wave(&m_adjacency, start)
     {
         GRAPH_DEBUG_ASSERT(m_graph != nullptr, "Null graph");
-        GRAPH_DEBUG_ASSERT(m_start != nullptr, "Null start");
-        auto pnode = m_wave.MakeNode(m_start, 0.0);
-        m_forefront.Add(pnode);
+        GRAPH_DEBUG_ASSERT(start != nullptr, "Null start");
     }
 
-    ~PathFindContext() { m_wave.Clear(); }
+    PathFindContext(const PathFindContext&)            = delete;
+    PathFindContext& operator=(const PathFindContext&) = delete;
 
-    TNode* Start() const { return m_start; }
+    TNode* Start() const { return m_wave.Start(); }
 
-    void Step()
-    {
-        if (Exhausted())
-            return;
+    void Step() { m_wave.Step(); }
 
-        if (Graph_t::IsWeighted)
-        {
-            GRAPH_DEBUG_ASSERT(false, "Not implemented");
-        }
-        else
-        {
-            StepWaveAlgorithm();
-        }
-    }
+    bool Exhausted() const { return m_wave.Exhausted(); }
 
-    void StepWaveAlgorithm()
-    {
-        Forefront_t new_forefront;
-        const float dist = m_forefront.MaxDistance() + 1.0;
-        for (PNode_t* pnode : m_forefront.Nodes())
-        {
-            auto node = pnode->BaseNode();
-            for (auto edge : node->Edges())
-            {
-                auto node2 = edge->Nodes().first;
-                if (node2 == node)
-                    node2 = edge->Nodes().second;
-                if (m_wave.Find(node2->Id()) != nullptr)
-                    continue;
-                auto new_pnode = m_wave.MakeNode(node2, dist);
-                new_forefront.Add(new_pnode);
-                m_wave.MakeEdge(new_pnode, pnode, true);
-            }
-        }
-        m_forefront = std::move(new_forefront);
-    }
+    float DistanceTo(TNode* target) const { return m_wave.DistanceTo(target); }
 
-    bool Exhausted() const { return m_forefront.Empty(); }
+    void SpreadWave() { m_wave.SpreadWave(); }
 
-    float DistanceTo(TNode* target) const
-    {
-        auto pnode = m_wave.Find(target->Id());
-        if (pnode == nullptr)
-            return 0.0;
-        return pnode->Distance();
-    }
+    Generator<size_t> Steps(typename Wave_t::StepBudget budget) { return m_wave.Steps(budget); }
 
-    void SpreadWave()
+    Generator<std::span<TNode* const>> Layers()
+        requires(not Wave_t::IsWeighted)
     {
-        while (not Exhausted())
-        {
-            Step();
-        }
+        return m_wave.Layers();
     }
 
-    std::vector<TNode*> WaveNodes()
-    {
-        std::vector<TNode*> nodes;
-        auto pnodes = m_wave.Nodes();
-        nodes.reserve(pnodes.size());
-        for (const auto& pnode_it : pnodes)
-            nodes.push_back(pnode_it.second->BaseNode());
-        return nodes;
-    }
+    std::vector<TNode*> WaveNodes() const { return m_wave.ReachedNodes(); }
 
     Path_t FindPathTo(TNode* target)
     {
-        Path_t path;
-        if (m_graph->SurelyNotConnected(m_start, target))
-            return path;
-        while (not Exhausted())
-        {
-            Step();
-            path = std::move(PathTo(target));
-            if (path.Length() > 0)
-                break;
-        }
-        return path;
+        if (m_graph->SurelyNotConnected(Start(), target))
+            return Path_t{};
+        m_wave.FindPathTo(target);
+        return PathTo(target);
     }
 
     Path_t PathTo(TNode* target) const
     {
-        auto ptarget = m_wave.Find(target->Id());
         Path_t path;
-        if (ptarget == nullptr)
-            return path;
-        path.push_front(ptarget->BaseNode());
-        while (ptarget->BaseNode() != m_start)
-        {
-            auto pedge = ptarget->Edges().front();
-            ptarget    = pedge->Nodes().second;
-            path.push_front(ptarget->BaseNode());
-        }
+        for (auto node : m_wave.PathTo(target))
+            path.push_back(node);
         return path;
     }
 
@@ -334,20 +140,23 @@ class PathFindContext
         std::string str{"PathFindContext\n"};
         if (Exhausted())
             str += "EXHAUSTED\n";
-        str += m_wave.ToStr();
-        str += m_forefront.ToStr();
+        std::array<char, 256> strbuf;
+        for (const auto node : m_wave.ReachedNodes())
+        {
+            snprintf(strbuf.data(), strbuf.size(), "Node %s (%p) %f\n", node->ToStr().c_str(), node,
+                     m_wave.DistanceTo(node));
+            str.append(strbuf.data());
+        }
         return str;
     }
 
     std::string ToDOT() const
     {
         auto node_printer = [&](TNode* node) -> std::string {
-            const auto id = node->Id();
-            auto pnode    = m_wave.Find(id);
             std::string str;
-            str += Id2Str(id);
-            if (pnode != nullptr)
-                str += std::string(" d=") + std::to_string(pnode->Distance());
+            str += Id2Str(node->Id());
+            if (m_wave.Reached(node))
+                str += std::string(" d=") + std::to_string(m_wave.DistanceTo(node));
             return str;
         };
         return m_graph->ToDOT(node_printer);
@@ -355,10 +164,8 @@ class PathFindContext
 
   private:
     const Graph_t* m_graph = nullptr;
-    TNode* m_start         = nullptr;
-
-    GraphWave_t m_wave;
-    Forefront_t m_forefront;
+    Adjacency_t m_adjacency;
+    Wave_t m_wave;
 };
 
-}  // namespace GG
\ No newline at end of file
+}  // namespace GG
@@ -2,47 +2,153 @@
 
 #pragma once
 
+#include <span>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "./common.h"
+#include "./small_vector.h"
 
 namespace GG
 {
 
-template <typename TNodeId>
+template <typename TNodeId, bool IsDirected = false, size_t InlineEdges = 0>
 class Node;
 template <typename TNode>
 class Edge;
 
-template <typename TNodeId>
+/**
+ * \~english
+ * @brief Graph node with the list of its edges
+ *
+ * A directed node keeps its edge list partitioned into outgoing directed edges, undirected edges and incoming
+ * directed edges, so out-edges and in-edges are contiguous ranges of the same list and are walked without checking the
+ * direction of every edge. An undirected node keeps the list in order of adding and pays nothing for the ranges.
+ *
+ * The list is a heap vector by default. With a nonzero InlineEdges it is a SmallVector keeping that many edges inside
+ * the node, which suits nodes of bounded degree such as grid cells.
+ *
+ * @tparam TNodeId node identifier type
+ * @tparam IsDirected keep out-edges and in-edges apart, meant for nodes of directed graphs
+ * @tparam InlineEdges count of edges stored inside the node, 0 to store all of them on the heap
+ */
+/**
+ * \~russian
+ * @brief Вершина графа со списком своих рёбер
+ *
+ * Направленная вершина хранит список рёбер разбитым на исходящие направленные рёбра, ненаправленные рёбра и входящие
+ * направленные рёбра, поэтому исходящие и входящие рёбра - это непрерывные диапазоны одного списка, и они
+ * проходятся без проверки направления каждого ребра. Ненаправленная вершина хранит список в порядке добавления и ничего
+ * не платит за диапазоны.
+ *
+ * По умолчанию список - вектор в куче. С ненулевым InlineEdges это SmallVector, хранящий столько рёбер внутри вершины,
+ * что подходит вершинам ограниченной степени, например клеткам сетки.
+ *
+ * @tparam TNodeId тип идентификатора вершины
+ * @tparam IsDirected хранить исходящие и входящие рёбра раздельно, предназначено для вершин направленных графов
+ * @tparam InlineEdges количество рёбер, хранимых внутри вершины, 0, чтобы хранить их все в куче
+ */
+template <typename TNodeId, bool IsDirected, size_t InlineEdges>
 class Node
 {
   public:
     using NodeId_t = TNodeId;
+    using Edge_t   = Edge<Node>;
+    using Edges_t  = std::conditional_t<InlineEdges == 0, std::vector<Edge_t*>, SmallVector<Edge_t*, InlineEdges>>;
 
     explicit Node(const TNodeId& id) : m_id(id) {}
-    void AddEdge(Edge<Node>* edge)
+    void AddEdge(Edge_t* edge)
     {
         GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
-        m_edges.push_back(edge);
+        if constexpr (IsDirected)
+        {
+            switch (Part(edge))
+            {
+            case EdgePart::Out:
+                m_edges.insert(m_edges.begin() + m_parts.in_begin, edge);
+                ++m_parts.in_begin;
+                ++m_parts.out_end;
+                break;
+            case EdgePart::Both:
+                m_edges.insert(m_edges.begin() + m_parts.out_end, edge);
+                ++m_parts.out_end;
+                break;
+            case EdgePart::In:
+                m_edges.push_back(edge);
+                break;
+            }
+        }
+        else
+        {
+            m_edges.push_back(edge);
+        }
     }
 
-    void DelEdge(Edge<Node>* edge)
+    void DelEdge(Edge_t* edge)
     {
         GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
-        std::vector<Edge<Node>*> edges;
-        edges.reserve(m_edges.size());
-        for (auto edge_ : m_edges)
+        [[maybe_unused]] const auto parts = m_parts;
+        // compacted in place, so deleting edges of hub nodes does not reallocate their lists
+        size_t kept = 0;
+        for (size_t i = 0; i < m_edges.size(); ++i)
         {
-            if (edge_ != edge)
-                edges.push_back(edge_);
+            if (m_edges[i] != edge)
+            {
+                m_edges[kept++] = m_edges[i];
+                continue;
+            }
+            if constexpr (IsDirected)
+            {
+                // bounds move left for every removed edge before them
+                if (i < parts.in_begin)
+                    --m_parts.in_begin;
+                if (i < parts.out_end)
+                    --m_parts.out_end;
+            }
         }
-        m_edges = std::move(edges);
+        m_edges.resize(kept);
+    }
+
+    const Edges_t& Edges() const { return m_edges; }
+
+    /**
+     * \~english
+     * @brief Get edges leaving the node: outgoing directed edges and undirected edges
+     *
+     * @return out-edges
+     */
+    /**
+     * \~russian
+     * @brief Получить рёбра, выходящие из вершины: исходящие направленные рёбра и ненаправленные рёбра
+     *
+     * @return исходящие рёбра
+     */
+    std::span<Edge_t* const> OutEdges() const
+        requires IsDirected
+    {
+        return std::span<Edge_t* const>(m_edges.data(), m_parts.out_end);
+    }
+
+    /**
+     * \~english
+     * @brief Get edges entering the node: undirected edges and incoming directed edges
+     *
+     * @return in-edges
+     */
+    /**
+     * \~russian
+     * @brief Получить рёбра, входящие в вершину: ненаправленные рёбра и входящие направленные рёбра
+     *
+     * @return входящие рёбра
+     */
+    std::span<Edge_t* const> InEdges() const
+        requires IsDirected
+    {
+        return std::span<Edge_t* const>(m_edges).subspan(m_parts.in_begin);
     }
 
-    const std::vector<Edge<Node>*>& Edges() const { return m_edges; }
     const TNodeId& Id() const { return m_id; }
 
     /**
@@ -60,8 +166,30 @@ class Node
     std::string ToStr() const { return Id2Str(m_id); }
 
   private:
+    enum class EdgePart
+    {
+        Out,
+        Both,
+        In
+    };
+
+    // edges before in_begin are outgoing only, edges from out_end are incoming only
+    struct Parts {
+        size_t in_begin = 0;
+        size_t out_end  = 0;
+    };
+    struct NoParts {};
+
+    EdgePart Part(const Edge_t* edge) const
+    {
+        if (not edge->Directed() or (edge->Nodes().first == edge->Nodes().second))
+            return EdgePart::Both;
+        return (edge->Nodes().first == this) ? EdgePart::Out : EdgePart::In;
+    }
+
     TNodeId m_id;
-    std::vector<Edge<Node>*> m_edges;
+    Edges_t m_edges;
+    [[no_unique_address]] std::conditional_t<IsDirected, Parts, NoParts> m_parts;
 };
 
 template <typename TNode>
@@ -86,6 +214,7 @@ class Edge
     }
 
     float Weight() const { return m_weight; }
+    void SetWeight(float weight) { m_weight = weight; }
     bool Directed() const { return m_directed; }
 
   private:
@@ -7,5 +7,8 @@
 
 #include "./conn_watch.h"
 #include "./directed.h"
+#include "./edge_index.h"
+#include "./journal.h"
 #include "./named.h"
+#include "./scc_watch.h"
 #include "./weighted.h"
@@ -2,7 +2,11 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -23,20 +27,41 @@ class ConnectedComponentWatch<TNode, TEdge, true>
 
     int ConnectedComponentsCount() const { return m_connected_components.size(); }
 
+    /**
+     * \~english
+     * @brief Get identifier of the connected component containing the node
+     * 
+     * @param node node
+     * @return component identifier or ComponentIdNone
+     */
+    /**
+     * \~russian
+     * @brief Получить идентификатор компоненты связности, содержащей вершину
+     * 
+     * @param node вершина
+     * @return идентификатор компоненты или ComponentIdNone
+     */
+    int ComponentId(TNode* node) const
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        const auto node_it = m_node_component.find(node);
+        if (node_it == m_node_component.end())
+            return ComponentIdNone;
+        return node_it->second;
+    }
+
     bool SurelyConnected(TNode* node1, TNode* node2) const
     {
         GRAPH_DEBUG_ASSERT(node1 != nullptr, "Null node 1");
         GRAPH_DEBUG_ASSERT(node2 != nullptr, "Null node 2");
-        auto component_it = FindComponent(node1);
-        return component_it->second.contains(node2);
+        return (ComponentId(node1) == ComponentId(node2));
     }
 
     bool SurelyNotConnected(TNode* node1, TNode* node2) const
     {
         GRAPH_DEBUG_ASSERT(node1 != nullptr, "Null node 1");
         GRAPH_DEBUG_ASSERT(node2 != nullptr, "Null node 2");
-        auto component_it = FindComponent(node1);
-        return (not component_it->second.contains(node2));
+        return (ComponentId(node1) != ComponentId(node2));
     }
 
   protected:
@@ -65,6 +90,7 @@ class ConnectedComponentWatch<TNode, TEdge, true>
         auto component_it = FindComponent(node);
         GRAPH_DEBUG_ASSERT(component_it != m_connected_components.end(), "Node not in components");
         DelComponent(component_it->first);
+        m_node_component.erase(node);
     }
 
     /**
@@ -90,85 +116,152 @@ class ConnectedComponentWatch<TNode, TEdge, true>
         auto node2         = edge->Nodes().second;
         auto component1_it = FindComponent(node1);
         GRAPH_DEBUG_ASSERT(component1_it != m_connected_components.end(), "Unknown edge");
-        auto component2_it = FindComponent(node2);
-        GRAPH_DEBUG_ASSERT(component2_it != m_connected_components.end(), "Unknown edge");
-        GRAPH_DEBUG_ASSERT(component1_it->first == component2_it->first, "Connection between disconnected");
+        GRAPH_DEBUG_ASSERT(ComponentId(node1) == ComponentId(node2), "Connection between disconnected");
 
         auto connected1 = GetConnectedWith(node1, node2);
         if (connected1.contains(node2))
             return;
-        DelComponent(component1_it->first);
-        auto new_component1_it    = AddComponent();
-        new_component1_it->second = std::move(connected1);
-        auto connected2           = GetConnectedWith(node2, nullptr);
-        auto new_component2_it    = AddComponent();
-        new_component2_it->second = std::move(connected2);
+        auto new_component_it = AddComponent();
+        for (auto moved_node : connected1)
+        {
+            component1_it->second.erase(moved_node);
+            m_node_component[moved_node] = new_component_it->first;
+        }
+        new_component_it->second = std::move(connected1);
     }
 
     void onAdd(TNode* node)
     {
         GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
-        GRAPH_DEBUG_ASSERT(FindComponent(node) == m_connected_components.end(), "Node already in some component");
-        std::unordered_set<int> adjacent_components;
-        const auto edges = node->Edges();
-        for (const auto& edge : edges)
-        {
-            auto* node2       = edge->OtherNode(node);
-            auto component_it = FindComponent(node2);
-            adjacent_components.insert(component_it->first);
-        }
+        GRAPH_DEBUG_ASSERT(ComponentId(node) == ComponentIdNone, "Node already in some component");
+        auto component_it = AddComponent();
+        component_it->second.insert(node);
+        m_node_component[node] = component_it->first;
 
-        if (adjacent_components.empty())
+        for (const auto& edge : node->Edges())
         {
-            auto component_it = AddComponent();
-            component_it->second.insert(node);
-        }
-        else if (adjacent_components.size() == 1)
-        {
-            const auto component_id = *adjacent_components.begin();
-            m_connected_components[component_id].insert(node);
-            return;
+            auto* node2 = edge->OtherNode(node);
+            Merge(ComponentId(node), ComponentId(node2));
         }
-        else
-        {
-            auto new_component_it = AddComponent();
-            new_component_it->second.insert(node);
-            for (const auto adjacent_component_id : adjacent_components)
-            {
-                auto adjacent_component_it = m_connected_components.find(adjacent_component_id);
-                GRAPH_DEBUG_ASSERT(adjacent_component_it != m_connected_components.end(), "Unknown component");
-                for (auto moved_node : adjacent_component_it->second)
-                    new_component_it->second.insert(moved_node);
-                m_connected_components.erase(adjacent_component_it);
-            }
-        }
-
-        return;
     }
 
     void onAdd(TEdge* edge)
     {
         GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
-        auto node1         = edge->Nodes().first;
-        auto node2         = edge->Nodes().second;
-        auto component1_it = FindComponent(node1);
-        GRAPH_DEBUG_ASSERT(component1_it != m_connected_components.end(), "Unknown edge");
-        auto component2_it = FindComponent(node2);
-        GRAPH_DEBUG_ASSERT(component2_it != m_connected_components.end(), "Unknown edge");
-        if (component1_it->first == component2_it->first)
-            return;
-        auto new_component_it = AddComponent();
-        for (auto moved_node : component1_it->second)
-            new_component_it->second.insert(moved_node);
-        m_connected_components.erase(component1_it);
-        for (auto moved_node : component2_it->second)
-            new_component_it->second.insert(moved_node);
-        m_connected_components.erase(component2_it);
+        auto node1 = edge->Nodes().first;
+        auto node2 = edge->Nodes().second;
+        GRAPH_DEBUG_ASSERT(ComponentId(node1) != ComponentIdNone, "Unknown edge");
+        GRAPH_DEBUG_ASSERT(ComponentId(node2) != ComponentIdNone, "Unknown edge");
+        Merge(ComponentId(node1), ComponentId(node2));
     }
 
-    void Clear() { m_connected_components.clear(); };
+    void Clear()
+    {
+        m_connected_components.clear();
+        m_node_component.clear();
+    };
+
+    /**
+     * \~english
+     * @brief Recompute all components from scratch after a bulk update
+     * 
+     * @param nodes all nodes of the graph
+     */
+    /**
+     * \~russian
+     * @brief Пересчитать все компоненты с нуля после группового изменения
+     * 
+     * @param nodes все вершины графа
+     */
+    template <typename TNodes>
+    void Rebuild(const TNodes& nodes)
+    {
+        RebuildComponents(nodes, []([[maybe_unused]] TEdge* edge) {});
+    }
+
+    /**
+     * \~english
+     * @brief Set all components at once from labels computed elsewhere, e.g. by ParallelConnectedComponents
+     *
+     * @param nodes all nodes of the graph
+     * @param components dense component label of every node in the order of nodes
+     * @param count count of components
+     */
+    /**
+     * \~russian
+     * @brief Задать все компоненты сразу по меткам, вычисленным в другом месте, например ParallelConnectedComponents
+     *
+     * @param nodes все вершины графа
+     * @param components плотная метка компоненты каждой вершины в порядке nodes
+     * @param count количество компонент
+     */
+    template <typename TNodes>
+    void AssignComponents(const TNodes& nodes, std::span<const int32_t> components, int count)
+    {
+        GRAPH_DEBUG_ASSERT(components.size() == nodes.size(), "Wrong count of labels");
+        Clear();
+        m_node_component.reserve(nodes.size());
+        m_connected_components.reserve(count);
+        // new ids follow the ids given so far, as if the components were added one by one
+        const int first_id = m_component_id + 1;
+        size_t index       = 0;
+        for (const auto& node_el : nodes)
+        {
+            const int component_id = first_id + components[index++];
+            m_node_component.emplace(node_el.second, component_id);
+            m_connected_components[component_id].insert(node_el.second);
+        }
+        m_component_id = first_id + count - 1;
+    }
+
+  protected:
+    /**
+     * \~english
+     * @brief Recompute all components by breadth-first search
+     * 
+     * @param nodes all nodes of the graph
+     * @param on_tree_edge function called for every edge of the search trees
+     */
+    /**
+     * \~russian
+     * @brief Пересчитать все компоненты поиском в ширину
+     * 
+     * @param nodes все вершины графа
+     * @param on_tree_edge функция, вызываемая для каждого ребра деревьев поиска
+     */
+    template <typename TNodes, typename TOnTreeEdge>
+    void RebuildComponents(const TNodes& nodes, TOnTreeEdge on_tree_edge)
+    {
+        Clear();
+        m_node_component.reserve(nodes.size());
+        std::vector<TNode*> front;
+        for (const auto& node_el : nodes)
+        {
+            auto start = node_el.second;
+            if (m_node_component.contains(start))
+                continue;
+            auto component_it       = AddComponent();
+            auto& component         = component_it->second;
+            m_node_component[start] = component_it->first;
+            component.insert(start);
+            front.push_back(start);
+            while (not front.empty())
+            {
+                auto node = front.back();
+                front.pop_back();
+                for (auto edge : node->Edges())
+                {
+                    auto node_to = edge->OtherNode(node);
+                    if (not m_node_component.emplace(node_to, component_it->first).second)
+                        continue;
+                    component.insert(node_to);
+                    on_tree_edge(edge);
+                    front.push_back(node_to);
+                }
+            }
+        }
+    }
 
-  private:
     NodesSet_t GetConnectedWith(TNode* node, TNode* stop_node)
     {
         NodesSet_t connected;
@@ -197,6 +290,38 @@ class ConnectedComponentWatch<TNode, TEdge, true>
         return connected;
     }
 
+    /**
+     * \~english
+     * @brief Merge two components relabeling only nodes of the smaller one
+     * 
+     * @param component1_id first component
+     * @param component2_id second component
+     */
+    /**
+     * \~russian
+     * @brief Объединить две компоненты, перемаркировав только вершины меньшей из них
+     * 
+     * @param component1_id первая компонента
+     * @param component2_id вторая компонента
+     */
+    void Merge(int component1_id, int component2_id)
+    {
+        if (component1_id == component2_id)
+            return;
+        auto component1_it = m_connected_components.find(component1_id);
+        GRAPH_DEBUG_ASSERT(component1_it != m_connected_components.end(), "Unknown component");
+        auto component2_it = m_connected_components.find(component2_id);
+        GRAPH_DEBUG_ASSERT(component2_it != m_connected_components.end(), "Unknown component");
+        if (component1_it->second.size() < component2_it->second.size())
+            std::swap(component1_it, component2_it);
+        for (auto moved_node : component2_it->second)
+        {
+            component1_it->second.insert(moved_node);
+            m_node_component[moved_node] = component1_it->first;
+        }
+        m_connected_components.erase(component2_it);
+    }
+
     auto AddComponent()
     {
         ++m_component_id;
@@ -206,22 +331,244 @@ class ConnectedComponentWatch<TNode, TEdge, true>
 
     void DelComponent(int component_id) { m_connected_components.erase(component_id); }
 
-    auto FindComponent(TNode* node) const
+    auto FindComponent(TNode* node)
+    {
+        const auto node_it = m_node_component.find(node);
+        if (node_it == m_node_component.end())
+            return m_connected_components.end();
+        return m_connected_components.find(node_it->second);
+    }
+
+    int m_component_id = ComponentIdNone;
+    std::unordered_map<int, NodesSet_t> m_connected_components;
+    std::unordered_map<TNode*, int> m_node_component;
+};
+
+/**
+ * \~english
+ * @brief Connected components watch that keeps a spanning tree of every component
+ * 
+ * Every component stays connected through its spanning edges, so deleting any other edge costs O(1). Deleting a
+ * spanning edge cuts its tree in two, they are walked through along spanning edges from both endpoints in lockstep
+ * until the smaller one is exhausted. The first edge found between the trees, or leaving the exhausted one, replaces
+ * the deleted one, without such an edge the smaller tree is split off into a new component. So the cost is bounded by
+ * the smaller tree and its edges, not by the whole component, and a component of N nodes has exactly N - 1 spanning
+ * edges.
+ * 
+ * @tparam TNode node type
+ * @tparam TEdge edge type
+ */
+/**
+ * \~russian
+ * @brief Отслеживание компонент связности с поддержкой остовного дерева каждой компоненты
+ * 
+ * Каждая компонента остаётся связной по своим остовным рёбрам, поэтому удаление любого другого ребра стоит O(1).
+ * Удаление остовного ребра разрезает его дерево на два, они обходятся по остовным рёбрам из обоих концов поочерёдно,
+ * пока меньшее не будет исчерпано. Первое найденное ребро между деревьями или выходящее из исчерпанного дерева заменяет
+ * удалённое, а без такого ребра меньшее дерево выделяется в новую компоненту. Таким образом стоимость ограничена
+ * меньшим деревом и его рёбрами, а не всей компонентой, и у компоненты из N вершин ровно N - 1 остовных рёбер.
+ * 
+ * @tparam TNode тип вершины
+ * @tparam TEdge тип ребра
+ */
+template <typename TNode, typename TEdge>
+class ConnectedComponentWatchDynamic : public ConnectedComponentWatch<TNode, TEdge, true>
+{
+  public:
+    using Base_t = ConnectedComponentWatch<TNode, TEdge, true>;
+    using typename Base_t::NodesSet_t;
+
+    /**
+     * \~english
+     * @brief Check if the edge belongs to the spanning forest
+     * 
+     * @param edge edge
+     * @return true edge is spanning
+     * @return false edge is not spanning
+     */
+    /**
+     * \~russian
+     * @brief Проверить, входит ли ребро в остовный лес
+     * 
+     * @param edge ребро
+     * @return true ребро остовное
+     * @return false ребро не остовное
+     */
+    bool IsSpanningEdge(TEdge* edge) const { return m_spanning_edges.contains(edge); }
+
+    /**
+     * \~english
+     * @brief Count of spanning edges, the count of nodes minus the count of components
+     */
+    /**
+     * \~russian
+     * @brief Количество остовных рёбер, количество вершин минус количество компонент
+     */
+    size_t SpanningEdgesCount() const { return m_spanning_edges.size(); }
+
+  protected:
+    void onDel(TNode* node) { Base_t::onDel(node); }
+
+    /**
+     * \~english
+     * @brief Handling edge deletion event
+     * 
+     * @param edge removed edge
+     * 
+     * @remark function must be called immediately after an edge is removed from its endpoints and edge list
+     */
+    /**
+     * \~russian
+     * @brief Обработка события удаления ребра
+     * 
+     * @param edge удалённое ребро
+     * 
+     * @remark функция должна вызываться непосредственно после удаления ребра из его концов и списка рёбер
+     */
+    void onDel(TEdge* edge)
     {
-        auto component_it = m_connected_components.begin();
-        while (component_it != m_connected_components.end())
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        if (m_spanning_edges.erase(edge) == 0)
+            return;
+        auto node1 = edge->Nodes().first;
+        auto node2 = edge->Nodes().second;
+        GRAPH_DEBUG_ASSERT(Base_t::ComponentId(node1) == Base_t::ComponentId(node2), "Connection between disconnected");
+
+        // the spanning tree is cut in two, the smaller part is the first one walked through
+        std::array<Search, 2> search{Search(node1), Search(node2)};
+        size_t side = 0;
+        while (not search[side].Exhausted())
         {
-            if (component_it->second.contains(node))
+            auto front_node = search[side].Pop();
+            for (auto neighbour_edge : front_node->Edges())
             {
-                return component_it;
+                auto neighbour_node = neighbour_edge->OtherNode(front_node);
+                if (m_spanning_edges.contains(neighbour_edge))
+                {
+                    search[side].Push(neighbour_node);
+                }
+                else if (search[1 - side].Visited(neighbour_node))
+                {
+                    // an edge between the parts reconnects the tree before any of them is exhausted
+                    m_spanning_edges.insert(neighbour_edge);
+                    return;
+                }
             }
-            ++component_it;
+            side = 1 - side;
         }
-        return component_it;
+
+        const auto& part = search[side];
+        for (auto part_node : part.Nodes())
+        {
+            for (auto neighbour_edge : part_node->Edges())
+            {
+                if (not part.Visited(neighbour_edge->OtherNode(part_node)))
+                {
+                    m_spanning_edges.insert(neighbour_edge);
+                    return;
+                }
+            }
+        }
+        SplitOff(node1, part);
     }
 
-    int m_component_id = ComponentIdNone;
-    std::unordered_map<int, NodesSet_t> m_connected_components;
+    void onAdd(TNode* node)
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        // the first edge to each of the components joined by the node spans it
+        std::unordered_set<int> joined;
+        for (const auto& edge : node->Edges())
+        {
+            auto node2 = edge->OtherNode(node);
+            if ((node2 != node) and joined.insert(Base_t::ComponentId(node2)).second)
+                m_spanning_edges.insert(edge);
+        }
+        Base_t::onAdd(node);
+    }
+
+    void onAdd(TEdge* edge)
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        auto node1 = edge->Nodes().first;
+        auto node2 = edge->Nodes().second;
+        if (Base_t::ComponentId(node1) == Base_t::ComponentId(node2))
+            return;
+        m_spanning_edges.insert(edge);
+        Base_t::Merge(Base_t::ComponentId(node1), Base_t::ComponentId(node2));
+    }
+
+    void Clear()
+    {
+        Base_t::Clear();
+        m_spanning_edges.clear();
+    }
+
+    template <typename TNodes>
+    void Rebuild(const TNodes& nodes)
+    {
+        m_spanning_edges.clear();
+        Base_t::RebuildComponents(nodes, [&](TEdge* edge) { m_spanning_edges.insert(edge); });
+    }
+
+    /**
+     * \~english
+     * @brief Labels do not give spanning edges, so components are recomputed by Rebuild
+     */
+    /**
+     * \~russian
+     * @brief Метки не дают остовных рёбер, поэтому компоненты пересчитываются Rebuild
+     */
+    template <typename TNodes>
+    void AssignComponents(const TNodes& nodes, [[maybe_unused]] std::span<const int32_t> components,
+                          [[maybe_unused]] int count)
+    {
+        Rebuild(nodes);
+    }
+
+  private:
+    /**
+     * \~english
+     * @brief Breadth-first search state over spanning edges
+     */
+    /**
+     * \~russian
+     * @brief Состояние поиска в ширину по остовным рёбрам
+     */
+    class Search
+    {
+      public:
+        explicit Search(TNode* start) : m_front{start} { m_visited.insert(start); }
+
+        bool Exhausted() const { return m_front_pos == m_front.size(); }
+        bool Visited(TNode* node) const { return m_visited.contains(node); }
+        TNode* Pop() { return m_front[m_front_pos++]; }
+        const std::vector<TNode*>& Nodes() const { return m_front; }
+
+        void Push(TNode* node)
+        {
+            if (m_visited.insert(node).second)
+                m_front.push_back(node);
+        }
+
+      private:
+        std::vector<TNode*> m_front;
+        size_t m_front_pos = 0;
+        NodesSet_t m_visited;
+    };
+
+    void SplitOff(TNode* node, const Search& search)
+    {
+        auto component_it     = Base_t::FindComponent(node);
+        auto new_component_it = Base_t::AddComponent();
+        for (auto moved_node : search.Nodes())
+        {
+            component_it->second.erase(moved_node);
+            Base_t::m_node_component[moved_node] = new_component_it->first;
+            new_component_it->second.insert(moved_node);
+        }
+    }
+
+    std::unordered_set<TEdge*> m_spanning_edges;
 };
 
 template <typename TNode, typename TEdge>
@@ -229,6 +576,7 @@ class ConnectedComponentWatch<TNode, TEdge, false>
 {
   public:
     int ConnectedComponentsCount() const { return -1; }
+    int ComponentId([[maybe_unused]] TNode* node) const { return -1; }
 
     bool SurelyConnected([[maybe_unused]] TNode* node1, [[maybe_unused]] TNode* node2) const { return false; }
     bool SurelyNotConnected([[maybe_unused]] TNode* node1, [[maybe_unused]] TNode* node2) const { return false; }
@@ -242,6 +590,15 @@ class ConnectedComponentWatch<TNode, TEdge, false>
     void onDel([[maybe_unused]] TEdge* edge) {}
 
     void Clear() {};
+
+    template <typename TNodes>
+    void Rebuild([[maybe_unused]] const TNodes& nodes)
+    {}
+
+    template <typename TNodes>
+    void AssignComponents([[maybe_unused]] const TNodes& nodes, [[maybe_unused]] std::span<const int32_t> components,
+                          [[maybe_unused]] int count)
+    {}
 };
 
 }  // namespace GG
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+#include "../common.h"
+#include "../hash.h"
+
+namespace GG
+{
+
+template <typename TNode, typename TEdge, bool IsIndexed, bool IsSimple = false>
+class EdgeIndex
+{};
+
+/**
+ * \~english
+ * @brief Edge index policy: edges are found by their pair of nodes in constant time
+ *
+ * Every edge is kept in a hash table keyed by its first and second node, so edge lookup and deletion between two nodes
+ * do not depend on node degrees, hub nodes included.
+ *
+ * @tparam IsSimple simple graph mode: MakeEdge and LoadEdges reject edges duplicating an existing connection
+ */
+/**
+ * \~russian
+ * @brief Политика индекса рёбер: рёбра находятся по их паре вершин за постоянное время
+ *
+ * Каждое ребро хранится в хеш-таблице по его первой и второй вершинам, поэтому поиск и удаление рёбер между двумя
+ * вершинами не зависят от степеней вершин, включая вершины-концентраторы.
+ *
+ * @tparam IsSimple режим простого графа: MakeEdge и LoadEdges отвергают рёбра, дублирующие существующую связь
+ */
+template <typename TNode, typename TEdge, bool IsSimple>
+class EdgeIndex<TNode, TEdge, true, IsSimple>
+{
+  public:
+    static constexpr bool IsEdgeIndexed = true;
+    static constexpr bool IsSimpleGraph = IsSimple;
+
+  protected:
+    void onAdd(TEdge* edge)
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        m_index.emplace(edge->Nodes(), edge);
+    }
+
+    void onDel(TEdge* edge)
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        auto [edge_it, edges_end] = m_index.equal_range(edge->Nodes());
+        for (; edge_it != edges_end; ++edge_it)
+        {
+            if (edge_it->second == edge)
+            {
+                m_index.erase(edge_it);
+                return;
+            }
+        }
+    }
+
+    void onClear() { m_index.clear(); }
+
+    void ReserveEdges(size_t count) { m_index.reserve(count); }
+
+    /**
+     * \~english
+     * @brief Call a function for every edge with exactly these first and second nodes
+     */
+    /**
+     * \~russian
+     * @brief Вызвать функцию для каждого ребра ровно с этими первой и второй вершинами
+     */
+    template <typename TFunc>
+    void ForEachStoredEdge(TNode* node1, TNode* node2, TFunc func) const
+    {
+        auto [edge_it, edges_end] = m_index.equal_range(std::make_pair(node1, node2));
+        for (; edge_it != edges_end; ++edge_it)
+            func(edge_it->second);
+    }
+
+  private:
+    // pointers are aligned, so both are mixed before their low bits pick buckets
+    struct NodePairHash {
+        size_t operator()(const std::pair<TNode*, TNode*>& nodes) const
+        {
+            const auto address1 = reinterpret_cast<uintptr_t>(nodes.first);
+            const auto address2 = reinterpret_cast<uintptr_t>(nodes.second);
+            return MixHash(address1 ^ MixHash(address2));
+        }
+    };
+
+    std::unordered_multimap<std::pair<TNode*, TNode*>, TEdge*, NodePairHash> m_index;
+};
+
+/**
+ * \~english
+ * @brief No edge index: edges between two nodes are found by scanning the edges of the node of lower degree
+ *
+ * A loop is listed twice at its node, so it may be reported twice.
+ */
+/**
+ * \~russian
+ * @brief Без индекса рёбер: рёбра между двумя вершинами находятся просмотром рёбер вершины меньшей степени
+ *
+ * Петля указана у своей вершины дважды, поэтому о ней может быть сообщено дважды.
+ */
+template <typename TNode, typename TEdge, bool IsSimple>
+class EdgeIndex<TNode, TEdge, false, IsSimple>
+{
+  public:
+    static constexpr bool IsEdgeIndexed = false;
+    static constexpr bool IsSimpleGraph = IsSimple;
+
+  protected:
+    void onAdd([[maybe_unused]] TEdge* edge) {}
+    void onDel([[maybe_unused]] TEdge* edge) {}
+    void onClear() {}
+    void ReserveEdges([[maybe_unused]] size_t count) {}
+
+    template <typename TFunc>
+    void ForEachStoredEdge(TNode* node1, TNode* node2, TFunc func) const
+    {
+        const auto* node = (node1->Edges().size() <= node2->Edges().size()) ? node1 : node2;
+        for (const auto edge : node->Edges())
+        {
+            if ((edge->Nodes().first == node1) and (edge->Nodes().second == node2))
+                func(edge);
+        }
+    }
+};
+
+}  // namespace GG
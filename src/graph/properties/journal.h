@@ -0,0 +1,266 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../common.h"
+#include "../export.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Header of a mutation journal file
+ *
+ * The header is followed by records: one byte of JournalRecord type and fixed size fields stored as raw bytes.
+ * Generation binds the journal to the snapshot it continues.
+ */
+/**
+ * \~russian
+ * @brief Заголовок файла журнала изменений
+ *
+ * За заголовком следуют записи: один байт типа JournalRecord и поля фиксированного размера, хранящиеся как сырые
+ * байты. Поколение связывает журнал со снимком, который он продолжает.
+ */
+struct JournalHeader {
+    static constexpr std::array<char, 8> Magic = {'G', 'G', 'J', 'R', 'N', 'L', '\0', '\0'};
+    static constexpr uint32_t CurrentVersion   = 1;
+
+    std::array<char, 8> magic = Magic;
+    uint32_t version          = CurrentVersion;
+    uint32_t id_size          = 0;
+    uint64_t generation       = 0;
+};
+
+/**
+ * \~english
+ * @brief Journal record types
+ *
+ * Node records hold the node id. Edge records hold ids of the first and the second node, directed flag byte and
+ * weight, SetWeight also holds the new weight.
+ */
+/**
+ * \~russian
+ * @brief Типы записей журнала
+ *
+ * Записи вершин содержат идентификатор вершины. Записи рёбер содержат идентификаторы первой и второй вершин, байт
+ * признака направленности и вес, SetWeight также содержит новый вес.
+ */
+enum class JournalRecord : uint8_t
+{
+    AddNode = 1,
+    DelNode,
+    AddEdge,
+    DelEdge,
+    SetWeight,
+    Clear
+};
+
+/**
+ * \~english
+ * @brief Create an empty journal file
+ *
+ * @param path file path
+ * @param generation generation of the snapshot the journal continues
+ * @return true if the file is created and synced
+ */
+/**
+ * \~russian
+ * @brief Создать пустой файл журнала
+ *
+ * @param path путь к файлу
+ * @param generation поколение снимка, который продолжает журнал
+ * @return true, если файл создан и синхронизирован
+ */
+template <typename TNodeId>
+bool CreateJournalFile(const std::string& path, uint64_t generation)
+{
+    static_assert(std::is_trivially_copyable_v<TNodeId>, "Journal stores node ids as raw bytes");
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    JournalHeader header;
+    header.id_size    = sizeof(TNodeId);
+    header.generation = generation;
+    const bool ok     = (::write(fd, &header, sizeof(header)) == sizeof(header)) and (::fdatasync(fd) == 0);
+    return (::close(fd) == 0) and ok;
+}
+
+template <typename TNode, typename TEdge, bool IsJournaled>
+class Journal
+{};
+
+/**
+ * \~english
+ * @brief Journal policy appending every mutation of a graph to a file
+ *
+ * Records are buffered and written in groups, CommitJournal makes all records before it durable with one sync. Nothing
+ * is recorded while the journal is closed, e.g. during replay. Clear is a mutation like any other and is recorded as a
+ * wipe of the graph: close the journal before clearing a graph only to release its memory.
+ */
+/**
+ * \~russian
+ * @brief Политика журнала, дописывающая каждое изменение графа в файл
+ *
+ * Записи буферизуются и пишутся группами, CommitJournal делает все предшествующие записи надёжно сохранёнными одной
+ * синхронизацией. Пока журнал закрыт, например во время воспроизведения, ничего не записывается. Clear - такое же
+ * изменение, как и остальные, и записывается как стирание графа: закройте журнал перед очисткой графа только ради
+ * освобождения его памяти.
+ */
+template <typename TNode, typename TEdge>
+class Journal<TNode, TEdge, true>
+{
+  public:
+    using NodeId_t = typename TNode::NodeId_t;
+    static_assert(std::is_trivially_copyable_v<NodeId_t>, "Journal stores node ids as raw bytes");
+
+    Journal() = default;
+    Journal(const Journal&)            = delete;
+    Journal& operator=(const Journal&) = delete;
+    ~Journal() { CloseJournal(); }
+
+    /**
+     * \~english
+     * @brief Open a journal file created by CreateJournalFile for appending
+     *
+     * @param path file path
+     * @return true if the file is opened and its header fits the graph
+     */
+    /**
+     * \~russian
+     * @brief Открыть файл журнала, созданный CreateJournalFile, для дописывания
+     *
+     * @param path путь к файлу
+     * @return true, если файл открыт и его заголовок подходит графу
+     */
+    bool OpenJournal(const std::string& path)
+    {
+        CloseJournal();
+        const int fd = ::open(path.c_str(), O_RDWR | O_APPEND);
+        if (fd < 0)
+            return false;
+        JournalHeader header;
+        if ((::pread(fd, &header, sizeof(header), 0) != sizeof(header)) or (header.magic != JournalHeader::Magic) or
+            (header.version != JournalHeader::CurrentVersion) or (header.id_size != sizeof(NodeId_t)))
+        {
+            ::close(fd);
+            return false;
+        }
+        m_fd         = fd;
+        m_generation = header.generation;
+        m_sink       = std::make_unique<BufferedSink<FdWriter>>(FdWriter(m_fd));
+        return true;
+    }
+
+    /**
+     * \~english
+     * @brief Write buffered records and wait until they are on disk
+     *
+     * @return true if records are synced, false if any write since opening or the sync failed
+     */
+    /**
+     * \~russian
+     * @brief Записать буферизованные записи и дождаться их сохранения на диске
+     *
+     * @return true, если записи синхронизированы, false, если не удалась любая запись с момента открытия или
+     * синхронизация
+     */
+    bool CommitJournal()
+    {
+        if (m_sink == nullptr)
+            return false;
+        const bool written = m_sink->Flush();
+        return (::fdatasync(m_fd) == 0) and written;
+    }
+
+    void CloseJournal()
+    {
+        if (m_sink == nullptr)
+            return;
+        CommitJournal();
+        m_sink.reset();
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    bool JournalOpened() const { return (m_sink != nullptr); }
+    uint64_t JournalGeneration() const { return m_generation; }
+
+  protected:
+    static constexpr bool Journaling = true;
+
+    void onAdd(TNode* node) { WriteNode(JournalRecord::AddNode, node); }
+    void onDel(TNode* node) { WriteNode(JournalRecord::DelNode, node); }
+    void onAdd(TEdge* edge) { WriteEdge(JournalRecord::AddEdge, edge); }
+    void onDel(TEdge* edge) { WriteEdge(JournalRecord::DelEdge, edge); }
+
+    void onSetWeight(TEdge* edge, float weight)
+    {
+        if (WriteEdge(JournalRecord::SetWeight, edge))
+            WriteRaw(weight);
+    }
+
+    void onClear()
+    {
+        if (m_sink != nullptr)
+            WriteRaw(JournalRecord::Clear);
+    }
+
+  private:
+    template <typename T>
+    void WriteRaw(const T& value)
+    {
+        *m_sink << std::string_view(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void WriteNode(JournalRecord record, TNode* node)
+    {
+        if (m_sink == nullptr)
+            return;
+        WriteRaw(record);
+        WriteRaw(node->Id());
+    }
+
+    bool WriteEdge(JournalRecord record, TEdge* edge)
+    {
+        if (m_sink == nullptr)
+            return false;
+        WriteRaw(record);
+        WriteRaw(edge->Nodes().first->Id());
+        WriteRaw(edge->Nodes().second->Id());
+        WriteRaw(static_cast<uint8_t>(edge->Directed() ? 1 : 0));
+        WriteRaw(edge->Weight());
+        return true;
+    }
+
+    int m_fd              = -1;
+    uint64_t m_generation = 0;
+    std::unique_ptr<BufferedSink<FdWriter>> m_sink;
+};
+
+template <typename TNode, typename TEdge>
+class Journal<TNode, TEdge, false>
+{
+  protected:
+    static constexpr bool Journaling = false;
+
+    void onAdd([[maybe_unused]] TNode* node) {}
+    void onAdd([[maybe_unused]] TEdge* edge) {}
+    void onDel([[maybe_unused]] TNode* node) {}
+    void onDel([[maybe_unused]] TEdge* edge) {}
+    void onSetWeight([[maybe_unused]] TEdge* edge, [[maybe_unused]] float weight) {}
+    void onClear() {}
+};
+
+}  // namespace GG
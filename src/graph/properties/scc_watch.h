@@ -0,0 +1,432 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Strongly connected components watch for directed graphs
+ *
+ * Component identifiers are kept in topological order of the condensation: every edge goes from a component to the
+ * same or a greater one. Edges that agree with the order are added in O(1). An edge against the order only touches
+ * components between its endpoints, those are recomputed with Tarjan's algorithm and renumbered in place. Deleting an
+ * edge inside a component postpones a full recomputation until the next query.
+ *
+ * @tparam TNode node type
+ * @tparam TEdge edge type
+ */
+/**
+ * \~russian
+ * @brief Отслеживание компонент сильной связности для ориентированных графов
+ *
+ * Идентификаторы компонент хранятся в топологическом порядке конденсации: каждое ребро ведёт из компоненты в ту же
+ * или в большую. Рёбра, согласованные с порядком, добавляются за O(1). Ребро против порядка затрагивает только
+ * компоненты между его концами, они пересчитываются алгоритмом Тарьяна и перенумеровываются на месте. Удаление ребра
+ * внутри компоненты откладывает полный пересчёт до следующего запроса.
+ *
+ * @tparam TNode тип вершины
+ * @tparam TEdge тип ребра
+ */
+template <typename TNode, typename TEdge>
+class StronglyConnectedComponentWatch
+{
+  public:
+    static constexpr int ComponentIdNone = -1;
+    using NodesSet_t                     = std::unordered_set<TNode*>;
+    using Components_t                   = std::map<int, NodesSet_t>;
+    using Condensation_t                 = std::map<int, std::unordered_set<int>>;
+
+    int ConnectedComponentsCount() const
+    {
+        Actualize();
+        return m_components.size();
+    }
+
+    /**
+     * \~english
+     * @brief Get identifier of the strongly connected component containing the node
+     *
+     * @param node node
+     * @return component identifier or ComponentIdNone
+     */
+    /**
+     * \~russian
+     * @brief Получить идентификатор компоненты сильной связности, содержащей вершину
+     *
+     * @param node вершина
+     * @return идентификатор компоненты или ComponentIdNone
+     */
+    int ComponentId(TNode* node) const
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        Actualize();
+        const auto node_it = m_node_component.find(node);
+        if (node_it == m_node_component.end())
+            return ComponentIdNone;
+        return node_it->second;
+    }
+
+    /**
+     * \~english
+     * @brief Check if nodes are mutually reachable
+     *
+     * @param node1 first node
+     * @param node2 second node
+     * @return true nodes are in the same strongly connected component
+     * @return false unknown
+     */
+    /**
+     * \~russian
+     * @brief Проверить взаимную достижимость вершин
+     *
+     * @param node1 первая вершина
+     * @param node2 вторая вершина
+     * @return true вершины в одной компоненте сильной связности
+     * @return false неизвестно
+     */
+    bool SurelyConnected(TNode* node1, TNode* node2) const
+    {
+        GRAPH_DEBUG_ASSERT(node1 != nullptr, "Null node 1");
+        GRAPH_DEBUG_ASSERT(node2 != nullptr, "Null node 2");
+        return (ComponentId(node1) == ComponentId(node2));
+    }
+
+    /**
+     * \~english
+     * @brief Check if the second node is definitely unreachable from the first one
+     *
+     * @param node1 node from
+     * @param node2 node to
+     * @return true node2 is unreachable from node1
+     * @return false unknown
+     */
+    /**
+     * \~russian
+     * @brief Проверить, что вторая вершина заведомо недостижима из первой
+     *
+     * @param node1 вершина откуда
+     * @param node2 вершина куда
+     * @return true node2 недостижима из node1
+     * @return false неизвестно
+     */
+    bool SurelyNotConnected(TNode* node1, TNode* node2) const
+    {
+        GRAPH_DEBUG_ASSERT(node1 != nullptr, "Null node 1");
+        GRAPH_DEBUG_ASSERT(node2 != nullptr, "Null node 2");
+        return (ComponentId(node1) > ComponentId(node2));
+    }
+
+    /**
+     * \~english
+     * @brief Get the condensation DAG
+     *
+     * @return successors of every component
+     */
+    /**
+     * \~russian
+     * @brief Получить граф конденсации
+     *
+     * @return последователи каждой компоненты
+     */
+    Condensation_t Condensation() const
+    {
+        Actualize();
+        Condensation_t condensation;
+        for (const auto& component_el : m_components)
+        {
+            auto& successors = condensation[component_el.first];
+            for (auto node : component_el.second)
+            {
+                ForEachOut(node, [&](TNode* node_to) {
+                    const auto component_to = m_node_component.at(node_to);
+                    if (component_to != component_el.first)
+                        successors.insert(component_to);
+                });
+            }
+        }
+        return condensation;
+    }
+
+    const Components_t& Components() const
+    {
+        Actualize();
+        return m_components;
+    }
+
+  protected:
+    static constexpr bool Watching = true;
+
+    void onDel(TNode* node)
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        GRAPH_DEBUG_ASSERT(node->Edges().empty(), "Deleted node must not have edges");
+        const auto node_it = m_node_component.find(node);
+        GRAPH_DEBUG_ASSERT(node_it != m_node_component.end(), "Node not in components");
+        const auto component_it = m_components.find(node_it->second);
+        component_it->second.erase(node);
+        if (component_it->second.empty())
+            m_components.erase(component_it);
+        m_node_component.erase(node_it);
+    }
+
+    void onDel(TEdge* edge)
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        if (m_dirty)
+            return;
+        if (m_node_component.at(edge->Nodes().first) == m_node_component.at(edge->Nodes().second))
+            m_dirty = true;
+    }
+
+    void onAdd(TNode* node)
+    {
+        GRAPH_DEBUG_ASSERT(node != nullptr, "Null node");
+        GRAPH_DEBUG_ASSERT(not m_node_component.contains(node), "Node already in some component");
+        ++m_component_id;
+        m_node_component[node] = m_component_id;
+        m_components[m_component_id].insert(node);
+        for (const auto& edge : node->Edges())
+            onAdd(edge);
+    }
+
+    void onAdd(TEdge* edge)
+    {
+        GRAPH_DEBUG_ASSERT(edge != nullptr, "Null edge");
+        if (m_dirty)
+            return;
+        const auto component1 = m_node_component.at(edge->Nodes().first);
+        const auto component2 = m_node_component.at(edge->Nodes().second);
+        if (component1 == component2)
+            return;
+        if (edge->Directed())
+        {
+            if (component1 < component2)
+                return;
+            Renumber(component2, component1);
+        }
+        else
+        {
+            Renumber(std::min(component1, component2), std::max(component1, component2));
+        }
+    }
+
+    void Clear()
+    {
+        m_components.clear();
+        m_node_component.clear();
+        m_component_id = ComponentIdNone;
+        m_dirty        = false;
+    }
+
+    /**
+     * \~english
+     * @brief Register all nodes after a bulk update, components are recomputed on the next query
+     *
+     * @param nodes all nodes of the graph
+     */
+    /**
+     * \~russian
+     * @brief Зарегистрировать все вершины после группового изменения, компоненты пересчитываются при следующем запросе
+     *
+     * @param nodes все вершины графа
+     */
+    template <typename TNodes>
+    void Rebuild(const TNodes& nodes)
+    {
+        Clear();
+        for (const auto& node_el : nodes)
+        {
+            ++m_component_id;
+            m_node_component[node_el.second] = m_component_id;
+            m_components[m_component_id].insert(node_el.second);
+        }
+        m_dirty = true;
+    }
+
+  private:
+    template <typename TFunc>
+    static void ForEachOut(TNode* node, TFunc func)
+    {
+        if constexpr (requires { node->OutEdges(); })
+        {
+            for (const auto& edge : node->OutEdges())
+                func(edge->OtherNode(node));
+        }
+        else
+        {
+            for (const auto& edge : node->Edges())
+            {
+                if (not edge->Directed())
+                    func(edge->OtherNode(node));
+                else if (edge->Nodes().first == node)
+                    func(edge->Nodes().second);
+            }
+        }
+    }
+
+    void Actualize() const
+    {
+        if (not m_dirty)
+            return;
+        m_dirty = false;
+        Renumber(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    }
+
+    /**
+     * \~english
+     * @brief Recompute components with identifiers in a range and renumber them in topological order
+     *
+     * @param component_min minimum component identifier
+     * @param component_max maximum component identifier
+     *
+     * @remark edges between nodes of the range must not leave it, it is true for any range while the order is valid
+     */
+    /**
+     * \~russian
+     * @brief Пересчитать компоненты с идентификаторами в диапазоне и перенумеровать их в топологическом порядке
+     *
+     * @param component_min минимальный идентификатор компоненты
+     * @param component_max максимальный идентификатор компоненты
+     *
+     * @remark пути между вершинами диапазона не должны его покидать, это верно для любого диапазона при верном порядке
+     */
+    void Renumber(int component_min, int component_max) const
+    {
+        const bool full = (component_min == std::numeric_limits<int>::min());
+        std::vector<TNode*> nodes;
+        const auto begin_it = m_components.lower_bound(component_min);
+        const auto end_it   = m_components.upper_bound(component_max);
+        for (auto component_it = begin_it; component_it != end_it; ++component_it)
+            nodes.insert(nodes.end(), component_it->second.begin(), component_it->second.end());
+        m_components.erase(begin_it, end_it);
+
+        auto sccs = Tarjan(nodes, [&](TNode* node) {
+            const auto component = m_node_component.at(node);
+            return (component >= component_min) and (component <= component_max);
+        });
+
+        int component_id = full ? 0 : component_min;
+        for (auto scc_it = sccs.rbegin(); scc_it != sccs.rend(); ++scc_it)
+        {
+            auto& component = m_components[component_id];
+            for (auto node : *scc_it)
+            {
+                m_node_component[node] = component_id;
+                component.insert(node);
+            }
+            ++component_id;
+        }
+        if (full)
+            m_component_id = component_id - 1;
+    }
+
+    /**
+     * \~english
+     * @brief Iterative Tarjan's algorithm
+     *
+     * @param nodes nodes to traverse
+     * @param inside predicate for nodes the traversal may enter
+     * @return strongly connected components in reverse topological order
+     */
+    /**
+     * \~russian
+     * @brief Итеративный алгоритм Тарьяна
+     *
+     * @param nodes вершины для обхода
+     * @param inside предикат вершин, в которые разрешено заходить
+     * @return компоненты сильной связности в обратном топологическом порядке
+     */
+    template <typename TInside>
+    static std::vector<std::vector<TNode*>> Tarjan(const std::vector<TNode*>& nodes, TInside inside)
+    {
+        struct NodeState {
+            int index   = 0;
+            int lowlink = 0;
+            bool on_stack = false;
+        };
+        struct Frame {
+            TNode* node = nullptr;
+            std::vector<TNode*> out;
+            size_t out_pos = 0;
+        };
+
+        std::vector<std::vector<TNode*>> sccs;
+        std::unordered_map<TNode*, NodeState> states;
+        states.reserve(nodes.size());
+        std::vector<TNode*> stack;
+        std::vector<Frame> call_stack;
+        int index = 0;
+
+        auto enter = [&](TNode* node) {
+            states[node] = NodeState{index, index, true};
+            ++index;
+            stack.push_back(node);
+            Frame frame{node, {}, 0};
+            ForEachOut(node, [&](TNode* node_to) {
+                if (inside(node_to))
+                    frame.out.push_back(node_to);
+            });
+            call_stack.push_back(std::move(frame));
+        };
+
+        for (auto root : nodes)
+        {
+            if (states.contains(root))
+                continue;
+            enter(root);
+            while (not call_stack.empty())
+            {
+                auto& frame = call_stack.back();
+                if (frame.out_pos < frame.out.size())
+                {
+                    auto node_to = frame.out[frame.out_pos++];
+                    auto state_it = states.find(node_to);
+                    if (state_it == states.end())
+                        enter(node_to);
+                    else if (state_it->second.on_stack)
+                        states[frame.node].lowlink = std::min(states[frame.node].lowlink, state_it->second.index);
+                    continue;
+                }
+
+                auto node        = frame.node;
+                const auto state = states[node];
+                call_stack.pop_back();
+                if (not call_stack.empty())
+                {
+                    auto& parent_state   = states[call_stack.back().node];
+                    parent_state.lowlink = std::min(parent_state.lowlink, state.lowlink);
+                }
+                if (state.lowlink != state.index)
+                    continue;
+                auto& scc = sccs.emplace_back();
+                TNode* scc_node = nullptr;
+                do
+                {
+                    scc_node = stack.back();
+                    stack.pop_back();
+                    states[scc_node].on_stack = false;
+                    scc.push_back(scc_node);
+                } while (scc_node != node);
+            }
+        }
+        return sccs;
+    }
+
+    mutable int m_component_id = ComponentIdNone;
+    mutable bool m_dirty       = false;
+    mutable Components_t m_components;
+    mutable std::unordered_map<TNode*, int> m_node_component;
+};
+
+}  // namespace GG
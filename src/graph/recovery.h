@@ -0,0 +1,386 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./common.h"
+#include "./import.h"
+#include "./properties/journal.h"
+#include "./snapshot.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Find an edge with given nodes, direction and weight, undirected edges match in both orientations
+ *
+ * Edges have no ids, so parallel edges with equal fields are interchangeable for journal replay.
+ */
+/**
+ * \~russian
+ * @brief Найти ребро с заданными вершинами, направленностью и весом, ненаправленные рёбра совпадают в обеих
+ * ориентациях
+ *
+ * У рёбер нет идентификаторов, поэтому параллельные рёбра с равными полями взаимозаменяемы при воспроизведении журнала.
+ */
+template <typename TGraph, typename TNodeId>
+typename TGraph::Edge_t* FindJournaledEdge(const TGraph& graph, const TNodeId& id1, const TNodeId& id2, bool directed,
+                                           float weight)
+{
+    auto node1 = graph.Find(id1);
+    auto node2 = graph.Find(id2);
+    if ((node1 == nullptr) or (node2 == nullptr))
+        return nullptr;
+    for (auto edge : node1->Edges())
+    {
+        if ((edge->Directed() != directed) or (edge->Weight() != weight))
+            continue;
+        const auto& nodes = edge->Nodes();
+        if ((nodes.first == node1) and (nodes.second == node2))
+            return edge;
+        if (not directed and (nodes.first == node2) and (nodes.second == node1))
+            return edge;
+    }
+    return nullptr;
+}
+
+/**
+ * \~english
+ * @brief Read the header of a journal file
+ *
+ * @param path journal file path
+ * @param header header
+ * @return true if the header is read
+ */
+/**
+ * \~russian
+ * @brief Прочитать заголовок файла журнала
+ *
+ * @param path путь к файлу журнала
+ * @param header заголовок
+ * @return true, если заголовок прочитан
+ */
+inline bool ReadJournalHeader(const std::string& path, JournalHeader* header)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+    const bool ok = (fread(header, sizeof(*header), 1, file) == 1);
+    fclose(file);
+    return ok;
+}
+
+/**
+ * \~english
+ * @brief Make renames and creations of files in the directory of a file durable
+ *
+ * @param path path of a file in the directory
+ * @return true if the directory is synced
+ */
+/**
+ * \~russian
+ * @brief Сделать переименования и создания файлов в каталоге файла надёжно сохранёнными
+ *
+ * @param path путь к файлу в каталоге
+ * @return true, если каталог синхронизирован
+ */
+inline bool SyncDirectory(const std::string& path)
+{
+    const auto slash     = path.rfind('/');
+    const auto directory = (slash == std::string::npos) ? std::string(".") : path.substr(0, slash + 1);
+    const int fd         = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return false;
+    const bool ok = (::fsync(fd) == 0);
+    return (::close(fd) == 0) and ok;
+}
+
+/**
+ * \~english
+ * @brief Replay a mutation journal into a graph
+ *
+ * Runs of node and edge additions are applied with one LoadEdges bulk update each. Replay stops at the first incomplete
+ * or unknown record, which is a torn tail of a crashed write.
+ *
+ * @param graph graph, its own journal must be closed
+ * @param path journal file path
+ * @param generation journal generation
+ * @param valid_size size of the journal up to the end of the last complete record
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Воспроизвести журнал изменений в граф
+ *
+ * Серии добавлений вершин и рёбер применяются одним групповым изменением LoadEdges каждая. Воспроизведение
+ * останавливается на первой неполной или неизвестной записи, это оборванный хвост прерванной записи.
+ *
+ * @param graph граф, его собственный журнал должен быть закрыт
+ * @param path путь к файлу журнала
+ * @param generation поколение журнала
+ * @param valid_size размер журнала до конца последней полной записи
+ * @return статус
+ */
+template <typename TGraph>
+ImportStatus ReplayJournal(TGraph& graph, const std::string& path, uint64_t* generation, size_t* valid_size)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    static constexpr size_t EdgeSize = 2 * sizeof(NodeId_t) + sizeof(uint8_t) + sizeof(float);
+    ImportStatus status;
+    const MappedFile file(path);
+    const auto text = file.Data();
+    JournalHeader header;
+    if (not file.Ok() or (text.size() < sizeof(header)))
+    {
+        status.ok    = false;
+        status.error = "Can not read journal " + path;
+        return status;
+    }
+    std::memcpy(&header, text.data(), sizeof(header));
+    if ((header.magic != JournalHeader::Magic) or (header.version != JournalHeader::CurrentVersion) or
+        (header.id_size != sizeof(NodeId_t)))
+    {
+        status.ok    = false;
+        status.error = "Not a journal of a supported version";
+        return status;
+    }
+    *generation = header.generation;
+
+    std::vector<EdgeRecord<NodeId_t>> edges;
+    std::vector<NodeId_t> nodes;
+    auto flush = [&]() {
+        if (edges.empty() and nodes.empty())
+            return;
+        graph.LoadEdges(edges, nodes);
+        edges.clear();
+        nodes.clear();
+    };
+
+    size_t pos = sizeof(header);
+    auto read  = [&](auto& value) {
+        std::memcpy(&value, text.data() + pos, sizeof(value));
+        pos += sizeof(value);
+    };
+    auto read_edge = [&](EdgeRecord<NodeId_t>& edge) {
+        uint8_t directed = 0;
+        read(edge.node1);
+        read(edge.node2);
+        read(directed);
+        read(edge.weight);
+        edge.directed = (directed != 0);
+    };
+    while (pos < text.size())
+    {
+        const auto record  = static_cast<JournalRecord>(text[pos]);
+        const size_t rest  = text.size() - pos - 1;
+        size_t record_size = 0;
+        switch (record)
+        {
+            case JournalRecord::AddNode:
+            case JournalRecord::DelNode:
+                record_size = sizeof(NodeId_t);
+                break;
+            case JournalRecord::AddEdge:
+            case JournalRecord::DelEdge:
+                record_size = EdgeSize;
+                break;
+            case JournalRecord::SetWeight:
+                record_size = EdgeSize + sizeof(float);
+                break;
+            case JournalRecord::Clear:
+                break;
+            default:
+                record_size = rest + 1;
+                break;
+        }
+        if (record_size > rest)
+            break;
+        ++pos;
+
+        NodeId_t id;
+        EdgeRecord<NodeId_t> edge;
+        switch (record)
+        {
+            case JournalRecord::AddNode:
+                read(id);
+                nodes.push_back(id);
+                break;
+            case JournalRecord::AddEdge:
+                read_edge(edge);
+                edges.push_back(edge);
+                break;
+            case JournalRecord::DelNode:
+                flush();
+                read(id);
+                graph.Del(id);
+                break;
+            case JournalRecord::DelEdge:
+                flush();
+                read_edge(edge);
+                if (auto found = FindJournaledEdge(graph, edge.node1, edge.node2, edge.directed, edge.weight))
+                    graph.Del(found);
+                break;
+            case JournalRecord::SetWeight:
+            {
+                flush();
+                read_edge(edge);
+                float weight = 0.0;
+                read(weight);
+                if (auto found = FindJournaledEdge(graph, edge.node1, edge.node2, edge.directed, edge.weight))
+                    found->SetWeight(weight);
+                break;
+            }
+            case JournalRecord::Clear:
+                flush();
+                graph.Clear();
+                break;
+        }
+    }
+    flush();
+    *valid_size = pos;
+    return status;
+}
+
+/**
+ * \~english
+ * @brief Recover a graph from a snapshot and the tail of its journal, then open the journal for new records
+ *
+ * A missing snapshot means an empty graph of generation 0. A journal of an older generation than the snapshot is
+ * already folded into it and is replaced with an empty one, as well as a missing journal. A torn tail of the journal
+ * is cut off.
+ *
+ * @param graph empty graph with a journal property
+ * @param snapshot_path snapshot file path
+ * @param journal_path journal file path
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Восстановить граф из снимка и хвоста его журнала, затем открыть журнал для новых записей
+ *
+ * Отсутствующий снимок означает пустой граф поколения 0. Журнал более старого поколения, чем снимок, уже свёрнут в
+ * него и заменяется пустым, как и отсутствующий журнал. Оборванный хвост журнала отрезается.
+ *
+ * @param graph пустой граф со свойством журнала
+ * @param snapshot_path путь к файлу снимка
+ * @param journal_path путь к файлу журнала
+ * @return статус
+ */
+template <typename TGraph>
+ImportStatus Recover(TGraph& graph, const std::string& snapshot_path, const std::string& journal_path)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    ImportStatus status;
+    auto fail = [&status](const std::string& error) {
+        status.ok    = false;
+        status.error = error;
+        return status;
+    };
+
+    uint64_t generation = 0;
+    if (::access(snapshot_path.c_str(), F_OK) == 0)
+    {
+        status = RestoreSnapshot(snapshot_path, graph, &generation);
+        if (not status.ok)
+            return status;
+    }
+
+    bool create_journal = true;
+    if (::access(journal_path.c_str(), F_OK) == 0)
+    {
+        JournalHeader header;
+        if (not ReadJournalHeader(journal_path, &header))
+            return fail("Can not read journal " + journal_path);
+        uint64_t journal_generation = header.generation;
+        size_t valid_size           = 0;
+        if (journal_generation > generation)
+            return fail("Journal is newer than the snapshot");
+        if (journal_generation == generation)
+        {
+            status = ReplayJournal(graph, journal_path, &journal_generation, &valid_size);
+            if (not status.ok)
+                return status;
+            if (::truncate(journal_path.c_str(), static_cast<off_t>(valid_size)) != 0)
+                return fail("Can not cut journal " + journal_path);
+            create_journal = false;
+        }
+    }
+    if (create_journal and
+        (not CreateJournalFile<NodeId_t>(journal_path, generation) or not SyncDirectory(journal_path)))
+        return fail("Can not create journal " + journal_path);
+    if (not graph.OpenJournal(journal_path))
+        return fail("Can not open journal " + journal_path);
+    return status;
+}
+
+/**
+ * \~english
+ * @brief Fold the journal into a new snapshot and start an empty journal of the next generation
+ *
+ * The snapshot is written next to the old one and renamed over it, so a crash at any moment leaves either the old
+ * snapshot with its journal or the new snapshot, with which an old journal is ignored by Recover. The directory is
+ * synced after every rename, and the journal is replaced only after the new snapshot entry is durable.
+ *
+ * @param graph graph with an opened journal
+ * @param snapshot_path snapshot file path
+ * @param journal_path journal file path
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Свернуть журнал в новый снимок и начать пустой журнал следующего поколения
+ *
+ * Снимок записывается рядом со старым и переименовывается поверх него, поэтому сбой в любой момент оставляет либо
+ * старый снимок с его журналом, либо новый снимок, с которым старый журнал игнорируется Recover. Каталог
+ * синхронизируется после каждого переименования, а журнал заменяется только после надёжного сохранения записи
+ * каталога нового снимка.
+ *
+ * @param graph граф с открытым журналом
+ * @param snapshot_path путь к файлу снимка
+ * @param journal_path путь к файлу журнала
+ * @return статус
+ */
+template <typename TGraph>
+ImportStatus Compact(TGraph& graph, const std::string& snapshot_path, const std::string& journal_path)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    ImportStatus status;
+    auto fail = [&status](const std::string& error) {
+        status.ok    = false;
+        status.error = error;
+        return status;
+    };
+    GRAPH_DEBUG_ASSERT(graph.JournalOpened(), "Journal is not opened");
+    if (not graph.CommitJournal())
+        return fail("Can not commit journal " + journal_path);
+
+    const uint64_t generation = graph.JournalGeneration() + 1;
+    const auto snapshot_tmp   = snapshot_path + ".tmp";
+    status                    = WriteSnapshot(graph, snapshot_tmp, generation);
+    if (not status.ok)
+        return status;
+    if ((std::rename(snapshot_tmp.c_str(), snapshot_path.c_str()) != 0) or not SyncDirectory(snapshot_path))
+        return fail("Can not replace snapshot " + snapshot_path);
+
+    // the old journal is dropped only after the new snapshot is durably in place
+    graph.CloseJournal();
+    const auto journal_tmp = journal_path + ".tmp";
+    if (not CreateJournalFile<NodeId_t>(journal_tmp, generation) or
+        (std::rename(journal_tmp.c_str(), journal_path.c_str()) != 0) or not SyncDirectory(journal_path))
+        return fail("Can not replace journal " + journal_path);
+    if (not graph.OpenJournal(journal_path))
+        return fail("Can not open journal " + journal_path);
+    return status;
+}
+
+}  // namespace GG
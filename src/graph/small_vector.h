@@ -0,0 +1,180 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Vector keeping its first elements inside the object and moving to the heap only beyond them
+ *
+ * Meant for short lists of pointers such as edges of grid nodes: a list within the inline capacity needs no allocation
+ * and lies next to its owner. The heap pointer shares memory with the inline elements.
+ *
+ * @tparam T trivially copyable element type
+ * @tparam N inline capacity
+ */
+/**
+ * \~russian
+ * @brief Вектор, хранящий свои первые элементы внутри объекта и переходящий в кучу только сверх них
+ *
+ * Предназначен для коротких списков указателей, например рёбер вершин сетки: список в пределах встроенной ёмкости не
+ * требует выделения памяти и лежит рядом со своим владельцем. Указатель на кучу делит память со встроенными
+ * элементами.
+ *
+ * @tparam T тривиально копируемый тип элемента
+ * @tparam N встроенная ёмкость
+ */
+template <typename T, size_t N>
+class SmallVector
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are moved as raw bytes");
+    static_assert(N > 0, "Inline capacity must not be zero");
+
+  public:
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+    SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept { Take(std::move(other)); }
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Free();
+            Take(std::move(other));
+        }
+        return *this;
+    }
+    ~SmallVector() { Free(); }
+
+    T* data() { return IsInline() ? m_storage.inline_data.data() : m_storage.heap_data; }
+    const T* data() const { return IsInline() ? m_storage.inline_data.data() : m_storage.heap_data; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+
+    T& operator[](size_t pos) { return data()[pos]; }
+    const T& operator[](size_t pos) const { return data()[pos]; }
+    T& back() { return data()[m_size - 1]; }
+    const T& back() const { return data()[m_size - 1]; }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+        T* heap_data = new T[capacity];
+        std::copy(begin(), end(), heap_data);
+        if (not IsInline())
+            delete[] m_storage.heap_data;
+        m_storage.heap_data = heap_data;
+        m_capacity          = static_cast<uint32_t>(capacity);
+    }
+
+    void push_back(const T& value)
+    {
+        if (m_size == m_capacity)
+        {
+            // the value may live in this vector
+            const T copy = value;
+            reserve(2 * m_capacity);
+            data()[m_size++] = copy;
+            return;
+        }
+        data()[m_size++] = value;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        const auto offset = static_cast<size_t>(pos - begin());
+        const T copy      = value;
+        push_back(copy);
+        std::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        const auto offset = static_cast<size_t>(pos - begin());
+        std::copy(begin() + offset + 1, end(), begin() + offset);
+        --m_size;
+        return begin() + offset;
+    }
+
+    void resize(size_t size)
+    {
+        reserve(size);
+        std::fill(begin() + std::min<size_t>(m_size, size), begin() + size, T{});
+        m_size = static_cast<uint32_t>(size);
+    }
+
+    void clear() { m_size = 0; }
+
+    template <typename TIterator>
+    void assign(TIterator first, TIterator last)
+    {
+        clear();
+        reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first)
+            data()[m_size++] = *first;
+    }
+
+  private:
+    bool IsInline() const { return m_capacity == N; }
+
+    void Free()
+    {
+        if (not IsInline())
+            delete[] m_storage.heap_data;
+        m_size     = 0;
+        m_capacity = N;
+    }
+
+    void Take(SmallVector&& other)
+    {
+        if (other.IsInline())
+        {
+            std::copy(other.begin(), other.end(), m_storage.inline_data.data());
+        }
+        else
+        {
+            m_storage.heap_data = other.m_storage.heap_data;
+            m_capacity          = other.m_capacity;
+        }
+        m_size           = other.m_size;
+        other.m_size     = 0;
+        other.m_capacity = N;
+    }
+
+    uint32_t m_size     = 0;
+    uint32_t m_capacity = N;
+    union Storage {
+        std::array<T, N> inline_data;
+        T* heap_data;
+    } m_storage;
+};
+
+}  // namespace GG
@@ -0,0 +1,376 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "./common.h"
+#include "./csr.h"
+#include "./export.h"
+#include "./hash.h"
+#include "./import.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Header of a binary graph snapshot
+ *
+ * The header is followed by sections in the order of Section, every section starts at a multiple of
+ * SnapshotAlignment. Numbers are stored in the byte order of the writing machine, byte_order detects a mismatch.
+ * Generation tells which mutation journal continues the snapshot. hash_check detects an index laid out by another
+ * node id hash, see SnapshotHashCheck.
+ */
+/**
+ * \~russian
+ * @brief Заголовок двоичного снимка графа
+ *
+ * За заголовком следуют секции в порядке Section, каждая секция начинается с позиции, кратной SnapshotAlignment.
+ * Числа хранятся в порядке байтов записавшей машины, byte_order позволяет обнаружить несовпадение. Поколение
+ * указывает, какой журнал изменений продолжает снимок. hash_check позволяет обнаружить индекс, построенный другой
+ * хеш-функцией идентификаторов вершин, см. SnapshotHashCheck.
+ */
+struct SnapshotHeader {
+    enum Section : uint32_t
+    {
+        SectionIds = 0,
+        SectionOffsets,
+        SectionNeighbours,
+        SectionWeights,
+        SectionComponents,
+        SectionDirections,
+        SectionIndex,
+        SectionsCount
+    };
+
+    static constexpr std::array<char, 8> Magic = {'G', 'G', 'S', 'N', 'A', 'P', '\0', '\0'};
+    static constexpr uint32_t CurrentVersion   = 3;
+    static constexpr uint32_t ByteOrderMark    = 0x01020304;
+
+    std::array<char, 8> magic = Magic;
+    uint32_t version          = CurrentVersion;
+    uint32_t byte_order       = ByteOrderMark;
+    uint32_t id_size          = 0;
+    uint32_t weighted         = 0;
+    uint64_t nodes_count      = 0;
+    uint64_t adjacency_count  = 0;
+    uint64_t file_size        = 0;
+    uint64_t generation       = 0;
+    uint64_t hash_check       = 0;
+    // offset and size in bytes of every section
+    std::array<uint64_t, SectionsCount> section_offsets{};
+    std::array<uint64_t, SectionsCount> section_sizes{};
+};
+
+static constexpr size_t SnapshotAlignment = 64;
+
+/**
+ * \~english
+ * @brief Fingerprint of the node id hash the index of a snapshot is laid out by
+ *
+ * NodeIdHash is built on std::hash, whose values are implementation defined, so a snapshot written by another build
+ * may need another index. Hashes of up to 32 ids spread over the graph are mixed together.
+ *
+ * @param ids node ids in the order of handles
+ * @return fingerprint
+ */
+/**
+ * \~russian
+ * @brief Отпечаток хеш-функции идентификаторов вершин, по которой построен индекс снимка
+ *
+ * NodeIdHash построен на std::hash, значения которого зависят от реализации, поэтому снимку, записанному другой
+ * сборкой, может требоваться другой индекс. Смешиваются хеши не более чем 32 идентификаторов, разбросанных по графу.
+ *
+ * @param ids идентификаторы вершин в порядке дескрипторов
+ * @return отпечаток
+ */
+template <typename TNodeId>
+uint64_t SnapshotHashCheck(std::span<const TNodeId> ids)
+{
+    uint64_t check    = MixHash(ids.size());
+    const size_t step = std::max<size_t>(ids.size() / 16, 1);
+    for (size_t i = 0; i < ids.size(); i += step)
+        check = MixHash(check ^ NodeIdHash<TNodeId>{}(ids[i]));
+    return check;
+}
+
+/**
+ * \~english
+ * @brief Write a frozen graph into a snapshot file sequentially
+ *
+ * @param csr frozen graph, node ids must be trivially copyable
+ * @param path file path
+ * @param generation snapshot generation
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Последовательно записать замороженный граф в файл снимка
+ *
+ * @param csr замороженный граф, идентификаторы вершин должны быть тривиально копируемыми
+ * @param path путь к файлу
+ * @param generation поколение снимка
+ * @return статус
+ */
+template <typename TNodeId, bool IsWeighted>
+ImportStatus WriteSnapshot(const CsrGraph<TNodeId, IsWeighted>& csr, const std::string& path, uint64_t generation = 0)
+{
+    static_assert(std::is_trivially_copyable_v<TNodeId>, "Snapshot stores node ids as raw bytes");
+    auto bytes = [](auto span) {
+        return std::string_view(reinterpret_cast<const char*>(span.data()), span.size_bytes());
+    };
+    const auto& data = csr.Data();
+    const std::array<std::string_view, SnapshotHeader::SectionsCount> sections = {
+        bytes(data.ids),        bytes(data.offsets),    bytes(data.neighbours), bytes(data.weights),
+        bytes(data.components), bytes(data.directions), bytes(data.index)};
+
+    SnapshotHeader header;
+    header.id_size         = sizeof(TNodeId);
+    header.weighted        = IsWeighted ? 1 : 0;
+    header.nodes_count     = csr.NodesCount();
+    header.adjacency_count = csr.AdjacencyCount();
+    header.generation      = generation;
+    header.hash_check      = SnapshotHashCheck(data.ids);
+    auto align = [](uint64_t pos) { return (pos + SnapshotAlignment - 1) / SnapshotAlignment * SnapshotAlignment; };
+    uint64_t pos           = align(sizeof(SnapshotHeader));
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        header.section_offsets[i] = pos;
+        header.section_sizes[i]   = sections[i].size();
+        pos                       = align(pos + sections[i].size());
+    }
+    header.file_size = pos;
+
+    ImportStatus status;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        status.ok    = false;
+        status.error = "Can not open file " + path;
+        return status;
+    }
+    bool written = false;
+    {
+        BufferedSink sink{FileWriter(file)};
+        static constexpr std::array<char, SnapshotAlignment> Padding{};
+        auto write = [&sink, written = uint64_t(0)](std::string_view section, uint64_t offset) mutable {
+            sink << std::string_view(Padding.data(), offset - written) << section;
+            written = offset + section.size();
+        };
+        write(bytes(std::span(&header, 1)), 0);
+        for (size_t i = 0; i < sections.size(); ++i)
+            write(sections[i], header.section_offsets[i]);
+        write({}, header.file_size);
+        written = sink.Flush();
+    }
+    const bool synced = written and (fflush(file) == 0) and (::fsync(fileno(file)) == 0);
+    if (not synced or (ferror(file) != 0) or (fclose(file) != 0))
+    {
+        status.ok    = false;
+        status.error = "Can not write file " + path;
+    }
+    return status;
+}
+
+/**
+ * \~english
+ * @brief Freeze a graph and write it into a snapshot file
+ *
+ * @param graph graph
+ * @param path file path
+ * @param generation snapshot generation
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Заморозить граф и записать его в файл снимка
+ *
+ * @param graph граф
+ * @param path путь к файлу
+ * @param generation поколение снимка
+ * @return статус
+ */
+template <typename TGraph>
+ImportStatus WriteSnapshot(const TGraph& graph, const std::string& path, uint64_t generation = 0)
+{
+    return WriteSnapshot(CsrGraph<typename TGraph::Node_t::NodeId_t, TGraph::IsWeighted>(graph), path, generation);
+}
+
+/**
+ * \~english
+ * @brief Map a snapshot file into memory and point a frozen graph at it
+ *
+ * Nothing is parsed or copied: the header, section bounds, node id hash and the first and last offsets are checked
+ * and the graph uses the mapped pages, which are read from disk on first access. Other section contents are trusted.
+ * The file must not change while the graph or its copies exist.
+ *
+ * @param path file path
+ * @param csr frozen graph
+ * @param generation snapshot generation, may be null
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Отобразить файл снимка в память и направить на него замороженный граф
+ *
+ * Ничего не разбирается и не копируется: проверяются заголовок, границы секций, хеш-функция идентификаторов вершин,
+ * первое и последнее смещения, а граф использует отображённые страницы, которые читаются с диска при первом
+ * обращении. Остальному содержимому секций доверяется. Файл не должен меняться, пока существует граф или его копии.
+ *
+ * @param path путь к файлу
+ * @param csr замороженный граф
+ * @param generation поколение снимка, может быть нулевым
+ * @return статус
+ */
+template <typename TNodeId, bool IsWeighted>
+ImportStatus MapSnapshot(const std::string& path, CsrGraph<TNodeId, IsWeighted>* csr, uint64_t* generation = nullptr)
+{
+    static_assert(std::is_trivially_copyable_v<TNodeId>, "Snapshot stores node ids as raw bytes");
+    using Csr_t = CsrGraph<TNodeId, IsWeighted>;
+    ImportStatus status;
+    auto fail = [&status](const std::string& error) {
+        status.ok    = false;
+        status.error = error;
+        return status;
+    };
+
+    auto file = std::make_shared<const MappedFile>(path);
+    if (not file->Ok())
+        return fail("Can not map file " + path);
+    const auto text = file->Data();
+    SnapshotHeader header;
+    if (text.size() < sizeof(header))
+        return fail("Too short snapshot");
+    std::memcpy(&header, text.data(), sizeof(header));
+    if ((header.magic != SnapshotHeader::Magic) or (header.version != SnapshotHeader::CurrentVersion))
+        return fail("Not a snapshot of a supported version");
+    if (header.byte_order != SnapshotHeader::ByteOrderMark)
+        return fail("Snapshot byte order differs");
+    if ((header.id_size != sizeof(TNodeId)) or (header.weighted != (IsWeighted ? 1U : 0U)))
+        return fail("Snapshot node id or weight type differs");
+    if (header.file_size != text.size())
+        return fail("Truncated snapshot");
+    // counts are bounded before they are multiplied by element sizes, handles must differ from NodeNone
+    if ((header.nodes_count >= Csr_t::NodeNone) or (header.adjacency_count > text.size()))
+        return fail("Wrong snapshot counts");
+
+    // sections follow the header in order without overlapping and lie within the file
+    bool sections_ok     = true;
+    uint64_t section_end = sizeof(header);
+    auto section         = [&](auto& target, SnapshotHeader::Section index, uint64_t count, bool optional) {
+        using T               = typename std::remove_reference_t<decltype(target)>::element_type;
+        const uint64_t offset = header.section_offsets[index];
+        const uint64_t size   = header.section_sizes[index];
+        const bool size_ok    = (size == count * sizeof(T)) or (optional and (size == 0));
+        if (not size_ok or (offset % SnapshotAlignment != 0) or (offset < section_end) or (offset > text.size()) or
+            (size > text.size() - offset))
+        {
+            sections_ok = false;
+            return;
+        }
+        section_end = offset + size;
+        target      = std::span<const T>(reinterpret_cast<const T*>(text.data() + offset), size / sizeof(T));
+    };
+    const auto nodes       = header.nodes_count;
+    const auto adjacency   = header.adjacency_count;
+    const auto index_count = header.section_sizes[SnapshotHeader::SectionIndex] / sizeof(uint32_t);
+    typename Csr_t::Sections sections;
+    section(sections.ids, SnapshotHeader::SectionIds, nodes, false);
+    section(sections.offsets, SnapshotHeader::SectionOffsets, nodes + 1, false);
+    section(sections.neighbours, SnapshotHeader::SectionNeighbours, adjacency, false);
+    section(sections.weights, SnapshotHeader::SectionWeights, adjacency, not IsWeighted);
+    section(sections.components, SnapshotHeader::SectionComponents, nodes, false);
+    section(sections.directions, SnapshotHeader::SectionDirections, adjacency, true);
+    section(sections.index, SnapshotHeader::SectionIndex, index_count, false);
+    if (not sections_ok or not std::has_single_bit(index_count) or (index_count <= nodes) or
+        (sections.offsets.front() != 0) or (sections.offsets.back() != adjacency))
+        return fail("Wrong snapshot sections");
+    if (header.hash_check != SnapshotHashCheck(sections.ids))
+        return fail("Snapshot node id hash differs");
+
+    *csr = Csr_t(sections, std::move(file));
+    if (generation != nullptr)
+        *generation = header.generation;
+    return status;
+}
+
+/**
+ * \~english
+ * @brief Restore a graph from a snapshot file
+ *
+ * Unlike MapSnapshot this builds node and edge objects, they are added with one bulk update.
+ *
+ * @param path file path
+ * @param graph graph
+ * @param generation snapshot generation, may be null
+ * @return status
+ */
+/**
+ * \~russian
+ * @brief Восстановить граф из файла снимка
+ *
+ * В отличие от MapSnapshot создаёт объекты вершин и рёбер, они добавляются одним групповым изменением.
+ *
+ * @param path путь к файлу
+ * @param graph граф
+ * @param generation поколение снимка, может быть нулевым
+ * @return статус
+ */
+template <typename TGraph>
+ImportStatus RestoreSnapshot(const std::string& path, TGraph& graph, uint64_t* generation = nullptr)
+{
+    using NodeId_t = typename TGraph::Node_t::NodeId_t;
+    CsrGraph<NodeId_t, TGraph::IsWeighted> csr;
+    const auto status = MapSnapshot(path, &csr, generation);
+    if (not status.ok)
+        return status;
+
+    const auto& data = csr.Data();
+    std::vector<EdgeRecord<NodeId_t>> edges;
+    edges.reserve(csr.AdjacencyCount() / (data.directions.empty() ? 2 : 1));
+    for (uint32_t node = 0; node < csr.NodesCount(); ++node)
+    {
+        // undirected edges are stored at both nodes, loops twice at the same node
+        bool loop_seen = false;
+        for (auto pos = data.offsets[node]; pos < data.offsets[node + 1]; ++pos)
+        {
+            const auto node_to  = data.neighbours[pos];
+            const bool directed = not data.directions.empty() and (data.directions[pos] != 0);
+            if (not directed)
+            {
+                if (node_to < node)
+                    continue;
+                if (node_to == node)
+                {
+                    loop_seen = not loop_seen;
+                    if (not loop_seen)
+                        continue;
+                }
+            }
+            EdgeRecord<NodeId_t> edge;
+            edge.node1    = data.ids[node];
+            edge.node2    = data.ids[node_to];
+            edge.directed = directed;
+            if constexpr (TGraph::IsWeighted)
+                edge.weight = data.weights[pos];
+            edges.push_back(edge);
+        }
+    }
+    graph.LoadEdges(edges, data.ids);
+    return status;
+}
+
+}  // namespace GG
@@ -0,0 +1,189 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "./common.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Pool of threads running parallel loops with work stealing
+ *
+ * Items of a loop are split into one contiguous range per thread. A thread takes items from the front of its own
+ * range, and when it is empty steals the back half of the range of another thread, so uneven items are balanced
+ * without a shared queue.
+ */
+/**
+ * \~russian
+ * @brief Пул потоков, выполняющих параллельные циклы с перехватом работы
+ *
+ * Элементы цикла делятся на один непрерывный диапазон на поток. Поток берёт элементы с начала своего диапазона, а когда
+ * он пуст, перехватывает заднюю половину диапазона другого потока, так что неравные элементы балансируются
+ * без общей очереди.
+ */
+class WorkStealingPool
+{
+  public:
+    /**
+     * \~english
+     * @brief Constructor
+     *
+     * @param threads count of threads
+     */
+    /**
+     * \~russian
+     * @brief Конструктор
+     *
+     * @param threads количество потоков
+     */
+    explicit WorkStealingPool(size_t threads = std::max(std::thread::hardware_concurrency(), 1U))
+        : m_ranges(std::max<size_t>(threads, 1))
+    {
+        for (size_t thread = 0; thread < m_ranges.size(); ++thread)
+            m_threads.emplace_back([this, thread]() { Work(thread); });
+    }
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    ~WorkStealingPool()
+    {
+        {
+            const std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    size_t ThreadsCount() const { return m_threads.size(); }
+
+    /**
+     * \~english
+     * @brief Call a function for every item and wait until all calls are done, loops run one at a time
+     *
+     * @param count count of items
+     * @param func function of the item index and the index of the thread calling it
+     */
+    /**
+     * \~russian
+     * @brief Вызвать функцию для каждого элемента и дождаться завершения всех вызовов, циклы выполняются по одному
+     *
+     * @param count количество элементов
+     * @param func функция индекса элемента и индекса вызывающего её потока
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func)
+    {
+        if (count == 0)
+            return;
+        const std::lock_guard run_lock(m_run_mutex);
+        const size_t threads = m_ranges.size();
+        for (size_t thread = 0; thread < threads; ++thread)
+        {
+            const std::lock_guard lock(m_ranges[thread].mutex);
+            m_ranges[thread].begin = count * thread / threads;
+            m_ranges[thread].end   = count * (thread + 1) / threads;
+        }
+        std::unique_lock lock(m_mutex);
+        m_func      = &func;
+        m_remaining = count;
+        ++m_loop;
+        m_wake.notify_all();
+        m_done.wait(lock, [this]() { return (m_remaining == 0) and (m_busy == 0); });
+        m_func = nullptr;
+    }
+
+  private:
+    struct alignas(64) Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end   = 0;
+    };
+
+    void Work(size_t thread)
+    {
+        uint64_t loop = 0;
+        while (true)
+        {
+            const std::function<void(size_t, size_t)>* func = nullptr;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [this, loop]() { return m_stop or (m_loop != loop); });
+                if (m_stop)
+                    return;
+                loop = m_loop;
+                func = m_func;
+                ++m_busy;
+            }
+            // a thread woken after the end of a loop finds no function and no items
+            size_t done = 0;
+            size_t item = 0;
+            while ((func != nullptr) and Take(thread, &item))
+            {
+                (*func)(item, thread);
+                ++done;
+            }
+            const std::lock_guard lock(m_mutex);
+            m_remaining -= done;
+            --m_busy;
+            if ((m_remaining == 0) and (m_busy == 0))
+                m_done.notify_all();
+        }
+    }
+
+    bool Take(size_t thread, size_t* item)
+    {
+        auto& own = m_ranges[thread];
+        {
+            const std::lock_guard lock(own.mutex);
+            if (own.begin < own.end)
+            {
+                *item = own.begin++;
+                return true;
+            }
+        }
+        for (size_t shift = 1; shift < m_ranges.size(); ++shift)
+        {
+            size_t begin = 0;
+            size_t end   = 0;
+            {
+                auto& victim = m_ranges[(thread + shift) % m_ranges.size()];
+                const std::lock_guard lock(victim.mutex);
+                if (victim.begin >= victim.end)
+                    continue;
+                begin      = victim.begin + (victim.end - victim.begin) / 2;
+                end        = victim.end;
+                victim.end = begin;
+            }
+            const std::lock_guard lock(own.mutex);
+            own.begin = begin + 1;
+            own.end   = end;
+            *item     = begin;
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<Range> m_ranges;
+    std::vector<std::thread> m_threads;
+    std::mutex m_run_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t, size_t)>* m_func = nullptr;
+    uint64_t m_loop    = 0;
+    size_t m_remaining = 0;
+    size_t m_busy      = 0;
+    bool m_stop        = false;
+};
+
+}  // namespace GG
@@ -0,0 +1,360 @@
+// Copyright 2024 oldnick85
+
+#pragma once
+
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include "./common.h"
+#include "./concepts.h"
+
+namespace GG
+{
+
+/**
+ * \~english
+ * @brief Transposed view of an adjacency provider: every edge is followed backwards
+ *
+ * Neighbours of the view are predecessors in the base provider and vice versa, so backward searches run over the
+ * view without building the reversed graph. Nothing is copied, the base provider must outlive the view.
+ *
+ * @tparam TAdjacency base adjacency provider type
+ */
+/**
+ * \~russian
+ * @brief Транспонированное представление поставщика смежности: каждое ребро проходится в обратную сторону
+ *
+ * Соседи представления - это предшественники в базовом поставщике и наоборот, поэтому обратный поиск выполняется по
+ * представлению без построения обращённого графа. Ничего не копируется, базовый поставщик должен пережить
+ * представление.
+ *
+ * @tparam TAdjacency тип базового поставщика смежности
+ */
+template <ReverseAdjacencyProvider TAdjacency>
+class TransposeView
+{
+  public:
+    using NodeHandle_t = typename TAdjacency::NodeHandle_t;
+
+    explicit TransposeView(const TAdjacency* adjacency) : m_adjacency(adjacency)
+    {
+        GRAPH_DEBUG_ASSERT(m_adjacency != nullptr, "Null adjacency");
+    }
+
+    const TAdjacency* Base() const { return m_adjacency; }
+
+    template <typename TFunc>
+        requires NodeEnumerableProvider<TAdjacency>
+    void ForEachNode(TFunc func) const
+    {
+        m_adjacency->ForEachNode(func);
+    }
+
+    template <typename TFunc>
+    void ForEachNeighbour(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachPredecessor(node, func);
+    }
+
+    template <typename TFunc>
+        requires requires(const TAdjacency& adjacency, const NodeHandle_t& node) {
+            adjacency.ForEachPredecessorWeighted(node, [](const NodeHandle_t&, float) {});
+        }
+    void ForEachNeighbourWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachPredecessorWeighted(node, func);
+    }
+
+    template <typename TFunc>
+    void ForEachPredecessor(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachNeighbour(node, func);
+    }
+
+    template <typename TFunc>
+        requires WeightedAdjacencyProvider<TAdjacency>
+    void ForEachPredecessorWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachNeighbourWeighted(node, func);
+    }
+
+    size_t NodeIndex(const NodeHandle_t& node) const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndex(node);
+    }
+    size_t NodeIndexCount() const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndexCount();
+    }
+
+  private:
+    const TAdjacency* m_adjacency = nullptr;
+};
+
+/**
+ * \~english
+ * @brief Induced subgraph view of an adjacency provider: only nodes accepted by a predicate and edges between them
+ *
+ * The predicate is a functor of a node handle called inline on every visited node, nothing is copied. Searches must
+ * start from an accepted node. Dense indices of the base provider are kept, so per-node arrays are sized for the
+ * whole base graph.
+ *
+ * @tparam TAdjacency base adjacency provider type
+ * @tparam TNodePredicate functor of a node handle returning true for nodes of the subgraph
+ */
+/**
+ * \~russian
+ * @brief Представление порождённого подграфа поставщика смежности: только вершины, принятые предикатом, и рёбра
+ * между ними
+ *
+ * Предикат - это функтор дескриптора вершины, встраиваемо вызываемый для каждой посещённой вершины, ничего не
+ * копируется. Поиск должен начинаться с принятой вершины. Плотные индексы базового поставщика сохраняются, поэтому
+ * массивы вершин имеют размер всего базового графа.
+ *
+ * @tparam TAdjacency тип базового поставщика смежности
+ * @tparam TNodePredicate функтор дескриптора вершины, возвращающий true для вершин подграфа
+ */
+template <AdjacencyProvider TAdjacency, typename TNodePredicate>
+    requires std::is_invocable_r_v<bool, const TNodePredicate&, const typename TAdjacency::NodeHandle_t&>
+class SubgraphView
+{
+  public:
+    using NodeHandle_t = typename TAdjacency::NodeHandle_t;
+
+    SubgraphView(const TAdjacency* adjacency, TNodePredicate predicate)
+        : m_adjacency(adjacency), m_predicate(std::move(predicate))
+    {
+        GRAPH_DEBUG_ASSERT(m_adjacency != nullptr, "Null adjacency");
+    }
+
+    const TAdjacency* Base() const { return m_adjacency; }
+
+    bool Contains(const NodeHandle_t& node) const { return m_predicate(node); }
+
+    template <typename TFunc>
+        requires NodeEnumerableProvider<TAdjacency>
+    void ForEachNode(TFunc func) const
+    {
+        m_adjacency->ForEachNode([&](const NodeHandle_t& node) {
+            if (m_predicate(node))
+                func(node);
+        });
+    }
+
+    template <typename TFunc>
+    void ForEachNeighbour(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachNeighbour(node, [&](const NodeHandle_t& node_to) {
+            if (m_predicate(node_to))
+                func(node_to);
+        });
+    }
+
+    template <typename TFunc>
+        requires WeightedAdjacencyProvider<TAdjacency>
+    void ForEachNeighbourWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachNeighbourWeighted(node, [&](const NodeHandle_t& node_to, float weight) {
+            if (m_predicate(node_to))
+                func(node_to, weight);
+        });
+    }
+
+    template <typename TFunc>
+        requires ReverseAdjacencyProvider<TAdjacency>
+    void ForEachPredecessor(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachPredecessor(node, [&](const NodeHandle_t& node_from) {
+            if (m_predicate(node_from))
+                func(node_from);
+        });
+    }
+
+    template <typename TFunc>
+        requires requires(const TAdjacency& adjacency, const NodeHandle_t& node) {
+            adjacency.ForEachPredecessorWeighted(node, [](const NodeHandle_t&, float) {});
+        }
+    void ForEachPredecessorWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachPredecessorWeighted(node, [&](const NodeHandle_t& node_from, float weight) {
+            if (m_predicate(node_from))
+                func(node_from, weight);
+        });
+    }
+
+    size_t NodeIndex(const NodeHandle_t& node) const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndex(node);
+    }
+    size_t NodeIndexCount() const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndexCount();
+    }
+
+  private:
+    const TAdjacency* m_adjacency = nullptr;
+    [[no_unique_address]] TNodePredicate m_predicate;
+};
+
+/**
+ * \~english
+ * @brief Node predicate of a subgraph given by a set of nodes, the set must outlive the predicate
+ */
+/**
+ * \~russian
+ * @brief Предикат вершин подграфа, заданного множеством вершин, множество должно пережить предикат
+ */
+template <NodeHandle TNodeHandle>
+class InNodeSet
+{
+  public:
+    explicit InNodeSet(const std::unordered_set<TNodeHandle>* nodes) : m_nodes(nodes)
+    {
+        GRAPH_DEBUG_ASSERT(m_nodes != nullptr, "Null node set");
+    }
+
+    bool operator()(const TNodeHandle& node) const { return m_nodes->contains(node); }
+
+  private:
+    const std::unordered_set<TNodeHandle>* m_nodes = nullptr;
+};
+
+/**
+ * \~english
+ * @brief Edge-filtered view of an adjacency provider: only edges accepted by a predicate, all nodes are kept
+ *
+ * The predicate is a functor called inline with the first and the second node of every visited edge in its base
+ * direction, and with its weight as the third argument if it accepts one and the base provider is weighted. Nothing
+ * is copied.
+ *
+ * @tparam TAdjacency base adjacency provider type
+ * @tparam TEdgePredicate functor of an edge returning true for edges of the view
+ */
+/**
+ * \~russian
+ * @brief Представление поставщика смежности с отбором рёбер: только рёбра, принятые предикатом, все вершины
+ * сохраняются
+ *
+ * Предикат - это функтор, встраиваемо вызываемый с первой и второй вершинами каждого посещённого ребра в его базовом
+ * направлении и с его весом третьим аргументом, если он его принимает и базовый поставщик взвешенный. Ничего не
+ * копируется.
+ *
+ * @tparam TAdjacency тип базового поставщика смежности
+ * @tparam TEdgePredicate функтор ребра, возвращающий true для рёбер представления
+ */
+template <AdjacencyProvider TAdjacency, typename TEdgePredicate>
+class EdgeFilterView
+{
+  public:
+    using NodeHandle_t = typename TAdjacency::NodeHandle_t;
+
+    EdgeFilterView(const TAdjacency* adjacency, TEdgePredicate predicate)
+        : m_adjacency(adjacency), m_predicate(std::move(predicate))
+    {
+        GRAPH_DEBUG_ASSERT(m_adjacency != nullptr, "Null adjacency");
+    }
+
+    const TAdjacency* Base() const { return m_adjacency; }
+
+    template <typename TFunc>
+        requires NodeEnumerableProvider<TAdjacency>
+    void ForEachNode(TFunc func) const
+    {
+        m_adjacency->ForEachNode(func);
+    }
+
+    template <typename TFunc>
+    void ForEachNeighbour(const NodeHandle_t& node, TFunc func) const
+    {
+        if constexpr (ByWeight)
+        {
+            m_adjacency->ForEachNeighbourWeighted(node, [&](const NodeHandle_t& node_to, float weight) {
+                if (m_predicate(node, node_to, weight))
+                    func(node_to);
+            });
+        }
+        else
+        {
+            m_adjacency->ForEachNeighbour(node, [&](const NodeHandle_t& node_to) {
+                if (m_predicate(node, node_to))
+                    func(node_to);
+            });
+        }
+    }
+
+    template <typename TFunc>
+        requires WeightedAdjacencyProvider<TAdjacency>
+    void ForEachNeighbourWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachNeighbourWeighted(node, [&](const NodeHandle_t& node_to, float weight) {
+            if (Accepts(node, node_to, weight))
+                func(node_to, weight);
+        });
+    }
+
+    template <typename TFunc>
+        requires ReverseAdjacencyProvider<TAdjacency>
+    void ForEachPredecessor(const NodeHandle_t& node, TFunc func) const
+    {
+        if constexpr (ByWeight)
+        {
+            m_adjacency->ForEachPredecessorWeighted(node, [&](const NodeHandle_t& node_from, float weight) {
+                if (m_predicate(node_from, node, weight))
+                    func(node_from);
+            });
+        }
+        else
+        {
+            m_adjacency->ForEachPredecessor(node, [&](const NodeHandle_t& node_from) {
+                if (m_predicate(node_from, node))
+                    func(node_from);
+            });
+        }
+    }
+
+    template <typename TFunc>
+        requires requires(const TAdjacency& adjacency, const NodeHandle_t& node) {
+            adjacency.ForEachPredecessorWeighted(node, [](const NodeHandle_t&, float) {});
+        }
+    void ForEachPredecessorWeighted(const NodeHandle_t& node, TFunc func) const
+    {
+        m_adjacency->ForEachPredecessorWeighted(node, [&](const NodeHandle_t& node_from, float weight) {
+            if (Accepts(node_from, node, weight))
+                func(node_from, weight);
+        });
+    }
+
+    size_t NodeIndex(const NodeHandle_t& node) const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndex(node);
+    }
+    size_t NodeIndexCount() const
+        requires DenseIndexedProvider<TAdjacency>
+    {
+        return m_adjacency->NodeIndexCount();
+    }
+
+  private:
+    static constexpr bool ByWeight =
+        WeightedAdjacencyProvider<TAdjacency> and
+        std::is_invocable_r_v<bool, const TEdgePredicate&, const NodeHandle_t&, const NodeHandle_t&, float>;
+
+    bool Accepts(const NodeHandle_t& node_from, const NodeHandle_t& node_to, float weight) const
+    {
+        if constexpr (ByWeight)
+            return m_predicate(node_from, node_to, weight);
+        else
+            return m_predicate(node_from, node_to);
+    }
+
+    const TAdjacency* m_adjacency = nullptr;
+    [[no_unique_address]] TEdgePredicate m_predicate;
+};
+
+}  // namespace GG
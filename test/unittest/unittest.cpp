@@ -1,13 +1,39 @@
 // Copyright 2024 oldnick85
 
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <array>
+#include <atomic>
+#include <csignal>
+#include <numeric>
+#include <random>
+#include <shared_mutex>
+#include <sstream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
 #include "./area.h"
+#include "./area_chunked.h"
+#include "./area_implicit.h"
+#include "./batch.h"
+#include "./biconnected.h"
+#include "./builder.h"
+#include "./components.h"
+#include "./concurrent.h"
+#include "./csr.h"
+#include "./export.h"
 #include "./graph_inclusive.h"
+#include "./hash.h"
+#include "./import.h"
 #include "./path_find.h"
 #include "./primitives.h"
+#include "./recovery.h"
+#include "./snapshot.h"
+#include "./views.h"
 
 // NOLINTBEGIN
 TEST(GraphInclusive, Base)
@@ -27,6 +53,100 @@ TEST(GraphInclusive, Base)
     ASSERT_TRUE(graph.CheckCorrect());
 }
 
+TEST(GraphInclusive, FlatNodeMap)
+{
+    using Node_t = GG::Node<GG::Coord2D>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>,
+                       GG::FlatHashMap<GG::Coord2D, Node_t*>>
+        graph;
+    const int side = 30;
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            graph.MakeNode(GG::Coord2D(x, y));
+            if (x > 0)
+                graph.MakeEdge(GG::Coord2D(x - 1, y), GG::Coord2D(x, y));
+            if (y > 0)
+                graph.MakeEdge(GG::Coord2D(x, y - 1), GG::Coord2D(x, y));
+        }
+    }
+    ASSERT_EQ(graph.Nodes().size(), side * side);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 1);
+    for (int y = 0; y < side; ++y)
+        graph.Del(GG::Coord2D(side / 2, y));
+    ASSERT_EQ(graph.Nodes().size(), side * (side - 1));
+    ASSERT_EQ(graph.Find(GG::Coord2D(side / 2, 3)), nullptr);
+    ASSERT_EQ(graph.Find(GG::Coord2D(3, side / 2))->Id(), GG::Coord2D(3, side / 2));
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 2);
+    ASSERT_TRUE(graph.CheckCorrect());
+    GG::PathFindContext path_find_context{&graph, graph.Find(GG::Coord2D(0, 0))};
+    ASSERT_EQ(path_find_context.FindPathTo(graph.Find(GG::Coord2D(side - 1, 0))).Length(), 0.0);
+    ASSERT_EQ(path_find_context.FindPathTo(graph.Find(GG::Coord2D(0, side - 1))).Length(), side);
+    const auto stats = graph.NodesHashStats();
+    ASSERT_EQ(stats.size, side * (side - 1));
+    ASSERT_LE(stats.load_factor, 0.875);
+    ASSERT_LT(stats.average_probe, 3.0);
+}
+
+TEST(Hash, FlatHashMap)
+{
+    GG::FlatHashMap<int, int> map;
+    std::unordered_map<int, int> map_ref;
+    srand(1);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const int key = rand() % 2000;
+        if (rand() % 3 == 0)
+        {
+            ASSERT_EQ(map.erase(key), map_ref.erase(key));
+        }
+        else
+        {
+            ASSERT_EQ(map.emplace(key, i).second, map_ref.emplace(key, i).second);
+        }
+        ASSERT_EQ(map.size(), map_ref.size());
+    }
+    for (int key = 0; key < 2000; ++key)
+    {
+        const auto it = map.find(key);
+        ASSERT_EQ(it != map.end(), map_ref.contains(key));
+        if (it != map.end())
+        {
+            ASSERT_EQ(it->second, map_ref.at(key));
+        }
+    }
+    size_t count = 0;
+    for (const auto& el : map)
+    {
+        ASSERT_EQ(el.second, map_ref.at(el.first));
+        ++count;
+    }
+    ASSERT_EQ(count, map_ref.size());
+    const auto stats = map.Stats();
+    ASSERT_EQ(stats.size, map_ref.size());
+    ASSERT_GE(stats.average_probe, 1.0);
+    ASSERT_GE(stats.worst_bucket, 1);
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.find(1), map.end());
+}
+
+TEST(Hash, Coord2D)
+{
+    std::hash<GG::Coord2D> hash;
+    ASSERT_NE(hash({1, 2}), hash({2, 1}));
+    ASSERT_NE(hash({3, 3}), hash({5, 5}));
+    ASSERT_NE(hash({-1, 0}), hash({0, -1}));
+    std::unordered_map<GG::Coord2D, int, GG::NodeIdHash<GG::Coord2D>> map;
+    for (int y = 0; y < 64; ++y)
+        for (int x = 0; x < 64; ++x)
+            map.emplace(GG::Coord2D(x, y), 0);
+    ASSERT_LT(GG::CollectHashStats(map).worst_bucket, 10);
+}
+
 TEST(GraphInclusive, ConnectionComponent)
 {
     using Node_t = GG::Node<int>;
@@ -209,6 +329,479 @@ TEST(GraphInclusive, ConnectionComponent)
     ASSERT_EQ(graph.ConnectedComponentsCount(), 0);
 }
 
+TEST(GraphInclusive, ConnectionComponentId)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>
+        graph;
+    constexpr int Count = 100;
+    for (int i = 0; i < Count; ++i)
+        graph.MakeNode(i);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), Count);
+    /*
+     *  0 - 2 - 4 - ... - 98
+     *  1 - 3 - 5 - ... - 99
+     */
+    for (int i = 2; i < Count; ++i)
+        graph.MakeEdge(i - 2, i);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 2);
+    ASSERT_EQ(graph.ComponentId(graph.Find(0)), graph.ComponentId(graph.Find(98)));
+    ASSERT_EQ(graph.ComponentId(graph.Find(1)), graph.ComponentId(graph.Find(99)));
+    ASSERT_NE(graph.ComponentId(graph.Find(0)), graph.ComponentId(graph.Find(1)));
+    /*
+     *  0 - 2 - ... - 48   50 - ... - 98
+     *  1 - 3 - 5 - ... - 99
+     */
+    const auto component_id = graph.ComponentId(graph.Find(0));
+    graph.DelEdgesBetween(48, 50);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 3);
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(0), graph.Find(48)));
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(50), graph.Find(98)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(48), graph.Find(50)));
+    ASSERT_TRUE((graph.ComponentId(graph.Find(0)) == component_id) or
+                (graph.ComponentId(graph.Find(98)) == component_id));
+    /*
+     *  0 - 2 - ... - 48   50 - ... - 98
+     *  |
+     *  1 - 3 - 5 - ... - 99
+     */
+    graph.MakeEdge(0, 1);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 2);
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(48), graph.Find(99)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(50), graph.Find(99)));
+}
+
+TEST(GraphInclusive, ConnectionComponentDynamic)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatchDynamic<Node_t, Edge_t>, GG::Named<false>>
+        graph;
+    for (int i = 1; i <= 4; ++i)
+        graph.MakeNode(i);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 4);
+    /*
+     *  1 - 2
+     *  |   |
+     *  3 - 4
+     */
+    auto* edge12 = graph.MakeEdge(1, 2);
+    auto* edge13 = graph.MakeEdge(1, 3);
+    auto* edge24 = graph.MakeEdge(2, 4);
+    auto* edge34 = graph.MakeEdge(3, 4);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 1);
+    ASSERT_TRUE(graph.IsSpanningEdge(edge12));
+    ASSERT_TRUE(graph.IsSpanningEdge(edge13));
+    ASSERT_TRUE(graph.IsSpanningEdge(edge24));
+    ASSERT_FALSE(graph.IsSpanningEdge(edge34));
+    /*
+     *  1 - 2
+     *      |
+     *  3 - 4
+     */
+    graph.Del(edge13);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 1);
+    ASSERT_TRUE(graph.IsSpanningEdge(edge34));
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(1), graph.Find(3)));
+    ASSERT_EQ(graph.SpanningEdgesCount(), 3);
+    // the replacement does not leave superseded edges in the tree, so deleting a non-tree edge searches nothing
+    edge13 = graph.MakeEdge(1, 3);
+    ASSERT_FALSE(graph.IsSpanningEdge(edge13));
+    ASSERT_EQ(graph.SpanningEdgesCount(), 3);
+    graph.Del(edge13);
+    ASSERT_TRUE(graph.IsSpanningEdge(edge12));
+    ASSERT_TRUE(graph.IsSpanningEdge(edge24));
+    ASSERT_TRUE(graph.IsSpanningEdge(edge34));
+    ASSERT_EQ(graph.SpanningEdgesCount(), 3);
+    /*
+     *  1 - 2
+     *
+     *  3 - 4
+     */
+    graph.Del(edge24);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 2);
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(1), graph.Find(2)));
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(3), graph.Find(4)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(2), graph.Find(4)));
+    /*
+     *  1
+     *
+     *  3 - 4
+     */
+    graph.Del(2);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 2);
+    graph.Clear();
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 0);
+}
+
+TEST(GraphInclusive, ConnectionComponentDynamicRandom)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>
+        graph;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatchDynamic<Node_t, Edge_t>, GG::Named<false>>
+        graph_dynamic;
+    constexpr int Count = 40;
+    for (int i = 0; i < Count; ++i)
+    {
+        graph.MakeNode(i);
+        graph_dynamic.MakeNode(i);
+    }
+    srand(1);
+    for (int step = 0; step < 2000; ++step)
+    {
+        const int node1 = rand() % Count;
+        const int node2 = rand() % Count;
+        if (node1 == node2)
+            continue;
+        if (rand() % 2 == 0)
+        {
+            graph.MakeEdge(node1, node2);
+            graph_dynamic.MakeEdge(node1, node2);
+        }
+        else
+        {
+            graph.DelEdgesBetween(node1, node2);
+            graph_dynamic.DelEdgesBetween(node1, node2);
+        }
+        ASSERT_EQ(graph.ConnectedComponentsCount(), graph_dynamic.ConnectedComponentsCount());
+        ASSERT_EQ(graph_dynamic.SpanningEdgesCount(), Count - graph_dynamic.ConnectedComponentsCount());
+        for (int i = 0; i < Count; ++i)
+        {
+            ASSERT_EQ(graph.SurelyConnected(graph.Find(node1), graph.Find(i)),
+                      graph_dynamic.SurelyConnected(graph_dynamic.Find(node1), graph_dynamic.Find(i)));
+        }
+    }
+    graph.Clear();
+    graph_dynamic.Clear();
+}
+
+TEST(GraphInclusive, StronglyConnectedComponent)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                       GG::StronglyConnectedComponentWatch<Node_t, Edge_t>, GG::Named<false>>
+        graph;
+    for (int i = 1; i <= 5; ++i)
+        graph.MakeNode(i);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 5);
+    /*
+     *  1 -> 2 -> 3 -> 4 -> 5
+     */
+    graph.MakeEdge(1, 2, true);
+    graph.MakeEdge(2, 3, true);
+    graph.MakeEdge(3, 4, true);
+    graph.MakeEdge(4, 5, true);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 5);
+    ASSERT_FALSE(graph.SurelyNotConnected(graph.Find(1), graph.Find(5)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(5), graph.Find(1)));
+    /*
+     *  1 -> 2 -> 3 -> 4 -> 5
+     *       ^---------/
+     */
+    auto* edge42 = graph.MakeEdge(4, 2, true);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 3);
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(2), graph.Find(4)));
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(3), graph.Find(2)));
+    ASSERT_FALSE(graph.SurelyConnected(graph.Find(1), graph.Find(2)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(3), graph.Find(1)));
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(5), graph.Find(3)));
+    ASSERT_FALSE(graph.SurelyNotConnected(graph.Find(1), graph.Find(5)));
+
+    const auto condensation = graph.Condensation();
+    ASSERT_EQ(condensation.size(), 3);
+    const auto component1 = graph.ComponentId(graph.Find(1));
+    const auto component2 = graph.ComponentId(graph.Find(2));
+    const auto component5 = graph.ComponentId(graph.Find(5));
+    ASSERT_EQ(condensation.at(component1), std::unordered_set<int>{component2});
+    ASSERT_EQ(condensation.at(component2), std::unordered_set<int>{component5});
+    ASSERT_TRUE(condensation.at(component5).empty());
+
+    GG::PathFindContext path_find_context{&graph, graph.Find(5)};
+    ASSERT_EQ(path_find_context.FindPathTo(graph.Find(1)).Length(), 0.0);
+    /*
+     *  1 -> 2 -> 3 -> 4 -> 5
+     */
+    graph.Del(edge42);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 5);
+    ASSERT_TRUE(graph.SurelyNotConnected(graph.Find(4), graph.Find(2)));
+    /*
+     *  1 -> 2 -> 3    4 -> 5
+     *  ^----------/
+     */
+    graph.DelEdgesBetween(3, 4);
+    graph.MakeEdge(3, 1, true);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 3);
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(1), graph.Find(3)));
+    ASSERT_FALSE(graph.SurelyConnected(graph.Find(3), graph.Find(4)));
+    graph.Del(2);
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 4);
+}
+
+TEST(GraphInclusive, StronglyConnectedComponentRandom)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                       GG::StronglyConnectedComponentWatch<Node_t, Edge_t>, GG::Named<false>>
+        graph;
+    constexpr int Count = 30;
+    for (int i = 0; i < Count; ++i)
+        graph.MakeNode(i);
+    auto reachable = [&](int from) {
+        std::vector<bool> visited(Count, false);
+        std::vector<int> front{from};
+        visited[from] = true;
+        while (not front.empty())
+        {
+            auto node = graph.Find(front.back());
+            front.pop_back();
+            for (auto edge : node->Edges())
+            {
+                if (edge->Nodes().first != node)
+                    continue;
+                const auto id = edge->Nodes().second->Id();
+                if (not visited[id])
+                {
+                    visited[id] = true;
+                    front.push_back(id);
+                }
+            }
+        }
+        return visited;
+    };
+    srand(1);
+    for (int step = 0; step < 300; ++step)
+    {
+        const int node1 = rand() % Count;
+        const int node2 = rand() % Count;
+        if (node1 == node2)
+            continue;
+        if (rand() % 3 != 0)
+            graph.MakeEdge(node1, node2, true);
+        else
+            graph.DelEdgesBetween(node1, node2);
+        std::vector<std::vector<bool>> reach;
+        for (int i = 0; i < Count; ++i)
+            reach.push_back(reachable(i));
+        for (int i = 0; i < Count; ++i)
+        {
+            for (int j = 0; j < Count; ++j)
+            {
+                ASSERT_EQ(graph.SurelyConnected(graph.Find(i), graph.Find(j)), reach[i][j] and reach[j][i]);
+                if (graph.SurelyNotConnected(graph.Find(i), graph.Find(j)))
+                {
+                    ASSERT_FALSE(reach[i][j]);
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphInclusive, Biconnected)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                       GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<false>>
+        graph;
+    /*
+     *  1 - 2   5
+     *  | /     |
+     *  3 - 4 - 6 - 7
+     */
+    for (int i = 1; i <= 7; ++i)
+        graph.MakeNode(i);
+    graph.MakeEdge(1, 2);
+    graph.MakeEdge(1, 3);
+    graph.MakeEdge(2, 3);
+    auto* edge34 = graph.MakeEdge(3, 4);
+    graph.MakeEdge(4, 6);
+    graph.MakeEdge(5, 6);
+    graph.MakeEdge(6, 7);
+    GG::BiconnectedIndex index(&graph);
+    ASSERT_EQ(index.Articulations(), (std::unordered_set<Node_t*>{graph.Find(3), graph.Find(4), graph.Find(6)}));
+    ASSERT_EQ(index.Bridges().size(), 4);
+    ASSERT_TRUE(index.WouldDisconnect(edge34));
+    ASSERT_FALSE(index.WouldDisconnect(graph.Find(1)));
+    /*
+     *  1 - 2   5
+     *  | /     |
+     *  3 - 4 - 6 - 7
+     *   \-----/
+     */
+    graph.MakeEdge(3, 6);
+    ASSERT_FALSE(index.IsBridge(edge34));
+    ASSERT_FALSE(index.IsArticulation(graph.Find(4)));
+    ASSERT_TRUE(index.IsArticulation(graph.Find(3)));
+    ASSERT_TRUE(index.IsArticulation(graph.Find(6)));
+    ASSERT_EQ(index.Bridges().size(), 2);
+}
+
+TEST(GraphInclusive, Export)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                       GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<true>>
+        graph("G");
+    for (int i = 0; i < 100; ++i)
+        graph.MakeNode(i);
+    for (int i = 1; i < 100; ++i)
+        graph.MakeEdge(i - 1, i, (i % 2) == 0);
+    graph.MakeEdge(5, 7)->SetWeight(2.5);
+
+    std::ostringstream stream;
+    {
+        GG::BufferedSink sink{GG::StreamWriter(stream)};
+        GG::WriteDOT(graph, sink);
+    }
+    const auto dot = graph.ToDOT();
+    ASSERT_EQ(stream.str(), dot);
+    ASSERT_EQ(dot.substr(0, 13), "digraph \"G\" {");
+    ASSERT_EQ(std::count(dot.begin(), dot.end(), '\n'), 1 + 100 + 100 + 1);
+
+    // buffer smaller than the output and than some strings
+    std::string str;
+    {
+        GG::BufferedSink<GG::StringWriter, 8> sink{GG::StringWriter(&str)};
+        GG::WriteStr(graph, sink);
+        sink << "long string over the buffer" << 'c' << 12345 << 0.5F;
+    }
+    ASSERT_EQ(str, graph.ToStr() + "long string over the bufferc123450.500000");
+    ASSERT_NE(str.find("Node 5 edges 4 ->6 72.500000 "), std::string::npos);
+
+    const auto latex = graph.ToLatexDOT();
+    ASSERT_EQ(latex.find(" -- "), std::string::npos);
+    ASSERT_EQ(std::count(latex.begin(), latex.end(), '>'), 100);
+
+    // a full device and a closed descriptor fail the export instead of truncating it silently
+    std::ostringstream ok_stream;
+    ASSERT_TRUE(GG::WriteStr(graph, ok_stream));
+    const int full_fd = ::open("/dev/full", O_WRONLY);
+    if (full_fd >= 0)
+    {
+        GG::BufferedSink<GG::FdWriter, 64> sink{GG::FdWriter(full_fd)};
+        ASSERT_FALSE(GG::WriteDOT(graph, sink));
+        ASSERT_EQ(sink.Writer().Error(), ENOSPC);
+        ::close(full_fd);
+    }
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe(pipe_fds.data()), 0);
+    ::close(pipe_fds[1]);
+    GG::BufferedSink sink{GG::FdWriter(pipe_fds[1])};
+    sink << "lost";
+    ASSERT_FALSE(sink.Flush());
+    ASSERT_EQ(sink.Writer().Error(), EBADF);
+    ASSERT_FALSE(sink.Flush());
+    ::close(pipe_fds[0]);
+}
+
+TEST(GraphInclusive, Import)
+{
+    using Node_t = GG::Node<int>;
+    using Edge_t = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<true>>;
+    Graph_t graph("G");
+    for (int i = 0; i < 50; ++i)
+        graph.MakeNode(i);
+    for (int i = 1; i < 40; ++i)
+        graph.MakeEdge(i - 1, i, (i % 2) == 0);
+
+    // DOT written by the graph is read back with the same nodes, edges and directions
+    const auto dot      = graph.ToDOT();
+    const auto imported = GG::ParseDOT<int>(dot, 3);
+    ASSERT_TRUE(imported.status.ok);
+    ASSERT_EQ(imported.name, "G");
+    ASSERT_EQ(imported.nodes.size(), 50);
+    ASSERT_EQ(imported.edges.size(), 39);
+    Graph_t graph_dot("G");
+    ASSERT_TRUE(GG::LoadImported(graph_dot, imported).ok);
+    ASSERT_EQ(graph_dot.Nodes().size(), 50);
+    ASSERT_EQ(graph_dot.Edges().size(), 39);
+    for (const auto edge : graph_dot.Edges())
+    {
+        const int id1 = edge->Nodes().first->Id();
+        ASSERT_EQ(edge->Nodes().second->Id(), id1 + 1);
+        ASSERT_EQ(edge->Directed(), (id1 % 2) == 1);
+    }
+    ASSERT_TRUE(graph_dot.SurelyConnected(graph_dot.Find(0), graph_dot.Find(39)));
+    ASSERT_TRUE(graph_dot.SurelyNotConnected(graph_dot.Find(0), graph_dot.Find(45)));
+    ASSERT_TRUE(graph_dot.CheckCorrect());
+
+    std::string edge_list = "# comment\n\n1 2\n2\t3 0.5\r\n% comment\n3 1 2\n";
+    auto list = GG::ParseEdgeList<int>(edge_list, false);
+    ASSERT_TRUE(list.status.ok);
+    ASSERT_EQ(list.edges.size(), 3);
+    ASSERT_EQ(list.edges[1].node1, 2);
+    ASSERT_EQ(list.edges[1].node2, 3);
+    ASSERT_EQ(list.edges[1].weight, 0.5);
+    ASSERT_FALSE(list.edges[1].directed);
+    Graph_t graph_list;
+    GG::LoadImported(graph_list, list);
+    ASSERT_EQ(graph_list.Nodes().size(), 3);
+    ASSERT_EQ(graph_list.Edges().size(), 3);
+    ASSERT_TRUE(graph_list.SurelyConnected(graph_list.Find(1), graph_list.Find(3)));
+    list = GG::ParseEdgeList<int>(edge_list + "4 x\n", false);
+    ASSERT_FALSE(list.status.ok);
+    ASSERT_EQ(list.status.error_line, 7);
+
+    // edges are split between threads at line boundaries and keep the order of lines
+    edge_list.clear();
+    for (int i = 0; i < 200000; ++i)
+        edge_list += std::to_string(i) + " " + std::to_string(i + 1) + "\n";
+    list = GG::ParseEdgeList<int>(edge_list, true, 4);
+    ASSERT_TRUE(list.status.ok);
+    ASSERT_EQ(list.edges.size(), 200000);
+    for (int i = 0; i < 200000; ++i)
+        ASSERT_EQ(list.edges[i].node1, i);
+    list = GG::ParseEdgeList<int>(edge_list + "1 2 3 4\n", true, 4);
+    ASSERT_EQ(list.status.error_line, 200001);
+
+    const std::string matrix = "%%MatrixMarket matrix coordinate real symmetric\n% comment\n3 3 2\n1 2 1.5\n3 2 4\n";
+    const auto market = GG::ParseMatrixMarket<int>(matrix);
+    ASSERT_TRUE(market.status.ok);
+    ASSERT_EQ(market.edges.size(), 2);
+    ASSERT_EQ(market.edges[0].weight, 1.5);
+    ASSERT_FALSE(market.edges[1].directed);
+    ASSERT_FALSE(GG::ParseMatrixMarket<int>("%%MatrixMarket matrix coordinate complex general\n").status.ok);
+    ASSERT_FALSE(GG::ParseMatrixMarket<int>("%%MatrixMarket matrix coordinate pattern general\n2 2 2\n1 2\n")
+                     .status.ok);
+    ASSERT_TRUE(GG::ParseMatrixMarket<std::string>("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n1 2\n")
+                    .edges[0]
+                    .directed);
+    // indices are checked against the size line, the entries count error points to it
+    const auto out_of_bounds = GG::ParseMatrixMarket<int>(
+        "%%MatrixMarket matrix coordinate pattern general\n%\n3 2 2\n3 2\n1 3\n");
+    ASSERT_FALSE(out_of_bounds.status.ok);
+    ASSERT_EQ(out_of_bounds.status.error_line, 5);
+    ASSERT_FALSE(
+        GG::ParseMatrixMarket<int>("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n0 1\n").status.ok);
+    const auto wrong_count =
+        GG::ParseMatrixMarket<int>("%%MatrixMarket matrix coordinate pattern general\n%\n2 2 2\n1 2\n");
+    ASSERT_FALSE(wrong_count.status.ok);
+    ASSERT_EQ(wrong_count.status.error_line, 3);
+
+    // ids without a string constructor are parsed by Str2Id
+    static_assert(GG::ParsableNodeId<GG::Coord2D>);
+    const auto coords = GG::ParseEdgeList<GG::Coord2D>("(0;0) (1;-2)\n(1;-2) (3;4)\n", false);
+    ASSERT_TRUE(coords.status.ok);
+    ASSERT_EQ(coords.edges[0].node2, GG::Coord2D(1, -2));
+    ASSERT_EQ(coords.edges[1].node2, GG::Coord2D(3, 4));
+    ASSERT_EQ(GG::ParseEdgeList<GG::Coord2D>("(0;0) (1;x)\n", false).status.error_line, 1);
+
+    // a directory is opened but can not be mapped, so it is not taken for an empty file
+    ASSERT_FALSE(GG::MappedFile(testing::TempDir()).Ok());
+}
+
 TEST(GraphInclusive, BasePathFind)
 {
     using Node_t = GG::Node<int>;
@@ -276,6 +869,918 @@ TEST(GraphInclusive, BasePathFind)
     ASSERT_EQ(*path_it, node[8]);
 }
 
+TEST(GraphInclusive, WaveSearch)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<false>>;
+    static_assert(GG::ReverseAdjacencyProvider<GG::GraphInclusiveAdjacency<Graph_t>>);
+    static_assert(GG::WeightedAdjacencyProvider<GG::GraphInclusiveAdjacency<Graph_t>>);
+    static_assert(GG::DenseIndexedProvider<GG::CsrGraph<int>>);
+    static_assert(not GG::WeightedAdjacencyProvider<GG::CsrGraph<int>>);
+    static_assert(GG::WeightedAdjacencyProvider<GG::CsrGraph<int, true>>);
+    static_assert(GG::DenseIndexedProvider<GG::AreaImplicit2D<GG::NeighborhoodMoore>>);
+    /*
+     *  0 -> 1 -> 2 -> 3
+     *  |              ^
+     *  \--(5)-> 4 ----/
+     */
+    Graph_t graph;
+    for (int i = 0; i <= 4; ++i)
+        graph.MakeNode(i);
+    graph.MakeEdge(0, 1, true);
+    graph.MakeEdge(1, 2, true);
+    graph.MakeEdge(2, 3, true);
+    graph.MakeEdge(0, 4, true)->SetWeight(5.0);
+    graph.MakeEdge(4, 3, true);
+
+    GG::GraphInclusiveAdjacency adjacency(&graph);
+    GG::WaveSearch weighted_wave(&adjacency, graph.Find(0));
+    auto path = weighted_wave.FindPathTo(graph.Find(3));
+    ASSERT_EQ(path, (std::vector<Node_t*>{graph.Find(0), graph.Find(1), graph.Find(2), graph.Find(3)}));
+    ASSERT_EQ(weighted_wave.DistanceTo(graph.Find(3)), 3.0);
+    weighted_wave.SpreadWave();
+    ASSERT_EQ(weighted_wave.DistanceTo(graph.Find(4)), 5.0);
+    GG::WaveSearch backward_wave(&adjacency, graph.Find(3));
+    ASSERT_TRUE(backward_wave.FindPathTo(graph.Find(0)).empty());
+
+    GG::CsrGraph<int, true> csr(graph);
+    ASSERT_EQ(csr.NodesCount(), 5);
+    ASSERT_EQ(csr.AdjacencyCount(), 5);
+    GG::WaveSearch csr_weighted_wave(&csr, csr.Find(0));
+    csr_weighted_wave.SpreadWave();
+    ASSERT_EQ(csr_weighted_wave.DistanceTo(csr.Find(3)), 3.0);
+    ASSERT_EQ(csr_weighted_wave.DistanceTo(csr.Find(4)), 5.0);
+
+    GG::CsrGraph<int> csr_unweighted(graph);
+    GG::WaveSearch csr_wave(&csr_unweighted, csr_unweighted.Find(0));
+    auto csr_path = csr_wave.FindPathTo(csr_unweighted.Find(3));
+    ASSERT_EQ(csr_path.size(), 3);
+    ASSERT_EQ(csr_unweighted.Id(csr_path[1]), 4);
+
+    GG::AreaImplicit2D<GG::NeighborhoodVonNeumann> area(GG::Range2D(GG::Coord2D(4, 3)));
+    area.SetPassableAll(true);
+    area.SetPassable({1, 0}, false);
+    area.SetPassable({1, 1}, false);
+    area.SetPassable({1, 2}, false);
+    GG::WaveSearch area_wave(&area, GG::Coord2D(0, 0));
+    ASSERT_EQ(area_wave.FindPathTo(GG::Coord2D(2, 0)).size(), 9);
+}
+
+TEST(GraphInclusive, WaveSearchIncremental)
+{
+    GG::AreaImplicit2D<GG::NeighborhoodVonNeumann> area(GG::Range2D(GG::Coord2D(19, 9)));
+    area.SetPassableAll(true);
+    using Wave_t = GG::WaveSearch<decltype(area)>;
+    Wave_t full(&area, GG::Coord2D(0, 0));
+    full.SpreadWave();
+
+    // sliced stepping stops within the budget and resumes where it stopped
+    Wave_t sliced(&area, GG::Coord2D(0, 0));
+    size_t reached = 1;
+    size_t slices  = 0;
+    for (const auto count : sliced.Steps({.nodes = 7}))
+    {
+        ASSERT_GT(count, reached);
+        ASSERT_LE(count, reached + 7 * 4);
+        reached = count;
+        ++slices;
+    }
+    ASSERT_EQ(slices, (200 + 6) / 7);
+    ASSERT_TRUE(sliced.Exhausted());
+    ASSERT_EQ(sliced.ReachedNodes().size(), 200);
+    for (const auto& node : full.ReachedNodes())
+        ASSERT_EQ(sliced.DistanceTo(node), full.DistanceTo(node));
+
+    Wave_t timed(&area, GG::Coord2D(0, 0));
+    auto timed_steps = timed.Steps({.time = std::chrono::hours(1)});
+    ASSERT_TRUE(timed_steps.Resume());
+    ASSERT_EQ(timed_steps.Value(), 200);
+    ASSERT_FALSE(timed_steps.Resume());
+
+    // levels are the diagonals of the grid, expanded lazily
+    Wave_t layered(&area, GG::Coord2D(0, 0));
+    auto layers = layered.Layers();
+    ASSERT_TRUE(layers.Resume());
+    ASSERT_EQ(layers.Value().size(), 1);
+    ASSERT_EQ(layered.ReachedNodes().size(), 1);
+    ASSERT_TRUE(layers.Resume());
+    ASSERT_EQ(layers.Value().size(), 2);
+    ASSERT_EQ(layered.ReachedNodes().size(), 3);
+    layered.Reset(GG::Coord2D(0, 0));
+    size_t level = 0;
+    for (const auto nodes : layered.Layers())
+    {
+        ASSERT_EQ(nodes.size(), std::min<size_t>({level + 1, 10, 29 - level}));
+        for (const auto& node : nodes)
+            ASSERT_EQ(layered.DistanceTo(node), static_cast<float>(level));
+        ++level;
+    }
+    ASSERT_EQ(level, 29);
+}
+
+TEST(GraphInclusive, DirectedNode)
+{
+    using Node_t      = GG::Node<int, true>;
+    using Edge_t      = GG::Edge<Node_t>;
+    using Graph_t     = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                           GG::StronglyConnectedComponentWatch<Node_t, Edge_t>, GG::Named<false>>;
+    using Adjacency_t = GG::GraphInclusiveAdjacency<Graph_t>;
+    using MixedNode_t = GG::Node<int>;
+    using MixedEdge_t = GG::Edge<MixedNode_t>;
+    using MixedGraph_t =
+        GG::GraphInclusive<MixedNode_t, MixedEdge_t, GG::Directed<MixedEdge_t, true>, GG::Weighted<MixedEdge_t, false>,
+                           GG::ConnectedComponentWatch<MixedNode_t, MixedEdge_t, false>, GG::Named<false>>;
+    using MixedAdjacency = GG::GraphInclusiveAdjacency<MixedGraph_t>;
+    static_assert(Adjacency_t::HasEdgeParts);
+    static_assert(not MixedAdjacency::HasEdgeParts);
+    static_assert(sizeof(MixedNode_t) < sizeof(Node_t));
+
+    /*
+     *  0 -> 1 -- 2 <- 3, loop 1 -> 1
+     */
+    Graph_t graph;
+    for (int i = 0; i < 4; ++i)
+        graph.MakeNode(i);
+    auto* edge01 = graph.MakeEdge(0, 1, true);
+    auto* edge12 = graph.MakeEdge(1, 2);
+    auto* edge32 = graph.MakeEdge(3, 2, true);
+    auto* edge11 = graph.MakeEdge(1, 1, true);
+    ASSERT_EQ(graph.Find(1)->Edges().size(), 4);
+    ASSERT_TRUE(std::ranges::equal(graph.Find(1)->OutEdges(), std::vector<Edge_t*>{edge12, edge11, edge11}));
+    ASSERT_TRUE(std::ranges::equal(graph.Find(1)->InEdges(), std::vector<Edge_t*>{edge12, edge11, edge11, edge01}));
+    ASSERT_TRUE(std::ranges::equal(graph.Find(2)->OutEdges(), std::vector<Edge_t*>{edge12}));
+    ASSERT_TRUE(std::ranges::equal(graph.Find(2)->InEdges(), std::vector<Edge_t*>{edge12, edge32}));
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 3);
+    graph.Del(edge11);
+    ASSERT_TRUE(std::ranges::equal(graph.Find(1)->OutEdges(), std::vector<Edge_t*>{edge12}));
+    ASSERT_TRUE(std::ranges::equal(graph.Find(1)->InEdges(), std::vector<Edge_t*>{edge12, edge01}));
+
+    // neighbours are the same as found by checking the direction of every edge
+    Graph_t parted;
+    MixedGraph_t mixed;
+    constexpr int Count = 40;
+    for (int i = 0; i < Count; ++i)
+    {
+        parted.MakeNode(i);
+        mixed.MakeNode(i);
+    }
+    std::mt19937 random(3);
+    for (int step = 0; step < 600; ++step)
+    {
+        const int node1 = static_cast<int>(random() % Count);
+        const int node2 = static_cast<int>(random() % Count);
+        if (random() % 4 == 0)
+        {
+            parted.DelEdgesBetween(node1, node2);
+            mixed.DelEdgesBetween(node1, node2);
+        }
+        else
+        {
+            const bool directed = (random() % 3 != 0);
+            parted.MakeEdge(node1, node2, directed);
+            mixed.MakeEdge(node1, node2, directed);
+        }
+    }
+    const Adjacency_t adjacency(&parted);
+    const MixedAdjacency mixed_adjacency(&mixed);
+    auto sorted_ids = [](auto for_each) {
+        std::vector<int> ids;
+        for_each([&](const auto* node) { ids.push_back(node->Id()); });
+        std::ranges::sort(ids);
+        return ids;
+    };
+    for (int i = 0; i < Count; ++i)
+    {
+        ASSERT_EQ(sorted_ids([&](auto func) { adjacency.ForEachNeighbour(parted.Find(i), func); }),
+                  sorted_ids([&](auto func) { mixed_adjacency.ForEachNeighbour(mixed.Find(i), func); }));
+        ASSERT_EQ(sorted_ids([&](auto func) { adjacency.ForEachPredecessor(parted.Find(i), func); }),
+                  sorted_ids([&](auto func) { mixed_adjacency.ForEachPredecessor(mixed.Find(i), func); }));
+    }
+    GG::WaveSearch wave(&adjacency, parted.Find(0));
+    GG::WaveSearch mixed_wave(&mixed_adjacency, mixed.Find(0));
+    wave.SpreadWave();
+    mixed_wave.SpreadWave();
+    ASSERT_EQ(wave.ReachedNodes().size(), mixed_wave.ReachedNodes().size());
+    for (int i = 0; i < Count; ++i)
+        ASSERT_EQ(wave.DistanceTo(parted.Find(i)), mixed_wave.DistanceTo(mixed.Find(i)));
+}
+
+TEST(GraphInclusive, Views)
+{
+    using Node_t  = GG::Node<int, true>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<false>>;
+    /*
+     *  0 -> 1 -> 2 -> 3
+     *  |              ^
+     *  \--(5)-> 4 ----/
+     */
+    Graph_t graph;
+    for (int i = 0; i <= 4; ++i)
+        graph.MakeNode(i);
+    graph.MakeEdge(0, 1, true);
+    graph.MakeEdge(1, 2, true);
+    graph.MakeEdge(2, 3, true);
+    graph.MakeEdge(0, 4, true)->SetWeight(5.0);
+    graph.MakeEdge(4, 3, true);
+    const GG::GraphInclusiveAdjacency adjacency(&graph);
+
+    // backward search over the transposed graph
+    const GG::TransposeView transposed(&adjacency);
+    static_assert(GG::WeightedAdjacencyProvider<decltype(transposed)>);
+    static_assert(GG::ReverseAdjacencyProvider<decltype(transposed)>);
+    GG::WaveSearch backward(&transposed, graph.Find(3));
+    ASSERT_EQ(backward.FindPathTo(graph.Find(0)),
+              (std::vector<Node_t*>{graph.Find(3), graph.Find(2), graph.Find(1), graph.Find(0)}));
+    backward.SpreadWave();
+    ASSERT_EQ(backward.DistanceTo(graph.Find(4)), 1.0);
+    ASSERT_EQ(backward.DistanceTo(graph.Find(0)), 3.0);
+
+    // dropping node 2 leaves only the heavy way
+    const std::unordered_set<Node_t*> zone{graph.Find(0), graph.Find(1), graph.Find(3), graph.Find(4)};
+    const GG::SubgraphView subgraph(&adjacency, GG::InNodeSet(&zone));
+    GG::WaveSearch sub_wave(&subgraph, graph.Find(0));
+    sub_wave.SpreadWave();
+    ASSERT_EQ(sub_wave.ReachedNodes().size(), 4);
+    ASSERT_FALSE(sub_wave.Reached(graph.Find(2)));
+    ASSERT_EQ(sub_wave.DistanceTo(graph.Find(3)), 6.0);
+    // views compose, the transposed subgraph is searched from the other end
+    const GG::TransposeView sub_transposed(&subgraph);
+    GG::WaveSearch sub_backward(&sub_transposed, graph.Find(3));
+    ASSERT_EQ(sub_backward.FindPathTo(graph.Find(0)).size(), 3);
+
+    // edges filtered by weight
+    const GG::EdgeFilterView light(&adjacency, [](Node_t*, Node_t*, float weight) { return weight < 2.0F; });
+    GG::WaveSearch light_wave(&light, graph.Find(0));
+    light_wave.SpreadWave();
+    ASSERT_FALSE(light_wave.Reached(graph.Find(4)));
+    size_t light_predecessors = 0;
+    light.ForEachPredecessor(graph.Find(4), [&](Node_t*) { ++light_predecessors; });
+    ASSERT_EQ(light_predecessors, 0);
+
+    // frozen graph views keep dense indices
+    const GG::CsrGraph<int> csr(graph);
+    const auto csr_node2 = csr.Find(2);
+    const GG::EdgeFilterView csr_filtered(&csr, [&](uint32_t node_from, uint32_t node_to) {
+        return (node_from != csr_node2) and (node_to != csr_node2);
+    });
+    static_assert(GG::DenseIndexedProvider<decltype(csr_filtered)>);
+    GG::WaveSearch csr_wave(&csr_filtered, csr.Find(0));
+    csr_wave.SpreadWave();
+    ASSERT_EQ(csr_wave.ReachedNodes().size(), 4);
+    const GG::SubgraphView csr_subgraph(&csr, [&](uint32_t node) { return node != csr.Find(4); });
+    size_t csr_nodes = 0;
+    csr_subgraph.ForEachNode([&](uint32_t) { ++csr_nodes; });
+    ASSERT_EQ(csr_nodes, 4);
+    GG::WaveSearch csr_sub_wave(&csr_subgraph, csr.Find(0));
+    ASSERT_EQ(csr_sub_wave.FindPathTo(csr.Find(3)).size(), 4);
+}
+
+TEST(GraphInclusive, EdgeIndex)
+{
+    using Node_t    = GG::Node<int>;
+    using Edge_t    = GG::Edge<Node_t>;
+    using NodeMap_t = std::unordered_map<int, Node_t*, GG::NodeIdHash<int>>;
+    using Journal_t = GG::Journal<Node_t, Edge_t, false>;
+    using Graph_t   = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                         GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>, NodeMap_t,
+                                         Journal_t, GG::EdgeIndex<Node_t, Edge_t, true>>;
+    using Scanned_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                         GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>;
+    using Simple_t  = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                         GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>, NodeMap_t,
+                                         Journal_t, GG::EdgeIndex<Node_t, Edge_t, true, true>>;
+
+    /*
+     *  0 -> 1 -- 2, loop 2 -- 2
+     */
+    Graph_t graph;
+    for (int i = 0; i < 4; ++i)
+        graph.MakeNode(i);
+    auto* edge01 = graph.MakeEdge(0, 1, true);
+    auto* edge12 = graph.MakeEdge(1, 2);
+    graph.MakeEdge(2, 2);
+    ASSERT_EQ(graph.FindEdge(0, 1), edge01);
+    ASSERT_FALSE(graph.HasEdge(1, 0));
+    ASSERT_EQ(graph.FindEdge(2, 1), edge12);
+    ASSERT_TRUE(graph.HasEdge(2, 2));
+    ASSERT_FALSE(graph.HasEdge(0, 3));
+    ASSERT_FALSE(graph.HasEdge(0, 42));
+    graph.DelEdgesBetween(2, 2);
+    ASSERT_FALSE(graph.HasEdge(2, 2));
+    ASSERT_EQ(graph.Edges().size(), 2);
+    graph.DelEdgesTo(1, 0);
+    ASSERT_EQ(graph.Edges().size(), 2);
+    graph.DelEdgesTo(2, 1);
+    ASSERT_FALSE(graph.HasEdge(1, 2));
+    ASSERT_EQ(graph.Edges().size(), 1);
+    graph.Del(1);
+    ASSERT_FALSE(graph.HasEdge(0, 1));
+    ASSERT_TRUE(graph.CheckCorrect());
+
+    // simple graph keeps one connection per direction
+    Simple_t simple;
+    for (int i = 0; i < 3; ++i)
+        simple.MakeNode(i);
+    ASSERT_NE(simple.MakeEdge(0, 1, true), nullptr);
+    ASSERT_EQ(simple.MakeEdge(0, 1, true), nullptr);
+    ASSERT_EQ(simple.MakeEdge(0, 1), nullptr);
+    ASSERT_NE(simple.MakeEdge(1, 0, true), nullptr);
+    ASSERT_NE(simple.MakeEdge(1, 2), nullptr);
+    ASSERT_EQ(simple.MakeEdge(2, 1, true), nullptr);
+    simple.LoadEdges(std::vector<GG::EdgeRecord<int>>{{2, 1}, {2, 2}, {2, 2}, {2, 3}});
+    ASSERT_EQ(simple.Edges().size(), 5);
+
+    // indexed and scanned graphs agree
+    Graph_t indexed;
+    Scanned_t scanned;
+    constexpr int Count = 30;
+    for (int i = 0; i < Count; ++i)
+    {
+        indexed.MakeNode(i);
+        scanned.MakeNode(i);
+    }
+    std::mt19937 random(5);
+    for (int step = 0; step < 2000; ++step)
+    {
+        const int node1   = static_cast<int>(random() % Count);
+        const int node2   = static_cast<int>(random() % Count);
+        const auto action = random() % 8;
+        if (action == 0)
+        {
+            indexed.DelEdgesBetween(node1, node2);
+            scanned.DelEdgesBetween(node1, node2);
+        }
+        else if (action == 1)
+        {
+            indexed.DelEdgesTo(node1, node2);
+            scanned.DelEdgesTo(node1, node2);
+        }
+        else
+        {
+            indexed.MakeEdge(node1, node2, action % 2 == 0);
+            scanned.MakeEdge(node1, node2, action % 2 == 0);
+        }
+        ASSERT_EQ(indexed.HasEdge(node1, node2), scanned.HasEdge(node1, node2));
+        ASSERT_EQ(indexed.HasEdge(node2, node1), scanned.HasEdge(node2, node1));
+        ASSERT_EQ(indexed.Edges().size(), scanned.Edges().size());
+    }
+    ASSERT_TRUE(indexed.CheckCorrect());
+    indexed.Clear();
+    ASSERT_FALSE(indexed.HasEdge(0, 1));
+}
+
+TEST(GraphInclusive, Snapshot)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>;
+    Graph_t graph;
+    for (int i = 0; i < 100; ++i)
+        graph.MakeNode(i * 7);
+    for (int i = 1; i < 60; ++i)
+        graph.MakeEdge((i - 1) * 7, i * 7, (i % 3) == 0)->SetWeight(i);
+    graph.MakeEdge(0, 0);
+    graph.MakeEdge(0, 0);
+    graph.MakeEdge(70, 70, true);
+    graph.MakeEdge(630, 637);
+
+    const std::string path = testing::TempDir() + "graph_snapshot.bin";
+    ASSERT_TRUE(GG::WriteSnapshot(graph, path).ok);
+
+    // mapped graph is the same as the frozen one
+    using Csr_t = GG::CsrGraph<int, true>;
+    const Csr_t csr(graph);
+    Csr_t mapped;
+    ASSERT_TRUE(GG::MapSnapshot(path, &mapped).ok);
+    ASSERT_EQ(mapped.NodesCount(), 100);
+    ASSERT_EQ(mapped.AdjacencyCount(), csr.AdjacencyCount());
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto node = mapped.Find(i * 7);
+        ASSERT_EQ(node, csr.Find(i * 7));
+        ASSERT_EQ(mapped.Id(node), i * 7);
+        ASSERT_EQ(mapped.ComponentId(node), graph.ComponentId(graph.Find(i * 7)));
+        ASSERT_TRUE(std::ranges::equal(mapped.Neighbours(node), csr.Neighbours(node)));
+    }
+    ASSERT_EQ(mapped.Find(1), Csr_t::NodeNone);
+    const auto copy = mapped;
+    GG::WaveSearch wave(&copy, copy.Find(0));
+    wave.SpreadWave();
+    ASSERT_EQ(wave.DistanceTo(copy.Find(14)), 3.0);
+
+    Graph_t restored;
+    ASSERT_TRUE(GG::RestoreSnapshot(path, restored).ok);
+    ASSERT_EQ(restored.Nodes().size(), graph.Nodes().size());
+    ASSERT_EQ(restored.Edges().size(), graph.Edges().size());
+    ASSERT_EQ(restored.ConnectedComponentsCount(), graph.ConnectedComponentsCount());
+    ASSERT_EQ(Csr_t(restored).AdjacencyCount(), csr.AdjacencyCount());
+    for (const auto edge : restored.Edges())
+    {
+        const int id1 = edge->Nodes().first->Id();
+        const int id2 = edge->Nodes().second->Id();
+        if ((id1 == id2) or (id1 == 630) or (id2 == 630))
+            continue;
+        const int i = std::max(id1, id2) / 7;
+        ASSERT_EQ(edge->Directed(), (i % 3) == 0);
+        ASSERT_EQ(edge->Weight(), i);
+        if (edge->Directed())
+        {
+            ASSERT_LT(id1, id2);
+        }
+    }
+
+    GG::CsrGraph<int> unweighted;
+    ASSERT_FALSE(GG::MapSnapshot(path, &unweighted).ok);
+    ASSERT_FALSE(GG::MapSnapshot(path + ".none", &mapped).ok);
+    ASSERT_EQ(mapped.NodesCount(), 100);
+
+    // damaged headers are rejected before any section is used
+    auto map_damaged = [&graph, &path](auto damage) {
+        ASSERT_TRUE(GG::WriteSnapshot(graph, path).ok);
+        GG::SnapshotHeader header;
+        FILE* file = fopen(path.c_str(), "r+b");
+        ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1);
+        damage(header);
+        ASSERT_EQ(fseek(file, 0, SEEK_SET), 0);
+        ASSERT_EQ(fwrite(&header, sizeof(header), 1, file), 1);
+        fclose(file);
+        Csr_t damaged;
+        ASSERT_FALSE(GG::MapSnapshot(path, &damaged).ok);
+    };
+    map_damaged([](GG::SnapshotHeader& header) { header.hash_check ^= 1; });
+    map_damaged([](GG::SnapshotHeader& header) { header.nodes_count = uint64_t(1) << 62; });
+    map_damaged([](GG::SnapshotHeader& header) { header.adjacency_count = 0; });
+    map_damaged([](GG::SnapshotHeader& header) { header.section_offsets[GG::SnapshotHeader::SectionIds] = 0; });
+    map_damaged([](GG::SnapshotHeader& header) {
+        header.section_offsets[GG::SnapshotHeader::SectionIndex] =
+            header.section_offsets[GG::SnapshotHeader::SectionOffsets];
+    });
+    map_damaged([](GG::SnapshotHeader& header) {
+        header.section_offsets[GG::SnapshotHeader::SectionComponents] = header.file_size;
+    });
+    std::remove(path.c_str());
+}
+
+TEST(GraphInclusive, Journal)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>,
+                                       std::unordered_map<int, Node_t*>, GG::Journal<Node_t, Edge_t, true>>;
+    auto edges_of = [](const Graph_t& graph) {
+        std::vector<std::tuple<int, int, bool, float>> edges;
+        for (const auto edge : graph.Edges())
+        {
+            int id1 = edge->Nodes().first->Id();
+            int id2 = edge->Nodes().second->Id();
+            if (not edge->Directed() and (id1 > id2))
+                std::swap(id1, id2);
+            edges.emplace_back(id1, id2, edge->Directed(), edge->Weight());
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    };
+    auto same = [&edges_of](const Graph_t& graph1, const Graph_t& graph2) {
+        return (graph1.Nodes().size() == graph2.Nodes().size()) and (edges_of(graph1) == edges_of(graph2)) and
+               (graph1.ConnectedComponentsCount() == graph2.ConnectedComponentsCount());
+    };
+    const std::string snapshot_path = testing::TempDir() + "graph_journal.snapshot";
+    const std::string journal_path  = testing::TempDir() + "graph_journal.journal";
+    std::remove(snapshot_path.c_str());
+    std::remove(journal_path.c_str());
+
+    Graph_t graph;
+    ASSERT_TRUE(GG::Recover(graph, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(graph.JournalOpened());
+    ASSERT_EQ(graph.JournalGeneration(), 0);
+    for (int i = 0; i < 30; ++i)
+        graph.MakeNode(i);
+    for (int i = 1; i < 30; ++i)
+        graph.MakeEdge(i - 1, i, (i % 4) == 0);
+    graph.MakeEdge(3, 5);
+    graph.MakeEdge(3, 5);
+    graph.SetWeight(graph.MakeEdge(5, 3), 2.0);
+    graph.DelEdgesBetween(10, 11);
+    graph.Del(20);
+    graph.LoadEdges(std::vector<GG::EdgeRecord<int>>{{40, 41, 3.0, true}, {41, 42}}, std::vector<int>{50});
+    ASSERT_TRUE(graph.CommitJournal());
+
+    // replay of the whole history
+    Graph_t replayed;
+    ASSERT_TRUE(GG::Recover(replayed, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(same(replayed, graph));
+
+    // compaction folds the journal into a snapshot, recovery replays only the new tail
+    ASSERT_TRUE(GG::Compact(replayed, snapshot_path, journal_path).ok);
+    ASSERT_EQ(replayed.JournalGeneration(), 1);
+    replayed.Del(41);
+    replayed.MakeEdge(0, 29);
+    replayed.CloseJournal();
+    Graph_t recovered;
+    ASSERT_TRUE(GG::Recover(recovered, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(same(recovered, replayed));
+    ASSERT_TRUE(recovered.SurelyConnected(recovered.Find(0), recovered.Find(29)));
+    recovered.CloseJournal();
+
+    // torn record at the end is cut off
+    {
+        FILE* file = fopen(journal_path.c_str(), "ab");
+        const std::array<char, 3> torn = {static_cast<char>(GG::JournalRecord::AddEdge), 1, 2};
+        fwrite(torn.data(), 1, torn.size(), file);
+        fclose(file);
+    }
+    Graph_t cut;
+    ASSERT_TRUE(GG::Recover(cut, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(same(cut, replayed));
+    cut.MakeNode(100);
+    cut.CloseJournal();
+    Graph_t cut_recovered;
+    ASSERT_TRUE(GG::Recover(cut_recovered, snapshot_path, journal_path).ok);
+    ASSERT_NE(cut_recovered.Find(100), nullptr);
+    cut_recovered.CloseJournal();
+
+    // journal of an older generation is already in the snapshot
+    ASSERT_TRUE(GG::CreateJournalFile<int>(journal_path, 0));
+    Graph_t stale;
+    ASSERT_TRUE(GG::Recover(stale, snapshot_path, journal_path).ok);
+    ASSERT_EQ(stale.JournalGeneration(), 1);
+    ASSERT_TRUE(same(stale, graph));
+
+    // clear is journaled as a wipe, clearing a graph with a closed journal only releases its memory
+    stale.CloseJournal();
+    stale.Clear();
+    Graph_t kept;
+    ASSERT_TRUE(GG::Recover(kept, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(same(kept, graph));
+    kept.Clear();
+    kept.CloseJournal();
+    Graph_t wiped;
+    ASSERT_TRUE(GG::Recover(wiped, snapshot_path, journal_path).ok);
+    ASSERT_TRUE(wiped.Nodes().empty());
+
+    // a write failure, here exceeding the file size limit, fails the commit and all later ones
+    struct stat journal_stat {};
+    ASSERT_EQ(::stat(journal_path.c_str(), &journal_stat), 0);
+    rlimit limit{};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &limit), 0);
+    const auto handler   = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit small_limit   = limit;
+    small_limit.rlim_cur = static_cast<rlim_t>(journal_stat.st_size);
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &small_limit), 0);
+    for (int i = 0; i < 10; ++i)
+        wiped.MakeNode(i);
+    const bool committed = wiped.CommitJournal();
+    ::setrlimit(RLIMIT_FSIZE, &limit);
+    std::signal(SIGXFSZ, handler);
+    ASSERT_FALSE(committed);
+    ASSERT_FALSE(wiped.CommitJournal());
+    wiped.CloseJournal();
+    std::remove(snapshot_path.c_str());
+    std::remove(journal_path.c_str());
+}
+
+TEST(GraphInclusive, ConcurrentReaders)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, false>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, false>, GG::Named<false>>;
+    // every published version is a chain 0 - 1 - ... - n-1
+    using Frozen_t = GG::ConcurrentGraph<Graph_t>::Frozen_t;
+    GG::ConcurrentGraph<Graph_t> graph(4);
+    std::atomic<bool> stop   = false;
+    std::atomic<int> queries = 0;
+    std::atomic<int> errors  = 0;
+    auto read = [&]() {
+        auto reader = graph.MakeReader();
+        ASSERT_TRUE(reader.has_value());
+        while (not stop.load())
+        {
+            const auto guard = reader->Read();
+            const auto& csr  = guard.Graph();
+            const int count  = static_cast<int>(csr.NodesCount());
+            if (count == 0)
+                continue;
+            const auto last = csr.Find(count - 1);
+            auto& wave      = reader->Search(guard, csr.Find(0));
+            if ((last == Frozen_t::NodeNone) or (csr.AdjacencyCount() != 2 * static_cast<size_t>(count - 1)) or
+                (wave.FindPathTo(last).size() != static_cast<size_t>(count)))
+                ++errors;
+            ++queries;
+        }
+    };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+        readers.emplace_back(read);
+    for (int i = 0; i < 300; ++i)
+    {
+        graph.Mutate([i](Graph_t& writer) {
+            writer.MakeNode(i);
+            if (i > 0)
+                writer.MakeEdge(i - 1, i);
+        });
+        if ((i % 10) == 9)
+        {
+            graph.Mutate([i](Graph_t& writer) { writer.Del(i); });
+            graph.Mutate([i](Graph_t& writer) {
+                writer.MakeNode(i);
+                writer.MakeEdge(i - 1, i);
+            });
+        }
+    }
+    while (queries.load() < 100)
+        std::this_thread::yield();
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+    ASSERT_EQ(errors.load(), 0);
+    ASSERT_EQ(graph.Reclaim(), 0);
+    auto reader = graph.MakeReader();
+    {
+        const auto guard = reader->Read();
+        ASSERT_EQ(guard.Graph().NodesCount(), 300);
+        ASSERT_EQ(guard.GraphVersion(), graph.Writer().Version());
+    }
+
+    // applied mutations are published together, a publication without mutations is skipped
+    ASSERT_TRUE(graph.Publish());
+    ASSERT_FALSE(graph.Publish());
+    graph.Apply([](Graph_t& writer) { writer.MakeNode(300); });
+    graph.Apply([](Graph_t& writer) { writer.MakeEdge(299, 300); });
+    ASSERT_EQ(reader->Read().Graph().NodesCount(), 300);
+    ASSERT_TRUE(graph.Publish());
+    const auto batched = reader->Read();
+    ASSERT_EQ(batched.Graph().NodesCount(), 301);
+    auto& search = reader->Search(batched, batched.Graph().Find(0));
+    ASSERT_EQ(search.FindPathTo(batched.Graph().Find(300)).size(), 301);
+    ASSERT_EQ(&reader->Search(batched, batched.Graph().Find(300)), &search);
+    ASSERT_EQ(search.FindPathTo(batched.Graph().Find(0)).size(), 301);
+
+    GG::EpochDomain domain(1);
+    auto epoch_reader = domain.MakeReader();
+    ASSERT_FALSE(domain.MakeReader().has_value());
+    int freed = 0;
+    epoch_reader->Enter();
+    domain.Retire([&freed]() { ++freed; });
+    ASSERT_EQ(domain.Reclaim(), 1);
+    epoch_reader->Leave();
+    ASSERT_EQ(domain.Reclaim(), 0);
+    ASSERT_EQ(freed, 1);
+}
+
+TEST(GraphInclusive, ParallelBuilder)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>;
+    // thread t chains nodes t -> t + 4 -> t + 8 ... and links even nodes with the next odd ones, so threads race for
+    // the same nodes and append to the same adjacency lists
+    static constexpr int Count = 4000;
+    auto build = [](GG::ParallelBuilder<Graph_t>& builder) {
+        std::atomic<int> made = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&builder, &made, t]() {
+                auto worker = builder.MakeWorker();
+                for (int i = t; i + 4 < Count; i += 4)
+                {
+                    auto [node, node_made] = worker.FindOrMake(i);
+                    auto [next, next_made] = worker.FindOrMake(i + 4);
+                    made += (node_made ? 1 : 0) + (next_made ? 1 : 0);
+                    worker.MakeEdge(node, next, true);
+                    if (i % 2 == 0)
+                    {
+                        auto [neighbour, neighbour_made] = worker.FindOrMake(i + 1);
+                        made += (neighbour_made ? 1 : 0);
+                        worker.MakeEdge(node, neighbour, false);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        return made.load();
+    };
+
+    GG::ParallelBuilder<Graph_t> builder(8);
+    ASSERT_EQ(build(builder), Count);
+    const auto frozen = builder.Freeze();
+    ASSERT_EQ(frozen.NodesCount(), Count);
+    // directed chain edges are stored once, undirected neighbour edges twice
+    ASSERT_EQ(frozen.AdjacencyCount(), static_cast<size_t>(2 * (Count - 4)));
+
+    Graph_t graph;
+    graph.MakeNode(-1);
+    builder.Finalize(graph);
+    ASSERT_EQ(builder.Nodes().begin(), builder.Nodes().end());
+    ASSERT_EQ(graph.Nodes().size(), Count + 1);
+    ASSERT_EQ(graph.Edges().size(), static_cast<size_t>(3 * (Count - 4) / 2));
+    ASSERT_TRUE(graph.CheckCorrect());
+    // chains 0 and 1 are linked, as well as chains 2 and 3
+    ASSERT_EQ(graph.ConnectedComponentsCount(), 3);
+    for (int i = 0; i < Count; ++i)
+    {
+        const auto node = graph.Find(i);
+        ASSERT_NE(node, nullptr);
+        ASSERT_EQ(node->Edges().size(), (i < 4) ? 2 : ((i < Count - 4) ? 3 : 1));
+        ASSERT_EQ(frozen.Neighbours(frozen.Find(i)).size(), (i < Count - 4) ? 2 : 0);
+    }
+}
+
+TEST(GraphInclusive, BatchPathFinder)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, false>, GG::Weighted<Edge_t, true>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>;
+    // weighted 20x20 grid and a separate pair of nodes
+    static constexpr int Side = 20;
+    Graph_t graph;
+    std::mt19937 rnd(1);
+    for (int i = 0; i < Side * Side + 2; ++i)
+        graph.MakeNode(i);
+    for (int y = 0; y < Side; ++y)
+    {
+        for (int x = 0; x < Side; ++x)
+        {
+            if (x + 1 < Side)
+                graph.MakeEdge(y * Side + x, y * Side + x + 1)->SetWeight(1 + rnd() % 5);
+            if (y + 1 < Side)
+                graph.MakeEdge(y * Side + x, (y + 1) * Side + x)->SetWeight(1 + rnd() % 5);
+        }
+    }
+    graph.MakeEdge(Side * Side, Side * Side + 1);
+
+    GG::WorkStealingPool pool(3);
+    std::vector<int> starts;
+    std::vector<int> targets;
+    for (int i = 0; i < 300; ++i)
+    {
+        starts.push_back(static_cast<int>(rnd() % 10) * 37);
+        targets.push_back(static_cast<int>(rnd() % (Side * Side + 2)));
+    }
+
+    using Adjacency_t = GG::GraphInclusiveAdjacency<Graph_t>;
+    Adjacency_t adjacency(&graph);
+    GG::BatchPathFinder finder(&adjacency, &pool);
+    std::vector<GG::BatchPathFinder<Adjacency_t>::Query> queries;
+    for (size_t i = 0; i < starts.size(); ++i)
+        queries.push_back({graph.Find(starts[i]), graph.Find(targets[i])});
+    std::shared_mutex mutex;
+    const auto answers = finder.Run(queries, mutex);
+    ASSERT_EQ(answers.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        GG::WaveSearch wave(&adjacency, queries[i].start);
+        const auto path = wave.FindPathTo(queries[i].target);
+        ASSERT_EQ(answers[i].reached, not path.empty());
+        ASSERT_EQ(answers[i].distance, wave.DistanceTo(queries[i].target));
+        ASSERT_EQ(answers[i].path, path);
+        ASSERT_EQ(answers[i].reached, targets[i] < Side * Side);
+    }
+
+    GG::CsrGraph<int, true> csr(graph);
+    GG::BatchPathFinder csr_finder(&csr, &pool);
+    std::vector<GG::BatchPathFinder<GG::CsrGraph<int, true>>::Query> csr_queries;
+    for (size_t i = 0; i < starts.size(); ++i)
+        csr_queries.push_back({csr.Find(starts[i]), csr.Find(targets[i])});
+    // the second batch reuses waves of the first one
+    for (int batch = 0; batch < 2; ++batch)
+    {
+        const auto csr_answers = csr_finder.Run(csr_queries, false);
+        for (size_t i = 0; i < csr_queries.size(); ++i)
+        {
+            ASSERT_EQ(csr_answers[i].reached, answers[i].reached);
+            ASSERT_EQ(csr_answers[i].distance, answers[i].distance);
+            ASSERT_TRUE(csr_answers[i].path.empty());
+        }
+    }
+}
+
+TEST(GraphInclusive, BatchPathFinderStrongComponents)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                       GG::StronglyConnectedComponentWatch<Node_t, Edge_t>, GG::Named<false>>;
+    // a chain of directed cycles, every cycle leads to the next one
+    static constexpr int Cycles = 30;
+    static constexpr int Length = 10;
+    Graph_t graph;
+    for (int i = 0; i < Cycles * Length; ++i)
+        graph.MakeNode(i);
+    for (int c = 0; c < Cycles; ++c)
+    {
+        for (int i = 0; i < Length; ++i)
+            graph.MakeEdge(c * Length + i, c * Length + (i + 1) % Length, true);
+        if (c + 1 < Cycles)
+            graph.MakeEdge(c * Length, (c + 1) * Length, true);
+    }
+    ASSERT_EQ(graph.ConnectedComponentsCount(), Cycles);
+    // edits inside strong components leave the watch to be recomputed on the next query
+    graph.DelEdgesBetween(graph.Find(5 * Length + 3), graph.Find(5 * Length + 4));
+    graph.DelEdgesBetween(graph.Find(17 * Length + 8), graph.Find(17 * Length + 9));
+
+    GG::WorkStealingPool pool(3);
+    std::mt19937 rnd(1);
+    using Adjacency_t = GG::GraphInclusiveAdjacency<Graph_t>;
+    Adjacency_t adjacency(&graph);
+    GG::BatchPathFinder finder(&adjacency, &pool);
+    std::vector<GG::BatchPathFinder<Adjacency_t>::Query> queries;
+    for (int i = 0; i < 400; ++i)
+    {
+        queries.push_back({graph.Find(static_cast<int>(rnd() % 20) * 13 % (Cycles * Length)),
+                           graph.Find(static_cast<int>(rnd() % (Cycles * Length)))});
+    }
+    std::shared_mutex mutex;
+    const auto answers = finder.Run(queries, mutex);
+    ASSERT_EQ(answers.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        GG::WaveSearch wave(&adjacency, queries[i].start);
+        const auto path = wave.FindPathTo(queries[i].target);
+        ASSERT_EQ(answers[i].reached, not path.empty());
+        ASSERT_EQ(answers[i].path, path);
+    }
+    ASSERT_EQ(graph.ConnectedComponentsCount(), Cycles + 2 * (Length - 1));
+}
+
+TEST(GraphInclusive, ParallelComponents)
+{
+    using Node_t  = GG::Node<int>;
+    using Edge_t  = GG::Edge<Node_t>;
+    using Graph_t = GG::GraphInclusive<Node_t, Edge_t, GG::Directed<Edge_t, true>, GG::Weighted<Edge_t, false>,
+                                       GG::ConnectedComponentWatch<Node_t, Edge_t, true>, GG::Named<false>>;
+    // sparse random graph with many components of different sizes
+    static constexpr int Count = 20000;
+    std::mt19937 rnd(1);
+    std::vector<GG::EdgeRecord<int>> edges;
+    for (int i = 0; i < Count * 9 / 10; ++i)
+        edges.push_back({static_cast<int>(rnd() % Count), static_cast<int>(rnd() % Count), 1.0, (rnd() % 2) == 0});
+    std::vector<int> nodes(Count);
+    std::iota(nodes.begin(), nodes.end(), 0);
+    Graph_t graph;
+    graph.LoadEdges(edges, nodes);
+    const int expected = graph.ConnectedComponentsCount();
+    ASSERT_GT(expected, 100);
+
+    GG::WorkStealingPool pool(3);
+    GG::CsrGraph<int> csr(graph);
+    std::vector<int32_t> components;
+    ASSERT_EQ(GG::ParallelConnectedComponents(csr, pool, &components), expected);
+    for (const auto edge : graph.Edges())
+    {
+        ASSERT_EQ(components[csr.Find(edge->Nodes().first->Id())], components[csr.Find(edge->Nodes().second->Id())]);
+    }
+    auto same_components = [&]() {
+        for (int i = 0; i < Count; ++i)
+        {
+            if (components[csr.Find(i)] != components[csr.Find(nodes[i])])
+                return false;
+        }
+        return true;
+    };
+    ASSERT_TRUE(same_components());
+
+    // large deletion without rebuilding, then bootstrap the watch
+    graph.BeginBulkUpdate();
+    for (int i = 0; i < Count; i += 3)
+        graph.Del(i);
+    graph.LoadEdges(std::vector<GG::EdgeRecord<int>>{{1, 2, 1.0, false}});
+    graph.EndBulkUpdate(false);
+    const int count = GG::BootstrapComponents(graph, pool);
+    ASSERT_EQ(count, graph.ConnectedComponentsCount());
+    Graph_t rebuilt;
+    GG::CsrGraph<int> csr_bootstrapped(graph);
+    std::vector<GG::EdgeRecord<int>> left_edges;
+    for (const auto edge : graph.Edges())
+        left_edges.push_back({edge->Nodes().first->Id(), edge->Nodes().second->Id(), 1.0, edge->Directed()});
+    std::vector<int> left_nodes;
+    for (const auto& node_el : graph.Nodes())
+        left_nodes.push_back(node_el.first);
+    rebuilt.LoadEdges(left_edges, left_nodes);
+    ASSERT_EQ(count, rebuilt.ConnectedComponentsCount());
+    ASSERT_TRUE(graph.SurelyConnected(graph.Find(1), graph.Find(2)));
+    for (const auto& node_el : graph.Nodes())
+    {
+        for (const auto edge : node_el.second->Edges())
+        {
+            ASSERT_TRUE(graph.SurelyConnected(edge->Nodes().first, edge->Nodes().second));
+        }
+    }
+    // the watch keeps working after the bootstrap
+    graph.MakeEdge(1, 5);
+    ASSERT_EQ(graph.ComponentId(graph.Find(1)), graph.ComponentId(graph.Find(5)));
+}
+
 TEST(Area2D, BaseMoore)
 {
     using Node_t = GG::Node<GG::Coord2D>;
@@ -294,6 +1799,48 @@ TEST(Area2D, BaseMoore)
     ASSERT_EQ(path.Length(), 5.0);
 }
 
+TEST(Area2D, InlineEdges)
+{
+    using Node_t        = GG::AreaNode2D<GG::NeighborhoodMoore>;
+    using HeapNode_t    = GG::Node<GG::Coord2D>;
+    using Area_t        = GG::Area2D<Node_t, GG::NeighborhoodMoore>;
+    using HeapArea_t    = GG::Area2D<HeapNode_t, GG::NeighborhoodMoore>;
+    using SmallVector_t = GG::SmallVector<int, 4>;
+    static_assert(sizeof(Node_t) <= 2 * 64);
+
+    SmallVector_t values;
+    for (int i = 0; i < 10; ++i)
+        values.insert(values.begin() + (i / 2), i);
+    ASSERT_EQ(std::vector<int>(values.begin(), values.end()), (std::vector<int>{1, 3, 5, 7, 9, 8, 6, 4, 2, 0}));
+    ASSERT_GE(values.capacity(), 10);
+    const SmallVector_t copy = values;
+    SmallVector_t moved      = std::move(values);
+    ASSERT_TRUE(std::ranges::equal(copy, moved));
+    moved.resize(3);
+    SmallVector_t small;
+    small.push_back(7);
+    moved = std::move(small);
+    ASSERT_EQ(moved.size(), 1);
+    ASSERT_EQ(moved[0], 7);
+
+    const GG::Range2D range(GG::Coord2D(15, 11));
+    Area_t area(range);
+    HeapArea_t heap_area(range);
+    area.SetPassableAll(true);
+    heap_area.SetPassableAll(true);
+    for (int y = 0; y < 10; ++y)
+    {
+        area.SetPassable({7, y}, false);
+        heap_area.SetPassable({7, y}, false);
+    }
+    ASSERT_EQ(area.Graph().Edges().size(), heap_area.Graph().Edges().size());
+    ASSERT_EQ(area.Graph().Find(GG::Coord2D(3, 3))->Edges().size(), 8);
+    GG::PathFindContext path_find_context{&(area.Graph()), area.Graph().Find(GG::Coord2D(0, 0))};
+    GG::PathFindContext heap_path_find_context{&(heap_area.Graph()), heap_area.Graph().Find(GG::Coord2D(0, 0))};
+    ASSERT_EQ(path_find_context.FindPathTo(area.Graph().Find(GG::Coord2D(15, 0))).Length(),
+              heap_path_find_context.FindPathTo(heap_area.Graph().Find(GG::Coord2D(15, 0))).Length());
+}
+
 TEST(Area2D, BaseVonNeumann)
 {
     using Node_t = GG::Node<GG::Coord2D>;
@@ -330,6 +1877,343 @@ TEST(Area2D, BaseHex)
     ASSERT_EQ(path.Length(), 7.0);
 }
 
+template <typename TNeighborhood, typename TIsNeighbour>
+void CheckNeighborhood(TIsNeighbour is_neighbour)
+{
+    const GG::Range2D range(GG::Coord2D(4, 3), GG::Coord2D(-2, -3));
+    for (int y = range.MinY(); y <= range.MaxY(); ++y)
+    {
+        for (int x = range.MinX(); x <= range.MaxX(); ++x)
+        {
+            std::vector<GG::Coord2D> expected;
+            for (int dx = -1; dx <= 1; ++dx)
+                for (int dy = -1; dy <= 1; ++dy)
+                    if (((dx != 0) or (dy != 0)) and range.Contains({x + dx, y + dy}) and is_neighbour(y, dx, dy))
+                        expected.emplace_back(x + dx, y + dy);
+            std::vector<GG::Coord2D> neighbours;
+            TNeighborhood::ForEachNeighbour({x, y}, range,
+                                            [&](const GG::Coord2D& neighbour) { neighbours.push_back(neighbour); });
+            ASSERT_EQ(neighbours, TNeighborhood::NeighbourCoordinates({x, y}, range));
+            ASSERT_EQ(neighbours.size(), expected.size());
+            for (const auto& neighbour : expected)
+                ASSERT_NE(std::find(neighbours.begin(), neighbours.end(), neighbour), neighbours.end());
+        }
+    }
+}
+
+TEST(Area2D, Neighborhood)
+{
+    CheckNeighborhood<GG::NeighborhoodMoore>([](int, int, int) { return true; });
+    CheckNeighborhood<GG::NeighborhoodVonNeumann>([](int, int dx, int dy) { return (dx == 0) or (dy == 0); });
+    CheckNeighborhood<GG::NeighborhoodHex>([](int y, int dx, int dy) {
+        return (dx == 0) or (dy == 0) or ((y % 2 == 0) and (dx == -1)) or ((y % 2 == 1) and (dx == 1));
+    });
+}
+
+template <typename TNeighborhood, template <typename, typename> typename TWatch>
+void CheckArea2DRegion()
+{
+    using Node_t  = GG::Node<GG::Coord2D>;
+    using Watch_t = TWatch<Node_t, GG::Edge<Node_t>>;
+    const GG::Range2D range(GG::Coord2D(9, 7));
+    GG::Area2D<Node_t, TNeighborhood, Watch_t> area_bulk(range);
+    GG::Area2D<Node_t, TNeighborhood, Watch_t> area_single(range);
+
+    auto check = [&](int components_count) {
+        ASSERT_EQ(area_bulk.Map(), area_single.Map());
+        ASSERT_EQ(area_bulk.Graph().Nodes().size(), area_single.Graph().Nodes().size());
+        ASSERT_EQ(area_bulk.Graph().Edges().size(), area_single.Graph().Edges().size());
+        ASSERT_EQ(area_bulk.Graph().ConnectedComponentsCount(), components_count);
+        ASSERT_EQ(area_single.Graph().ConnectedComponentsCount(), components_count);
+    };
+
+    area_bulk.SetPassableAll(true);
+    for (int y = range.MinY(); y <= range.MaxY(); ++y)
+        for (int x = range.MinX(); x <= range.MaxX(); ++x)
+            area_single.SetPassable({x, y}, true);
+    check(1);
+
+    area_bulk.SetPassableRegion(GG::Range2D(GG::Coord2D(4, 7), GG::Coord2D(3, 0)), false);
+    for (int y = 0; y <= 7; ++y)
+        for (int x = 3; x <= 4; ++x)
+            area_single.SetPassable({x, y}, false);
+    check(2);
+    ASSERT_NE(area_bulk.Graph().ComponentId(area_bulk.Graph().Find(GG::Coord2D(0, 0))),
+              area_bulk.Graph().ComponentId(area_bulk.Graph().Find(GG::Coord2D(9, 7))));
+
+    GG::BitMap2D mask(range);
+    mask.Set({3, 4}, true);
+    mask.Set({4, 4}, true);
+    mask.Set({0, 0}, true);
+    area_bulk.ApplyMask(mask, true);
+    area_single.SetPassable({3, 4}, true);
+    area_single.SetPassable({4, 4}, true);
+    check(1);
+    ASSERT_TRUE(area_bulk.Graph().SurelyConnected(area_bulk.Graph().Find(GG::Coord2D(0, 0)),
+                                                  area_bulk.Graph().Find(GG::Coord2D(9, 7))));
+
+    area_bulk.ApplyMask(mask, false);
+    area_single.SetPassable({3, 4}, false);
+    area_single.SetPassable({4, 4}, false);
+    area_single.SetPassable({0, 0}, false);
+    check(2);
+
+    // the graph is still tracked incrementally after a bulk update
+    area_bulk.SetPassable({3, 4}, true);
+    area_bulk.SetPassable({4, 4}, true);
+    ASSERT_EQ(area_bulk.Graph().ConnectedComponentsCount(), 1);
+
+    area_bulk.SetPassableAll(false);
+    ASSERT_TRUE(area_bulk.Graph().Nodes().empty());
+    ASSERT_TRUE(area_bulk.Graph().Edges().empty());
+    ASSERT_EQ(area_bulk.Graph().ConnectedComponentsCount(), 0);
+}
+
+template <typename TNode, typename TEdge>
+using ConnectedComponentWatchTrue = GG::ConnectedComponentWatch<TNode, TEdge, true>;
+
+TEST(Area2D, Region)
+{
+    CheckArea2DRegion<GG::NeighborhoodMoore, ConnectedComponentWatchTrue>();
+    CheckArea2DRegion<GG::NeighborhoodVonNeumann, ConnectedComponentWatchTrue>();
+    CheckArea2DRegion<GG::NeighborhoodHex, ConnectedComponentWatchTrue>();
+    CheckArea2DRegion<GG::NeighborhoodVonNeumann, GG::ConnectedComponentWatchDynamic>();
+    CheckArea2DRegion<GG::NeighborhoodHex, GG::StronglyConnectedComponentWatch>();
+}
+
+template <typename TNeighborhood, typename TLinearization = GG::LinearizationByY>
+void CheckAreaImplicit2D(float path_length)
+{
+    GG::AreaImplicit2D<TNeighborhood, TLinearization> area(GG::Range2D(GG::Coord2D(4, 3)));
+    area.SetPassableAll(true);
+    area.SetPassable({0, 2}, false);
+    area.SetPassable({1, 2}, false);
+    area.SetPassable({3, 2}, false);
+    ASSERT_EQ(area.ConnectedComponentsCount(), 1);
+    GG::AreaImplicitPathFindContext path_find_context{&area, GG::Coord2D(0, 0)};
+    auto path = path_find_context.FindPathTo(GG::Coord2D(4, 3));
+    ASSERT_EQ(path.size(), path_length);
+    ASSERT_EQ(path.front(), GG::Coord2D(0, 0));
+    ASSERT_EQ(path.back(), GG::Coord2D(4, 3));
+    ASSERT_EQ(path_find_context.DistanceTo(GG::Coord2D(4, 3)), path_length - 1);
+
+    /*
+     *  ..#..
+     *  ..#..
+     *  ..#..
+     *  ..#..
+     */
+    for (int y = 0; y <= 3; ++y)
+        area.SetPassable({2, y}, false);
+    area.SetPassable({0, 2}, true);
+    area.SetPassable({1, 2}, true);
+    area.SetPassable({3, 2}, true);
+    ASSERT_EQ(area.ConnectedComponentsCount(), 2);
+    ASSERT_TRUE(area.SurelyConnected({0, 0}, {1, 3}));
+    ASSERT_TRUE(area.SurelyNotConnected({0, 0}, {4, 3}));
+    ASSERT_TRUE(area.SurelyNotConnected({0, 0}, {2, 0}));
+    GG::AreaImplicitPathFindContext path_find_context2{&area, GG::Coord2D(0, 0)};
+    ASSERT_TRUE(path_find_context2.FindPathTo(GG::Coord2D(4, 3)).empty());
+    path_find_context2.SpreadWave();
+    ASSERT_TRUE(path_find_context2.Reached(GG::Coord2D(1, 3)));
+    ASSERT_FALSE(path_find_context2.Reached(GG::Coord2D(3, 3)));
+}
+
+TEST(AreaImplicit2D, Base)
+{
+    CheckAreaImplicit2D<GG::NeighborhoodMoore>(5.0);
+    CheckAreaImplicit2D<GG::NeighborhoodVonNeumann>(8.0);
+    CheckAreaImplicit2D<GG::NeighborhoodHex>(7.0);
+    CheckAreaImplicit2D<GG::NeighborhoodMoore, GG::LinearizationMorton>(5.0);
+    CheckAreaImplicit2D<GG::NeighborhoodVonNeumann, GG::LinearizationByX>(8.0);
+}
+
+template <typename TNeighborhood>
+void CheckAreaImplicit2DEdits()
+{
+    using Area_t = GG::AreaImplicit2D<TNeighborhood>;
+    const GG::Range2D range(GG::Coord2D(39, 39));
+    Area_t area(range);
+    // isolated cells overflow one byte labels
+    for (int y = 0; y < 40; y += 2)
+    {
+        for (int x = 0; x < 40; x += 2)
+            area.SetPassable({x, y}, true);
+    }
+    ASSERT_EQ(area.ConnectedComponentsCount(), 400);
+    std::mt19937 rnd(1);
+    for (int step = 0; step < 3000; ++step)
+    {
+        // single cell edits update labels in place between queries
+        const GG::Coord2D coord(static_cast<int>(rnd() % 40), static_cast<int>(rnd() % 40));
+        area.SetPassable(coord, (rnd() % 3) != 0);
+        if (step % 10 != 0)
+        {
+            area.ComponentId(coord);
+            continue;
+        }
+        Area_t fresh(range);
+        fresh.ApplyMask(area.Map(), true);
+        ASSERT_EQ(area.ConnectedComponentsCount(), fresh.ConnectedComponentsCount());
+        std::unordered_map<int, int> fresh_of;
+        for (int y = 0; y < 40; ++y)
+        {
+            for (int x = 0; x < 40; ++x)
+            {
+                const auto [it, added] = fresh_of.emplace(area.ComponentId({x, y}), fresh.ComponentId({x, y}));
+                ASSERT_EQ(it->second, fresh.ComponentId({x, y}));
+            }
+        }
+        ASSERT_EQ(fresh_of.size(), static_cast<size_t>(area.ConnectedComponentsCount() + 1));
+    }
+}
+
+TEST(AreaImplicit2D, Edits)
+{
+    CheckAreaImplicit2DEdits<GG::NeighborhoodMoore>();
+    CheckAreaImplicit2DEdits<GG::NeighborhoodVonNeumann>();
+    CheckAreaImplicit2DEdits<GG::NeighborhoodHex>();
+}
+
+TEST(Range2D, Linearization)
+{
+    for (const auto& range : {GG::Range2D(GG::Coord2D(7, 7)), GG::Range2D(GG::Coord2D(12, 4), GG::Coord2D(-3, 2)),
+                              GG::Range2D(GG::Coord2D(2, 40), GG::Coord2D(0, 1)), GG::Range2D(GG::Coord2D(9, 0))})
+    {
+        std::vector<bool> used(range.LineMortonCount(), false);
+        ASSERT_LE(range.LineMortonCount(), 4 * range.Count());
+        for (int y = range.MinY(); y <= range.MaxY(); ++y)
+        {
+            for (int x = range.MinX(); x <= range.MaxX(); ++x)
+            {
+                const auto line = range.CoordToLineMorton({x, y});
+                ASSERT_LT(line, used.size());
+                ASSERT_FALSE(used[line]);
+                used[line] = true;
+            }
+        }
+    }
+    const GG::Range2D range(GG::Coord2D(7, 7));
+    ASSERT_EQ(range.LineMortonCount(), range.Count());
+    ASSERT_EQ(range.CoordToLineMorton({1, 0}), 1);
+    ASSERT_EQ(range.CoordToLineMorton({0, 1}), 2);
+    ASSERT_EQ(range.CoordToLineMorton({1, 1}), 3);
+    ASSERT_EQ(range.CoordToLineMorton({2, 0}), 4);
+    ASSERT_EQ(range.CoordToLineMorton({7, 7}), 63);
+}
+
+TEST(AreaChunked2D, Base)
+{
+    using Node_t = GG::Node<GG::Coord2D>;
+    using Area_t = GG::AreaChunked2D<Node_t, GG::NeighborhoodVonNeumann>;
+    const GG::Range2D range(GG::Coord2D(79, 59));
+    Area_t area(range, true, 30, 8);
+    GG::AreaImplicit2D<GG::NeighborhoodVonNeumann> area_implicit(range);
+    area_implicit.SetPassableAll(true);
+    ASSERT_TRUE(area.Passable({70, 50}));
+    ASSERT_EQ(area.StoredChunksCount(), 0);
+
+    // wall with a gap at the far end
+    for (int y = 0; y < 52; ++y)
+    {
+        area.SetPassable({40, y}, false);
+        area_implicit.SetPassable({40, y}, false);
+    }
+    ASSERT_FALSE(area.Passable({40, 30}));
+    ASSERT_EQ(area.StoredChunksCount(), 7);
+    ASSERT_EQ(area.MaterializedChunksCount(), 0);
+
+    GG::AreaChunkedAdjacency<Area_t> adjacency(&area);
+    GG::WaveSearch wave(&adjacency, GG::Coord2D(36, 0));
+    GG::WaveSearch wave_implicit(&area_implicit, GG::Coord2D(36, 0));
+    const auto path = wave.FindPathTo(GG::Coord2D(44, 0));
+    ASSERT_EQ(path.size(), wave_implicit.FindPathTo(GG::Coord2D(44, 0)).size());
+    ASSERT_EQ(path.size(), 113);
+    ASSERT_LE(area.MaterializedChunksCount(), 30);
+    ASSERT_LE(area.Graph().Nodes().size(), 30 * 8 * 8);
+    ASSERT_TRUE(area.Graph().CheckCorrect());
+
+    // changes reach the graph of materialized chunks
+    ASSERT_NE(area.MaterializedNode({40, 55}), nullptr);
+    area.SetPassable({40, 55}, false);
+    ASSERT_EQ(area.Graph().Find(GG::Coord2D(40, 55)), nullptr);
+    area.SetPassable({40, 55}, true);
+    ASSERT_EQ(area.MaterializedNode({40, 55})->Edges().size(), 4);
+
+    Area_t area_closed(range, false, 0, 8);
+    for (int x = 0; x <= 79; ++x)
+        area_closed.SetPassable({x, 30}, true);
+    ASSERT_EQ(area_closed.StoredChunksCount(), 10);
+    GG::AreaChunkedAdjacency<Area_t> adjacency_closed(&area_closed);
+    GG::WaveSearch wave_closed(&adjacency_closed, GG::Coord2D(0, 30));
+    wave_closed.SpreadWave();
+    ASSERT_EQ(wave_closed.ReachedNodes().size(), 80);
+    ASSERT_EQ(wave_closed.DistanceTo(GG::Coord2D(79, 30)), 79.0);
+}
+
+template <typename TNeighborhood>
+void CheckBitMap2DNeighbourhood(const GG::BitMap2D& map)
+{
+    const auto& range   = map.Range();
+    const auto dilated  = map.Dilated<TNeighborhood>();
+    const auto boundary = map.Boundary<TNeighborhood>();
+    for (int y = range.MinY(); y <= range.MaxY(); ++y)
+    {
+        for (int x = range.MinX(); x <= range.MaxX(); ++x)
+        {
+            const GG::Coord2D coord(x, y);
+            bool touch_set   = false;
+            bool touch_unset = false;
+            for (const auto& neighbour : TNeighborhood::NeighbourCoordinates(coord, range))
+            {
+                touch_set   = touch_set or map.Get(neighbour);
+                touch_unset = touch_unset or not map.Get(neighbour);
+            }
+            // neighbourhoods are symmetric, so a cell touches a set cell iff it is a neighbour of a set cell
+            ASSERT_EQ(dilated.Get(coord), map.Get(coord) or touch_set);
+            ASSERT_EQ(boundary.Get(coord), map.Get(coord) and touch_unset);
+        }
+    }
+    ASSERT_EQ(map.Perimeter<TNeighborhood>().Count(), dilated.Count() - map.Count());
+}
+
+TEST(BitMap2D, Base)
+{
+    GG::BitMap2D map(GG::Range2D(GG::Coord2D(130, 5), GG::Coord2D(-3, -2)));
+    ASSERT_EQ(map.Count(), 0);
+    map.SetAll(true);
+    ASSERT_EQ(map.Count(), 134 * 8);
+    map.SetRect(GG::Range2D(GG::Coord2D(70, 3), GG::Coord2D(60, 0)), false);
+    ASSERT_EQ(map.Count(), 134 * 8 - 11 * 4);
+    ASSERT_FALSE(map.Get({60, 0}));
+    ASSERT_FALSE(map.Get({70, 3}));
+    ASSERT_TRUE(map.Get({59, 0}));
+    ASSERT_TRUE(map.Get({71, 3}));
+    ASSERT_TRUE(map.Get({65, 4}));
+    ASSERT_EQ(map.Inverted().Count(), 11 * 4);
+
+    GG::BitMap2D other(map.Range());
+    other.SetAll(true);
+    ASSERT_EQ(map.CountDifferent(other), 11 * 4);
+    other.SetRect(GG::Range2D(GG::Coord2D(70, 3), GG::Coord2D(60, 0)), false);
+    ASSERT_EQ(map, other);
+    other.Set({-3, -2}, false);
+    ASSERT_NE(map, other);
+    ASSERT_EQ(map.CountDifferent(other), 1);
+}
+
+TEST(BitMap2D, Neighbourhood)
+{
+    GG::BitMap2D map(GG::Range2D(GG::Coord2D(70, 9), GG::Coord2D(-2, 0)));
+    srand(1);
+    for (int y = 0; y <= 9; ++y)
+        for (int x = -2; x <= 70; ++x)
+            map.Set({x, y}, rand() % 4 == 0);
+    CheckBitMap2DNeighbourhood<GG::NeighborhoodMoore>(map);
+    CheckBitMap2DNeighbourhood<GG::NeighborhoodVonNeumann>(map);
+    CheckBitMap2DNeighbourhood<GG::NeighborhoodHex>(map);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);